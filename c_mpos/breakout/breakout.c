@@ -1,8 +1,15 @@
 // Breakout native module renderer. Draws into a framebuffer that may be
 // smaller than the full display (partial framebuffer). Rendering is done
-// per-slice using a y-offset/row count so MicroPythonOS can refresh displays
-// larger than 320x230 without allocating a full-size framebuffer. This keeps
-// the simulation state global while allowing sequential chunk flushes.
+// per-window: the scene is drawn clipped to a rectangle and packed into the
+// framebuffer with that rectangle's width as stride, so MicroPythonOS can
+// refresh displays larger than 320x230 without allocating a full-size
+// framebuffer. This keeps the simulation state global while allowing
+// sequential flushes.
+//
+// step() advances the game once per frame and collects the rectangles that
+// changed (ball, paddle, hit bricks; the whole screen after a level change),
+// split so each fits the framebuffer. render_rect(i) then draws rectangle i
+// for the caller to flush, so a frame only sends what moved over SPI.
 
 // Include the header file to get access to the MicroPython API
 #include "py/dynruntime.h"
@@ -23,8 +30,11 @@ size_t g_framebuffer_len;
 size_t g_framebuffer_width;
 size_t g_framebuffer_height;
 size_t g_framebuffer_max_pixels;
-size_t g_render_y_offset;
-size_t g_render_height;
+// Render window: the part of the screen the framebuffer currently holds.
+int g_win_x;
+int g_win_y;
+int g_win_w;
+int g_win_h;
 
 int g_paddle_x;
 int g_paddle_width;
@@ -35,6 +45,7 @@ float g_ball_vx;
 float g_ball_vy;
 float g_ball_speed;
 uint32_t g_last_tick_ms;
+mp_obj_t g_ticks_ms_fun;
 
 uint32_t g_fps_last_ms;
 uint32_t g_fps_frames;
@@ -54,6 +65,31 @@ uint8_t g_brick_max[BRICK_ROWS][BRICK_COLS];
 uint8_t g_brick_hits[BRICK_ROWS][BRICK_COLS];
 int g_bricks_remaining;
 
+// Brick layout, derived from the screen width in compute_layout().
+#define BRICK_GAP 2
+#define BRICK_HEIGHT 6
+#define BRICK_OFFSET_Y 10
+int g_brick_width;
+
+// Dirty rectangles (x, y, w, h) collected by step() for render_rect().
+#define MAX_DIRTY 32
+#define DIRTY_MERGE_SLACK 64
+int g_dirty[MAX_DIRTY][4];
+int g_dirty_count;
+int g_full_redraw;
+// What the last step() reported: the dirty rectangles split into pieces that
+// fit the framebuffer, or, for a full redraw, screen-wide bands of
+// g_band_rows rows (computed on demand, there can be many).
+#define MAX_FLUSH 48
+int g_flush[MAX_FLUSH][4];
+int g_flush_count;
+int g_band_rows;
+// Where the ball and paddle were when last reported dirty.
+int g_drawn_ball_x;
+int g_drawn_ball_y;
+int g_drawn_paddle_x;
+int g_drawn_paddle_w;
+
 // Per-strength base colors (RGB565). Hue encodes the original strength.
 #define COLOR_1 0xF800  // red
 #define COLOR_2 0xFC00  // orange
@@ -68,10 +104,15 @@ int g_bricks_remaining;
 #define MIN_PADDLE_DIV 8
 #define PADDLE_STEP_DIV 40
 
+// Native modules can't reach mp_hal_ticks_ms() directly, so time.ticks_ms is
+// looked up once and called directly afterwards. It is a ROM function object,
+// so holding it in BSS (which the GC doesn't scan) is safe.
 static uint32_t ticks_ms(void) {
-    mp_obj_t time_mod = mp_import_name(MP_QSTR_time, mp_const_none, MP_OBJ_NEW_SMALL_INT(0));
-    mp_obj_t ticks_fun = mp_load_attr(time_mod, MP_QSTR_ticks_ms);
-    mp_obj_t ticks_val = mp_call_function_n_kw(ticks_fun, 0, 0, NULL);
+    if (g_ticks_ms_fun == MP_OBJ_NULL) {
+        mp_obj_t time_mod = mp_import_name(MP_QSTR_time, mp_const_none, MP_OBJ_NEW_SMALL_INT(0));
+        g_ticks_ms_fun = mp_load_attr(time_mod, MP_QSTR_ticks_ms);
+    }
+    mp_obj_t ticks_val = mp_call_function_n_kw(g_ticks_ms_fun, 0, 0, NULL);
     return (uint32_t)mp_obj_get_int(ticks_val);
 }
 
@@ -89,49 +130,82 @@ static inline size_t framebuffer_max_pixels(void) {
     return g_framebuffer_max_pixels;
 }
 
+// Fill a screen rectangle, clipped to the render window.
 static void draw_rect(int x, int y, int w, int h, uint16_t color) {
     if (w <= 0 || h <= 0 || g_framebuffer == NULL) {
         return;
     }
 
-    const int x0 = (x < 0) ? 0 : x;
-    const int y0 = (y < 0) ? 0 : y;
-    const int x1 = x + w;
-    const int y1 = y + h;
-
-    const int max_x = (int)g_framebuffer_width;
-    const int max_y = (int)g_framebuffer_height;
-
-    int clip_x0 = x0;
-    int clip_y0 = y0;
-    int clip_x1 = (x1 > max_x) ? max_x : x1;
-    int clip_y1 = (y1 > max_y) ? max_y : y1;
-
-    const int slice_y0 = (int)g_render_y_offset;
-    const int slice_y1 = (int)(g_render_y_offset + g_render_height);
-    if (clip_y0 < slice_y0) {
-        clip_y0 = slice_y0;
-    }
-    if (clip_y1 > slice_y1) {
-        clip_y1 = slice_y1;
-    }
+    int clip_x0 = (x < g_win_x) ? g_win_x : x;
+    int clip_y0 = (y < g_win_y) ? g_win_y : y;
+    int clip_x1 = (x + w > g_win_x + g_win_w) ? g_win_x + g_win_w : x + w;
+    int clip_y1 = (y + h > g_win_y + g_win_h) ? g_win_y + g_win_h : y + h;
 
     if (clip_x0 >= clip_x1 || clip_y0 >= clip_y1) {
         return;
     }
 
-    const size_t width = g_framebuffer_width;
+    const size_t stride = (size_t)g_win_w;
     const size_t fill_width = (size_t)(clip_x1 - clip_x0);
 
     for (int yy = clip_y0; yy < clip_y1; yy++) {
-        const size_t local_y = (size_t)(yy - (int)g_render_y_offset);
-        uint16_t *row = g_framebuffer + local_y * width + (size_t)clip_x0;
+        uint16_t *row = g_framebuffer + (size_t)(yy - g_win_y) * stride + (size_t)(clip_x0 - g_win_x);
         for (size_t xx = 0; xx < fill_width; xx++) {
             row[xx] = color;
         }
     }
 }
 
+static inline int paddle_y(void) {
+    return (int)g_framebuffer_height - g_paddle_height - 4;
+}
+
+static void compute_layout(void) {
+    const int brick_area_width = (int)g_framebuffer_width - (BRICK_GAP * (BRICK_COLS + 1));
+    g_brick_width = (brick_area_width > 0) ? (brick_area_width / BRICK_COLS) : 0;
+}
+
+static inline int brick_x(int col) {
+    return BRICK_GAP + col * (g_brick_width + BRICK_GAP);
+}
+
+static inline int brick_y(int row) {
+    return BRICK_OFFSET_Y + row * (BRICK_HEIGHT + BRICK_GAP);
+}
+
+// Add a rectangle to the dirty list, merging it into an existing one when
+// that wastes little area. Falls back to a full redraw when the list is full.
+static void mark_dirty(int x, int y, int w, int h) {
+    if (g_full_redraw || w <= 0 || h <= 0) {
+        return;
+    }
+    const int area = w * h;
+    for (int i = 0; i < g_dirty_count; i++) {
+        int *d = g_dirty[i];
+        const int ux0 = (x < d[0]) ? x : d[0];
+        const int uy0 = (y < d[1]) ? y : d[1];
+        const int ux1 = (x + w > d[0] + d[2]) ? x + w : d[0] + d[2];
+        const int uy1 = (y + h > d[1] + d[3]) ? y + h : d[1] + d[3];
+        const int union_area = (ux1 - ux0) * (uy1 - uy0);
+        if (union_area <= area + d[2] * d[3] + DIRTY_MERGE_SLACK) {
+            d[0] = ux0;
+            d[1] = uy0;
+            d[2] = ux1 - ux0;
+            d[3] = uy1 - uy0;
+            return;
+        }
+    }
+    if (g_dirty_count >= MAX_DIRTY) {
+        g_full_redraw = 1;
+        return;
+    }
+    int *d = g_dirty[g_dirty_count++];
+    d[0] = x;
+    d[1] = y;
+    d[2] = w;
+    d[3] = h;
+}
+
 static uint16_t base_color_for_strength(uint8_t strength) {
     switch (strength) {
         case 1:
@@ -241,6 +315,8 @@ static void generate_level(int level) {
     }
     g_paddle_height = 4;
     g_paddle_x = ((int)g_framebuffer_width - g_paddle_width) / 2;
+    compute_layout();
+    g_full_redraw = 1;
 
     // Seed from level and current time for variety.
     uint32_t rng_state = (uint32_t)ticks_ms() ^ ((uint32_t)level * 0x9E3779B9u);
@@ -291,8 +367,12 @@ static mp_obj_t init(mp_obj_t framebuffer_obj, mp_obj_t width_obj, mp_obj_t heig
     const size_t max_pixels = g_framebuffer_len / sizeof(uint16_t);
     const size_t total_pixels = g_framebuffer_width * g_framebuffer_height;
     g_framebuffer_max_pixels = (max_pixels < total_pixels) ? max_pixels : total_pixels;
-    g_render_y_offset = 0;
-    g_render_height = g_framebuffer_height;
+    g_win_x = 0;
+    g_win_y = 0;
+    g_win_w = (int)g_framebuffer_width;
+    g_win_h = (int)g_framebuffer_height;
+    g_dirty_count = 0;
+    g_full_redraw = 1;
 
     g_score = 0;
     g_level = 1;
@@ -310,6 +390,161 @@ static mp_obj_t init(mp_obj_t framebuffer_obj, mp_obj_t width_obj, mp_obj_t heig
 }
 static MP_DEFINE_CONST_FUN_OBJ_3(init_obj, init);
 
+// Advance the simulation by the time since the last call.
+static void advance_game(void) {
+    const int width = (int)g_framebuffer_width;
+    const int height = (int)g_framebuffer_height;
+    const int pad_y = paddle_y();
+
+    g_fps_frames++;
+    const uint32_t now_ms = ticks_ms();
+    const uint32_t elapsed_ms = now_ms - g_fps_last_ms;
+    if (elapsed_ms >= 1000) {
+        g_fps_last_ms = now_ms;
+        g_fps_frames = 0;
+    }
+
+    uint32_t tick_delta_ms = now_ms - g_last_tick_ms;
+    g_last_tick_ms = now_ms;
+    if (tick_delta_ms > 50) {
+        tick_delta_ms = 50;
+    }
+    const float dt = (float)tick_delta_ms / 1000.0f;
+
+    // Update ball position.
+    g_ball_x += g_ball_vx * dt;
+    g_ball_y += g_ball_vy * dt;
+
+    // Wall collisions.
+    if (g_ball_x <= 0.0f) {
+        g_ball_x = 0.0f;
+        g_ball_vx = g_ball_speed;
+    } else if (g_ball_x >= (float)width - 1.0f) {
+        g_ball_x = (float)width - 1.0f;
+        g_ball_vx = -g_ball_speed;
+    }
+
+    if (g_ball_y <= 0.0f) {
+        g_ball_y = 0.0f;
+        g_ball_vy = g_ball_speed;
+    }
+
+    // Brick collision: the ball's cell in the brick grid is the only brick
+    // it can be inside, unless it is in a gap between bricks.
+    if (g_brick_width > 0 && g_ball_y >= (float)BRICK_OFFSET_Y && g_ball_x >= (float)BRICK_GAP) {
+        const int bx = (int)g_ball_x - BRICK_GAP;
+        const int by = (int)g_ball_y - BRICK_OFFSET_Y;
+        const int col = bx / (g_brick_width + BRICK_GAP);
+        const int row = by / (BRICK_HEIGHT + BRICK_GAP);
+        if (row < BRICK_ROWS && col < BRICK_COLS &&
+                bx - col * (g_brick_width + BRICK_GAP) < g_brick_width &&
+                by - row * (BRICK_HEIGHT + BRICK_GAP) < BRICK_HEIGHT &&
+                g_brick_hits[row][col] != 0) {
+            // Weaken the brick.
+            g_brick_hits[row][col]--;
+            g_score += 5;
+            if (g_brick_hits[row][col] == 0) {
+                uint8_t max_hits = g_brick_max[row][col];
+                if (max_hits > MAX_STRENGTH) {
+                    max_hits = MAX_STRENGTH;
+                }
+                g_score += (int)max_hits * 10;
+                g_bricks_remaining--;
+            }
+            g_ball_vy = -g_ball_vy;
+            mark_dirty(brick_x(col), brick_y(row), g_brick_width, BRICK_HEIGHT);
+        }
+    }
+
+    // Paddle collision with angle control based on hit position.
+    if (g_ball_y >= (float)(pad_y - 1) && g_ball_y <= (float)(pad_y + g_paddle_height)) {
+        if (g_ball_x >= (float)g_paddle_x && g_ball_x <= (float)(g_paddle_x + g_paddle_width)) {
+            g_ball_y = (float)(pad_y - 1);
+            g_ball_vy = -g_ball_speed;
+            float hit_offset = (g_ball_x - ((float)g_paddle_x + (float)g_paddle_width / 2.0f)) /
+                              ((float)g_paddle_width / 2.0f);
+            if (hit_offset < -1.0f) {
+                hit_offset = -1.0f;
+            } else if (hit_offset > 1.0f) {
+                hit_offset = 1.0f;
+            }
+            g_ball_vx = hit_offset * g_ball_speed;
+        }
+    }
+
+    // Ball fell below paddle.
+    if (g_ball_y >= (float)(height - 1)) {
+        g_lives--;
+        if (g_lives > 0) {
+            reset_ball();
+        } else {
+            g_game_over = 1;
+            g_game_over_until = ticks_ms() + 5000;
+            g_ball_vx = 0.0f;
+            g_ball_vy = 0.0f;
+        }
+    }
+
+    if (g_bricks_remaining <= 0) {
+        level_up();
+    }
+}
+
+// Auto-restart a few seconds after game over.
+static void check_restart(void) {
+    if (g_game_over) {
+        uint32_t now_ms = ticks_ms();
+        if ((int32_t)(now_ms - g_game_over_until) >= 0) {
+            new_game();
+        }
+    }
+}
+
+// Draw the scene clipped to the render window (x, y, w, h), packed into the
+// framebuffer with stride w. The window must fit in the framebuffer.
+static void draw_window(int x, int y, int w, int h) {
+    g_win_x = x;
+    g_win_y = y;
+    g_win_w = w;
+    g_win_h = h;
+
+    // Clear to black.
+    memset(g_framebuffer, 0, (size_t)w * (size_t)h * sizeof(uint16_t));
+
+    // Draw bricks, only the rows and columns the window overlaps.
+    if (g_brick_width > 0) {
+        int row0 = (y - BRICK_OFFSET_Y) / (BRICK_HEIGHT + BRICK_GAP);
+        int row1 = (y + h - BRICK_OFFSET_Y) / (BRICK_HEIGHT + BRICK_GAP);
+        int col0 = (x - BRICK_GAP) / (g_brick_width + BRICK_GAP);
+        int col1 = (x + w - BRICK_GAP) / (g_brick_width + BRICK_GAP);
+        row0 = clamp_int(row0, 0, BRICK_ROWS - 1);
+        row1 = clamp_int(row1, 0, BRICK_ROWS - 1);
+        col0 = clamp_int(col0, 0, BRICK_COLS - 1);
+        col1 = clamp_int(col1, 0, BRICK_COLS - 1);
+        if (y + h > BRICK_OFFSET_Y && y < brick_y(BRICK_ROWS)) {
+            for (int row = row0; row <= row1; row++) {
+                for (int col = col0; col <= col1; col++) {
+                    uint8_t remaining = g_brick_hits[row][col];
+                    if (remaining == 0) {
+                        continue;
+                    }
+                    uint8_t max_hits = g_brick_max[row][col];
+                    if (max_hits == 0) {
+                        continue;
+                    }
+                    draw_rect(brick_x(col), brick_y(row), g_brick_width, BRICK_HEIGHT, brick_color(max_hits, remaining));
+                }
+            }
+        }
+    }
+
+    // Draw paddle and ball.
+    draw_rect(g_paddle_x, paddle_y(), g_paddle_width, g_paddle_height, 0xFFFF); // RGB565 white
+    const int ball_draw_x = (int)g_ball_x - (BALL_SIZE / 2);
+    const int ball_draw_y = (int)g_ball_y - (BALL_SIZE / 2);
+    draw_rect(ball_draw_x, ball_draw_y, BALL_SIZE, BALL_SIZE, 0xFFFF);
+}
+
 // render([y_offset, rows, advance]): draw a Breakout frame slice and optionally advance simulation.
 static mp_obj_t render(size_t n_args, const mp_obj_t *args) {
     if (g_framebuffer == NULL || g_framebuffer_width == 0 || g_framebuffer_height == 0) {
@@ -356,162 +591,127 @@ static mp_obj_t render(size_t n_args, const mp_obj_t *args) {
         return mp_const_none;
     }
 
-    g_render_y_offset = render_y_offset;
-    g_render_height = render_rows;
-
-    // Clear to black.
-    const size_t fill_pixels = width * render_rows;
-    memset(g_framebuffer, 0, fill_pixels * sizeof(uint16_t));
+    if (advance && !g_game_over && g_lives > 0) {
+        advance_game();
+    }
+    check_restart();
 
-    const int paddle_y = (int)height - g_paddle_height - 4;
+    draw_window(0, (int)render_y_offset, (int)width, (int)render_rows);
 
-    if (advance && !g_game_over && g_lives > 0) {
-        g_fps_frames++;
-        const uint32_t now_ms = ticks_ms();
-        const uint32_t elapsed_ms = now_ms - g_fps_last_ms;
-        if (elapsed_ms >= 1000) {
-            g_fps_last_ms = now_ms;
-            g_fps_frames = 0;
-        }
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(render_obj, 0, 3, render);
 
-        uint32_t tick_delta_ms = now_ms - g_last_tick_ms;
-        g_last_tick_ms = now_ms;
-        if (tick_delta_ms > 50) {
-            tick_delta_ms = 50;
-        }
-        const float dt = (float)tick_delta_ms / 1000.0f;
-
-        // Update ball position.
-        g_ball_x += g_ball_vx * dt;
-        g_ball_y += g_ball_vy * dt;
-
-        // Wall collisions.
-        if (g_ball_x <= 0.0f) {
-            g_ball_x = 0.0f;
-            g_ball_vx = g_ball_speed;
-        } else if (g_ball_x >= (float)width - 1.0f) {
-            g_ball_x = (float)width - 1.0f;
-            g_ball_vx = -g_ball_speed;
-        }
+// step(): advance the game one frame and collect the changed rectangles.
+// Returns how many there are; draw and flush each with render_rect(i).
+static mp_obj_t step(void) {
+    if (g_framebuffer == NULL || g_framebuffer_width == 0 || g_framebuffer_height == 0) {
+        return MP_OBJ_NEW_SMALL_INT(0);
+    }
+    const int width = (int)g_framebuffer_width;
+    const int height = (int)g_framebuffer_height;
 
-        if (g_ball_y <= 0.0f) {
-            g_ball_y = 0.0f;
-            g_ball_vy = g_ball_speed;
-        }
+    if (!g_game_over && g_lives > 0) {
+        advance_game();
+    }
+    check_restart();
+
+    // Ball and paddle: old and new position, when they moved.
+    const int ball_x = (int)g_ball_x - (BALL_SIZE / 2);
+    const int ball_y = (int)g_ball_y - (BALL_SIZE / 2);
+    if (ball_x != g_drawn_ball_x || ball_y != g_drawn_ball_y) {
+        mark_dirty(g_drawn_ball_x, g_drawn_ball_y, BALL_SIZE, BALL_SIZE);
+        mark_dirty(ball_x, ball_y, BALL_SIZE, BALL_SIZE);
+        g_drawn_ball_x = ball_x;
+        g_drawn_ball_y = ball_y;
+    }
+    if (g_paddle_x != g_drawn_paddle_x || g_paddle_width != g_drawn_paddle_w) {
+        mark_dirty(g_drawn_paddle_x, paddle_y(), g_drawn_paddle_w, g_paddle_height);
+        mark_dirty(g_paddle_x, paddle_y(), g_paddle_width, g_paddle_height);
+        g_drawn_paddle_x = g_paddle_x;
+        g_drawn_paddle_w = g_paddle_width;
+    }
 
-        // Brick collision.
-        const int brick_gap = 2;
-        const int brick_height = 6;
-        const int brick_area_width = (int)width - (brick_gap * (BRICK_COLS + 1));
-        const int brick_width = (brick_area_width > 0) ? (brick_area_width / BRICK_COLS) : 0;
-        const int brick_offset_y = 10;
-
-        if (brick_width > 0 && g_ball_y <= (float)(brick_offset_y + BRICK_ROWS * (brick_height + brick_gap))) {
-            for (int row = 0; row < BRICK_ROWS; row++) {
-                for (int col = 0; col < BRICK_COLS; col++) {
-                    if (g_brick_hits[row][col] == 0) {
-                        continue;
-                    }
-                    const int bx = brick_gap + col * (brick_width + brick_gap);
-                    const int by = brick_offset_y + row * (brick_height + brick_gap);
-                    if (g_ball_x >= (float)bx && g_ball_x < (float)(bx + brick_width) &&
-                            g_ball_y >= (float)by && g_ball_y < (float)(by + brick_height)) {
-                        // Weaken the brick.
-                        g_brick_hits[row][col]--;
-                        g_score += 5;
-                        if (g_brick_hits[row][col] == 0) {
-                            uint8_t max_hits = g_brick_max[row][col];
-                            if (max_hits > MAX_STRENGTH) {
-                                max_hits = MAX_STRENGTH;
-                            }
-                            g_score += (int)max_hits * 10;
-                            g_bricks_remaining--;
-                        }
-                        g_ball_vy = -g_ball_vy;
-                        row = BRICK_ROWS;
-                        break;
-                    }
-                }
-            }
+    if (g_full_redraw) {
+        g_full_redraw = 0;
+        g_dirty_count = 0;
+        g_band_rows = (int)(framebuffer_max_pixels() / (size_t)width);
+        if (g_band_rows <= 0) {
+            return MP_OBJ_NEW_SMALL_INT(0);
         }
+        g_flush_count = 0;
+        return MP_OBJ_NEW_SMALL_INT((height + g_band_rows - 1) / g_band_rows);
+    }
 
-        // Paddle collision with angle control based on hit position.
-        if (g_ball_y >= (float)(paddle_y - 1) && g_ball_y <= (float)(paddle_y + g_paddle_height)) {
-            if (g_ball_x >= (float)g_paddle_x && g_ball_x <= (float)(g_paddle_x + g_paddle_width)) {
-                g_ball_y = (float)(paddle_y - 1);
-                g_ball_vy = -g_ball_speed;
-                float hit_offset = (g_ball_x - ((float)g_paddle_x + (float)g_paddle_width / 2.0f)) /
-                                  ((float)g_paddle_width / 2.0f);
-                if (hit_offset < -1.0f) {
-                    hit_offset = -1.0f;
-                } else if (hit_offset > 1.0f) {
-                    hit_offset = 1.0f;
-                }
-                g_ball_vx = hit_offset * g_ball_speed;
-            }
+    // Clip to the screen and split rectangles the framebuffer can't hold in
+    // one go into bands.
+    g_band_rows = 0;
+    g_flush_count = 0;
+    for (int i = 0; i < g_dirty_count; i++) {
+        const int x0 = clamp_int(g_dirty[i][0], 0, width);
+        const int y0 = clamp_int(g_dirty[i][1], 0, height);
+        const int x1 = clamp_int(g_dirty[i][0] + g_dirty[i][2], 0, width);
+        const int y1 = clamp_int(g_dirty[i][1] + g_dirty[i][3], 0, height);
+        if (x0 >= x1 || y0 >= y1) {
+            continue;
         }
-
-        // Ball fell below paddle.
-        if (g_ball_y >= (float)((int)height - 1)) {
-            g_lives--;
-            if (g_lives > 0) {
-                reset_ball();
-            } else {
-                g_game_over = 1;
-                g_game_over_until = ticks_ms() + 5000;
-                g_ball_vx = 0.0f;
-                g_ball_vy = 0.0f;
+        const int band = (int)(framebuffer_max_pixels() / (size_t)(x1 - x0));
+        for (int y = y0; y < y1 && band > 0; y += band) {
+            if (g_flush_count >= MAX_FLUSH) {
+                // Out of room: redraw everything next frame instead.
+                g_full_redraw = 1;
+                break;
             }
-        }
-
-        if (g_bricks_remaining <= 0) {
-            level_up();
+            int *d = g_flush[g_flush_count++];
+            d[0] = x0;
+            d[1] = y;
+            d[2] = x1 - x0;
+            d[3] = (y + band < y1) ? band : y1 - y;
         }
     }
-
-    // Auto-restart a few seconds after game over.
-    if (g_game_over) {
-        uint32_t now_ms = ticks_ms();
-        if ((int32_t)(now_ms - g_game_over_until) >= 0) {
-            new_game();
-        }
+    g_dirty_count = 0;
+    return MP_OBJ_NEW_SMALL_INT(g_flush_count);
+}
+static MP_DEFINE_CONST_FUN_OBJ_0(step_obj, step);
+
+// render_rect(i): draw dirty rectangle i from the last step() into the
+// framebuffer, packed with its own width as stride.
+// Returns (x1, y1, x2, y2), inclusive screen coordinates to flush.
+static mp_obj_t render_rect(mp_obj_t index_obj) {
+    const int i = mp_obj_get_int(index_obj);
+    if (g_framebuffer == NULL || i < 0) {
+        return mp_const_none;
     }
-
-    // Brick layout.
-    const int brick_gap = 2;
-    const int brick_height = 6;
-    const int brick_area_width = (int)width - (brick_gap * (BRICK_COLS + 1));
-    const int brick_width = (brick_area_width > 0) ? (brick_area_width / BRICK_COLS) : 0;
-    const int brick_offset_y = 10;
-
-    // Draw bricks.
-    if (brick_width > 0) {
-        for (int row = 0; row < BRICK_ROWS; row++) {
-            for (int col = 0; col < BRICK_COLS; col++) {
-                uint8_t remaining = g_brick_hits[row][col];
-                if (remaining == 0) {
-                    continue;
-                }
-                uint8_t max_hits = g_brick_max[row][col];
-                if (max_hits == 0) {
-                    continue;
-                }
-                const int bx = brick_gap + col * (brick_width + brick_gap);
-                const int by = brick_offset_y + row * (brick_height + brick_gap);
-                draw_rect(bx, by, brick_width, brick_height, brick_color(max_hits, remaining));
-            }
+    int x, y, w, h;
+    if (g_band_rows > 0) {
+        x = 0;
+        y = i * g_band_rows;
+        w = (int)g_framebuffer_width;
+        h = (int)g_framebuffer_height - y;
+        if (h <= 0) {
+            return mp_const_none;
         }
+        if (h > g_band_rows) {
+            h = g_band_rows;
+        }
+    } else if (i < g_flush_count) {
+        x = g_flush[i][0];
+        y = g_flush[i][1];
+        w = g_flush[i][2];
+        h = g_flush[i][3];
+    } else {
+        return mp_const_none;
     }
-
-    // Draw paddle and ball.
-    draw_rect(g_paddle_x, paddle_y, g_paddle_width, g_paddle_height, 0xFFFF); // RGB565 white
-    const int ball_draw_x = (int)g_ball_x - (BALL_SIZE / 2);
-    const int ball_draw_y = (int)g_ball_y - (BALL_SIZE / 2);
-    draw_rect(ball_draw_x, ball_draw_y, BALL_SIZE, BALL_SIZE, 0xFFFF);
-
-    return mp_const_none;
+    draw_window(x, y, w, h);
+    mp_obj_t bounds[4] = {
+        MP_OBJ_NEW_SMALL_INT(x),
+        MP_OBJ_NEW_SMALL_INT(y),
+        MP_OBJ_NEW_SMALL_INT(x + w - 1),
+        MP_OBJ_NEW_SMALL_INT(y + h - 1),
+    };
+    return mp_obj_new_tuple(4, bounds);
 }
-static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(render_obj, 0, 3, render);
+static MP_DEFINE_CONST_FUN_OBJ_1(render_rect_obj, render_rect);
 
 // move_paddle(delta): move the paddle horizontally by delta.
 static mp_obj_t move_paddle(mp_obj_t delta_obj) {
@@ -589,6 +789,8 @@ mp_obj_t mpy_init(mp_obj_fun_bc_t *self, size_t n_args, size_t n_kw, mp_obj_t *a
     // Make the function available in the module's namespace
     mp_store_global(MP_QSTR_init, MP_OBJ_FROM_PTR(&init_obj));
     mp_store_global(MP_QSTR_render, MP_OBJ_FROM_PTR(&render_obj));
+    mp_store_global(MP_QSTR_step, MP_OBJ_FROM_PTR(&step_obj));
+    mp_store_global(MP_QSTR_render_rect, MP_OBJ_FROM_PTR(&render_rect_obj));
     mp_store_global(MP_QSTR_move_paddle, MP_OBJ_FROM_PTR(&move_paddle_obj));
     mp_store_global(MP_QSTR_get_score, MP_OBJ_FROM_PTR(&get_score_obj));
     mp_store_global(MP_QSTR_get_highscore, MP_OBJ_FROM_PTR(&get_highscore_obj));
@@ -17,6 +17,8 @@ set(MPOS_C_SOURCES
     ${CMAKE_CURRENT_LIST_DIR}/src/adc_mic.c
     ${CMAKE_CURRENT_LIST_DIR}/src/pdm_mic.c
     ${CMAKE_CURRENT_LIST_DIR}/src/quirc_decode.c
+    ${CMAKE_CURRENT_LIST_DIR}/src/particles.c
+    ${CMAKE_CURRENT_LIST_DIR}/src/ir_rmt.c
     ${CMAKE_CURRENT_LIST_DIR}/quirc/lib/identify.c
     ${CMAKE_CURRENT_LIST_DIR}/quirc/lib/version_db.c
     ${CMAKE_CURRENT_LIST_DIR}/quirc/lib/decode.c
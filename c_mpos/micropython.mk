@@ -17,6 +17,7 @@ endif
 endif
 
 SRC_USERMOD_C += $(MOD_DIR)/src/quirc_decode.c
+SRC_USERMOD_C += $(MOD_DIR)/src/particles.c
 SRC_USERMOD_C += $(MOD_DIR)/quirc/lib/identify.c
 SRC_USERMOD_C += $(MOD_DIR)/quirc/lib/version_db.c
 SRC_USERMOD_C += $(MOD_DIR)/quirc/lib/decode.c
@@ -0,0 +1,192 @@
+// Hardware-timed IR capture for mpos.IRManager, using the ESP32 RMT receiver.
+//
+// The RMT peripheral timestamps every edge of the demodulated IR receiver
+// output itself, so pulse widths stay exact no matter how late Python gets
+// to run. A frame ends when the line stays idle for idle_us; the driver then
+// pushes its symbols into a ringbuffer, and read() converts the oldest frame
+// into a flat array('H') of mark/space durations in microseconds, first mark
+// first.
+//
+// Uses the legacy RMT driver (driver/rmt.h) because esp32.RMT in MicroPython
+// 1.25, which IRManager.send() and ir_tx transmit with, is built on it. IDF 5
+// aborts at boot when the legacy and the new (driver/rmt_rx.h) drivers are
+// linked together, so this must move to the new driver together with esp32.RMT.
+
+#include "py/runtime.h"
+#include "py/obj.h"
+#include "py/mphal.h"
+
+#include "driver/rmt.h"
+#include "freertos/ringbuf.h"
+#include "soc/soc_caps.h"
+
+// The receiver sits at the top of the channel range and borrows the memory
+// blocks of the channels above it, so a frame of `symbols` fits in RMT RAM.
+// Only the upper channels can receive on the S3 and C3, and channel 0 stays
+// free for esp32.RMT to transmit on.
+#define IR_RMT_MAX_MEM_BLOCKS (SOC_RMT_RX_CANDIDATES_PER_GROUP < RMT_CHANNEL_MAX - 1 ? \
+    SOC_RMT_RX_CANDIDATES_PER_GROUP : RMT_CHANNEL_MAX - 1)
+// 80 MHz APB clock / 80 = 1 tick per us
+#define IR_RMT_CLK_DIV 80
+// Pulses shorter than this many APB ticks are glitches (100 = 1.25 us)
+#define IR_RMT_FILTER_TICKS 100
+// Frames the ringbuffer can hold before the driver drops new ones
+#define IR_RMT_RINGBUF_FRAMES 4
+
+typedef struct {
+    mp_obj_base_t base;
+    rmt_channel_t channel;
+    RingbufHandle_t ringbuf;
+    bool installed;
+} ir_rmt_rx_obj_t;
+
+static const mp_obj_type_t ir_rmt_rx_type;
+
+// RMTRx(pin, idle_us=12000, symbols=128)
+static mp_obj_t ir_rmt_rx_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *all_args) {
+    enum { ARG_pin, ARG_idle_us, ARG_symbols };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_pin,     MP_ARG_REQUIRED | MP_ARG_OBJ },
+        { MP_QSTR_idle_us, MP_ARG_INT, {.u_int = 12000} },
+        { MP_QSTR_symbols, MP_ARG_INT, {.u_int = 128} },
+    };
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all_kw_array(n_args, n_kw, all_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    mp_int_t idle_us = args[ARG_idle_us].u_int;
+    mp_int_t max_symbols = args[ARG_symbols].u_int;
+    // Durations are 15 bit tick counts
+    if (idle_us <= 0 || idle_us > 32767) {
+        mp_raise_ValueError(MP_ERROR_TEXT("idle_us must be 1..32767"));
+    }
+    if (max_symbols < 1) {
+        mp_raise_ValueError(MP_ERROR_TEXT("symbols must be positive"));
+    }
+    // One memory word holds one symbol
+    mp_int_t mem_blocks = (max_symbols + SOC_RMT_MEM_WORDS_PER_CHANNEL - 1) / SOC_RMT_MEM_WORDS_PER_CHANNEL;
+    if (mem_blocks > IR_RMT_MAX_MEM_BLOCKS) {
+        mp_raise_msg_varg(&mp_type_ValueError, MP_ERROR_TEXT("symbols must be at most %d"),
+            IR_RMT_MAX_MEM_BLOCKS * SOC_RMT_MEM_WORDS_PER_CHANNEL);
+    }
+
+    ir_rmt_rx_obj_t *self = mp_obj_malloc_with_finaliser(ir_rmt_rx_obj_t, &ir_rmt_rx_type);
+    self->channel = (rmt_channel_t)(RMT_CHANNEL_MAX - mem_blocks);
+    self->ringbuf = NULL;
+    self->installed = false;
+
+    rmt_config_t config = RMT_DEFAULT_CONFIG_RX((gpio_num_t)mp_hal_get_pin_obj(args[ARG_pin].u_obj), self->channel);
+    config.clk_div = IR_RMT_CLK_DIV;
+    config.mem_block_num = (uint8_t)mem_blocks;
+    config.rx_config.filter_en = true;
+    config.rx_config.filter_ticks_thresh = IR_RMT_FILTER_TICKS;
+    config.rx_config.idle_threshold = (uint16_t)idle_us;
+
+    esp_err_t ret = rmt_config(&config);
+    if (ret == ESP_OK) {
+        ret = rmt_driver_install(self->channel, max_symbols * sizeof(rmt_item32_t) * IR_RMT_RINGBUF_FRAMES, 0);
+    }
+    if (ret != ESP_OK) {
+        mp_raise_msg_varg(&mp_type_OSError, MP_ERROR_TEXT("RMT RX init failed: %d"), ret);
+    }
+    self->installed = true;
+
+    rmt_get_ringbuf_handle(self->channel, &self->ringbuf);
+    ret = rmt_rx_start(self->channel, true);
+    if (self->ringbuf == NULL || ret != ESP_OK) {
+        rmt_driver_uninstall(self->channel);
+        self->installed = false;
+        mp_raise_msg_varg(&mp_type_OSError, MP_ERROR_TEXT("RMT receive failed: %d"), ret);
+    }
+
+    return MP_OBJ_FROM_PTR(self);
+}
+
+// .read(buf) -> number of durations written to buf (array('H')), 0 if no
+// frame has finished since the last call. Durations past len(buf) are dropped.
+static mp_obj_t ir_rmt_rx_read(mp_obj_t self_in, mp_obj_t buf_in) {
+    ir_rmt_rx_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(buf_in, &bufinfo, MP_BUFFER_WRITE);
+    if (bufinfo.typecode != 'H') {
+        mp_raise_TypeError(MP_ERROR_TEXT("buffer must be array('H')"));
+    }
+    if (!self->installed) {
+        mp_raise_ValueError(MP_ERROR_TEXT("receiver closed"));
+    }
+
+    size_t size = 0;
+    rmt_item32_t *items = (rmt_item32_t *)xRingbufferReceive(self->ringbuf, &size, 0);
+    if (items == NULL) {
+        return MP_OBJ_NEW_SMALL_INT(0);
+    }
+
+    uint16_t *out = (uint16_t *)bufinfo.buf;
+    const size_t max_out = bufinfo.len / sizeof(uint16_t);
+    const size_t received = size / sizeof(rmt_item32_t);
+    size_t n = 0;
+    bool started = false;
+    for (size_t i = 0; i < received && n < max_out; i++) {
+        const rmt_item32_t s = items[i];
+        const uint16_t durations[2] = { s.duration0, s.duration1 };
+        const uint8_t levels[2] = { s.level0, s.level1 };
+        for (int k = 0; k < 2 && n < max_out; k++) {
+            if (durations[k] == 0) {
+                // Zero duration marks the end of the frame
+                i = received;
+                break;
+            }
+            // The receiver output idles high; start at the first mark (low)
+            if (!started) {
+                if (levels[k] != 0) {
+                    continue;
+                }
+                started = true;
+            }
+            out[n++] = durations[k];
+        }
+    }
+    vRingbufferReturnItem(self->ringbuf, items);
+    return MP_OBJ_NEW_SMALL_INT(n);
+}
+static MP_DEFINE_CONST_FUN_OBJ_2(ir_rmt_rx_read_obj, ir_rmt_rx_read);
+
+// .deinit()
+static mp_obj_t ir_rmt_rx_deinit(mp_obj_t self_in) {
+    ir_rmt_rx_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    if (self->installed) {
+        rmt_rx_stop(self->channel);
+        rmt_driver_uninstall(self->channel);
+        self->installed = false;
+        self->ringbuf = NULL;
+    }
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(ir_rmt_rx_deinit_obj, ir_rmt_rx_deinit);
+
+static const mp_rom_map_elem_t ir_rmt_rx_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_read),    MP_ROM_PTR(&ir_rmt_rx_read_obj) },
+    { MP_ROM_QSTR(MP_QSTR_deinit),  MP_ROM_PTR(&ir_rmt_rx_deinit_obj) },
+    { MP_ROM_QSTR(MP_QSTR___del__), MP_ROM_PTR(&ir_rmt_rx_deinit_obj) },
+};
+static MP_DEFINE_CONST_DICT(ir_rmt_rx_locals_dict, ir_rmt_rx_locals_dict_table);
+
+static MP_DEFINE_CONST_OBJ_TYPE(
+    ir_rmt_rx_type,
+    MP_QSTR_RMTRx,
+    MP_TYPE_FLAG_NONE,
+    make_new, ir_rmt_rx_make_new,
+    locals_dict, &ir_rmt_rx_locals_dict
+);
+
+static const mp_rom_map_elem_t ir_rmt_module_globals_table[] = {
+    { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR__ir_rmt) },
+    { MP_ROM_QSTR(MP_QSTR_RMTRx),    MP_ROM_PTR(&ir_rmt_rx_type) },
+};
+static MP_DEFINE_CONST_DICT(ir_rmt_module_globals, ir_rmt_module_globals_table);
+
+const mp_obj_module_t ir_rmt_module = {
+    .base = { &mp_type_module },
+    .globals = (mp_obj_dict_t *)&ir_rmt_module_globals,
+};
+
+MP_REGISTER_MODULE(MP_QSTR__ir_rmt, ir_rmt_module);
@@ -0,0 +1,100 @@
+// Particle integrator for mpos.ui.ParticleEmitter.
+//
+// Particle state lives in one packed int32 buffer (array('i')) owned by the
+// Python side, PARTICLE_STRIDE words per particle:
+//
+//   0 x      position, 1/256 px
+//   1 y      position, 1/256 px
+//   2 vx     velocity, 1/256 px/s
+//   3 vy     velocity, 1/256 px/s
+//   4 rot    rotation, 0.1 degree (0..3599)
+//   5 spin   angular velocity, 0.1 degree/s
+//   6 age    ms
+//   7 life   ms
+//   8 kind   image index, untouched here
+//   9 scale  output: 256 at birth, shrinking linearly to 77 (0.3) at end of life
+//
+// step() advances every live particle and removes dead ones by moving the
+// last particle into the freed slot, so live particles stay packed at the
+// front of the buffer. The Python fallback in particles.py must match.
+
+#include <stdint.h>
+#include "py/obj.h"
+#include "py/runtime.h"
+
+#define PARTICLE_STRIDE 10
+#define PARTICLE_MIN_SCALE 77
+
+// step(state, count, dt_ms, gravity, width, height, margin) -> live count
+static mp_obj_t particles_step(size_t n_args, const mp_obj_t *args) {
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(args[0], &bufinfo, MP_BUFFER_RW);
+    if (bufinfo.typecode != 'i') {
+        mp_raise_TypeError(MP_ERROR_TEXT("state must be array('i')"));
+    }
+    int32_t *s = (int32_t *)bufinfo.buf;
+
+    mp_int_t count = mp_obj_get_int(args[1]);
+    mp_int_t dt = mp_obj_get_int(args[2]);
+    int32_t dvy = (int32_t)(mp_obj_get_int(args[3]) * 256 * dt / 1000);
+    int32_t xmin = (int32_t)(-mp_obj_get_int(args[6]) * 256);
+    int32_t xmax = (int32_t)((mp_obj_get_int(args[4]) + mp_obj_get_int(args[6])) * 256);
+    int32_t ymax = (int32_t)((mp_obj_get_int(args[5]) + mp_obj_get_int(args[6])) * 256);
+
+    if (count < 0 || (size_t)count * PARTICLE_STRIDE * sizeof(int32_t) > bufinfo.len) {
+        mp_raise_ValueError(MP_ERROR_TEXT("count exceeds state buffer"));
+    }
+    if (dt <= 0) {
+        return MP_OBJ_NEW_SMALL_INT(count);
+    }
+
+    mp_int_t i = 0;
+    while (i < count) {
+        int32_t *p = s + i * PARTICLE_STRIDE;
+        int32_t age = p[6] + (int32_t)dt;
+        int32_t life = p[7];
+        int32_t x = p[0] + p[2] * dt / 1000;
+        int32_t y = p[1] + p[3] * dt / 1000;
+
+        if (age >= life || x < xmin || x > xmax || y > ymax) {
+            count--;
+            if (i != count) {
+                int32_t *last = s + count * PARTICLE_STRIDE;
+                for (int k = 0; k < PARTICLE_STRIDE; k++) {
+                    p[k] = last[k];
+                }
+            }
+            continue;  // the moved particle has not been stepped yet
+        }
+
+        int32_t rot = (p[4] + p[5] * dt / 1000) % 3600;
+        if (rot < 0) {
+            rot += 3600;
+        }
+        int32_t scale = 256 - (int32_t)((int64_t)(256 - PARTICLE_MIN_SCALE) * age / life);
+
+        p[0] = x;
+        p[1] = y;
+        p[3] += dvy;
+        p[4] = rot;
+        p[6] = age;
+        p[9] = scale < PARTICLE_MIN_SCALE ? PARTICLE_MIN_SCALE : scale;
+        i++;
+    }
+    return MP_OBJ_NEW_SMALL_INT(count);
+}
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(particles_step_obj, 7, 7, particles_step);
+
+static const mp_rom_map_elem_t particles_module_globals_table[] = {
+    { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR__particles) },
+    { MP_ROM_QSTR(MP_QSTR_step), MP_ROM_PTR(&particles_step_obj) },
+    { MP_ROM_QSTR(MP_QSTR_STRIDE), MP_ROM_INT(PARTICLE_STRIDE) },
+};
+static MP_DEFINE_CONST_DICT(particles_module_globals, particles_module_globals_table);
+
+const mp_obj_module_t particles_user_cmodule = {
+    .base = { &mp_type_module },
+    .globals = (mp_obj_dict_t *)&particles_module_globals,
+};
+
+MP_REGISTER_MODULE(MP_QSTR__particles, particles_user_cmodule);
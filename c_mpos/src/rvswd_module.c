@@ -37,6 +37,13 @@
  *   expander_i2c = I2C(0, sda=Pin(39), scl=Pin(42), freq=400000)
  *   expander = Expander(i2c_bus=expander_i2c)
  *   print("version:", ".".join(str(i) for i in expander.version))
+ *
+ * Bulk memory access (target halted, lengths in multiples of 4):
+ *
+ *   buf = bytearray(1024)
+ *   prog.readinto(0x20000000, buf)        # dump RAM
+ *   prog.write(0x20000000, loader)         # load a RAM program
+ *   prog.verify(0x08000000, fw)            # target-side checksum, no read-back
  */
 
 #include "py/obj.h"
@@ -90,6 +97,184 @@ static void raise_rvswd_result(rvswd_result_t result) {
     }
 }
 
+// ---------------------------------------------------------------------------
+// Block memory access through the debug module
+//
+// The single-word ch32_read/write_memory_word() helpers set up the debug
+// module for every word. For bulk transfers the program buffer instead holds
+// a small load/store loop body that also advances the address kept in DATA1,
+// and ABSTRACTAUTO re-runs it on every DATA0 access, so each further word
+// costs exactly one RVSWD register transfer. The target must be halted; the
+// routines clobber x8-x13.
+// ---------------------------------------------------------------------------
+
+#define DM_DATA0        0x04
+#define DM_DATA1        0x05
+#define DM_ABSTRACTCS   0x16
+#define DM_COMMAND      0x17
+#define DM_ABSTRACTAUTO 0x18
+#define DM_PROGBUF0     0x20
+
+// Memory-mapped addresses of DATA0/DATA1 as seen by the QingKe core.
+#define DM_DATA0_ADDR   0xe00000f4
+#define DM_DATA1_ADDR   0xe00000f8
+
+#define DM_ABSTRACTCS_BUSY   (1u << 12)
+#define DM_ABSTRACTCS_CMDERR (7u << 8)
+
+// Access-register commands: 32-bit GPR x<n>, optionally transfer/write/postexec.
+#define DM_CMD_WRITE_GPR(n)    (0x00230000u | 0x1000u | (n))
+#define DM_CMD_READ_GPR(n)     (0x00220000u | 0x1000u | (n))
+#define DM_CMD_POSTEXEC        0x00240000u
+#define DM_CMD_WRITE_GPR_EXEC(n) (0x00270000u | 0x1000u | (n))
+
+#define DM_BUSY_POLLS   100000  // generous: a checksum over all of flash runs for ms
+
+// x8 = *DATA1; x9 = *x8; x8 += 4; *DATA0 = x9; *DATA1 = x8
+static const uint32_t progbuf_read[] = { 0x40044180, 0xc1040411, 0x9002c180 };
+// x9 = *DATA1; *x9 = x8 (x8 loaded from DATA0 by the command); x9 += 4; *DATA1 = x9
+static const uint32_t progbuf_write[] = { 0xc0804184, 0xc1840491, 0x00019002 };
+// do { x9 = *x8; x12 += x9; x13 += x12; x8 += 4 } while (x8 != x11)
+static const uint32_t progbuf_checksum[] = { 0x96264004, 0x041196b2, 0xfeb41ce3, 0x00019002 };
+
+static rvswd_result_t dm_wait_idle(rvswd_handle_t *handle) {
+    for (int i = 0; i < DM_BUSY_POLLS; i++) {
+        uint32_t abstractcs = 0;
+        rvswd_result_t result = rvswd_read(handle, DM_ABSTRACTCS, &abstractcs);
+        if (result != RVSWD_OK) {
+            return result;
+        }
+        if (abstractcs & DM_ABSTRACTCS_CMDERR) {
+            rvswd_write(handle, DM_ABSTRACTCS, DM_ABSTRACTCS_CMDERR);  // write-1-to-clear
+            return RVSWD_FAIL;
+        }
+        if (!(abstractcs & DM_ABSTRACTCS_BUSY)) {
+            return RVSWD_OK;
+        }
+    }
+    return RVSWD_FAIL;
+}
+
+static rvswd_result_t dm_set_gpr(rvswd_handle_t *handle, uint8_t reg, uint32_t value) {
+    rvswd_result_t result = rvswd_write(handle, DM_DATA0, value);
+    if (result == RVSWD_OK) result = rvswd_write(handle, DM_COMMAND, DM_CMD_WRITE_GPR(reg));
+    if (result == RVSWD_OK) result = dm_wait_idle(handle);
+    return result;
+}
+
+static rvswd_result_t dm_get_gpr(rvswd_handle_t *handle, uint8_t reg, uint32_t *value) {
+    rvswd_result_t result = rvswd_write(handle, DM_COMMAND, DM_CMD_READ_GPR(reg));
+    if (result == RVSWD_OK) result = dm_wait_idle(handle);
+    if (result == RVSWD_OK) result = rvswd_read(handle, DM_DATA0, value);
+    return result;
+}
+
+static rvswd_result_t dm_load_progbuf(rvswd_handle_t *handle, const uint32_t *prog, size_t words) {
+    for (size_t i = 0; i < words; i++) {
+        rvswd_result_t result = rvswd_write(handle, DM_PROGBUF0 + i, prog[i]);
+        if (result != RVSWD_OK) {
+            return result;
+        }
+    }
+    return RVSWD_OK;
+}
+
+// Points x10/x11 at DATA0/DATA1 and DATA1 at addr, then loads prog.
+static rvswd_result_t dm_setup_transfer(rvswd_handle_t *handle, uint32_t addr, const uint32_t *prog, size_t words) {
+    rvswd_result_t result = rvswd_write(handle, DM_ABSTRACTAUTO, 0);
+    if (result == RVSWD_OK) result = dm_set_gpr(handle, 10, DM_DATA0_ADDR);
+    if (result == RVSWD_OK) result = dm_set_gpr(handle, 11, DM_DATA1_ADDR);
+    if (result == RVSWD_OK) result = dm_load_progbuf(handle, prog, words);
+    if (result == RVSWD_OK) result = rvswd_write(handle, DM_DATA1, addr);
+    return result;
+}
+
+static rvswd_result_t dm_finish_transfer(rvswd_handle_t *handle, rvswd_result_t result) {
+    rvswd_result_t stop = rvswd_write(handle, DM_ABSTRACTAUTO, 0);
+    if (result == RVSWD_OK) result = stop;
+    if (result == RVSWD_OK) result = dm_wait_idle(handle);
+    return result;
+}
+
+// Word buffers are copied with memcpy(): both ends are little-endian and the
+// Python buffer need not be word aligned.
+static rvswd_result_t ch32_read_memory_block(rvswd_handle_t *handle, uint32_t addr, uint8_t *out, size_t count) {
+    rvswd_result_t result = dm_setup_transfer(handle, addr, progbuf_read, MP_ARRAY_SIZE(progbuf_read));
+    // Run the program once to fetch the first word, then let every DATA0 read
+    // fetch the next one. Auto-execution is switched off before the last read
+    // so nothing past the end of the block is touched.
+    if (result == RVSWD_OK) result = rvswd_write(handle, DM_COMMAND, DM_CMD_POSTEXEC);
+    if (result == RVSWD_OK) result = dm_wait_idle(handle);
+    if (result == RVSWD_OK && count > 1) result = rvswd_write(handle, DM_ABSTRACTAUTO, 1);
+    for (size_t i = 0; i < count && result == RVSWD_OK; i++) {
+        if (i == count - 1 && count > 1) {
+            result = rvswd_write(handle, DM_ABSTRACTAUTO, 0);
+            if (result == RVSWD_OK) result = dm_wait_idle(handle);
+            if (result != RVSWD_OK) break;
+        }
+        uint32_t word = 0;
+        result = rvswd_read(handle, DM_DATA0, &word);
+        memcpy(out + 4 * i, &word, 4);
+    }
+    return dm_finish_transfer(handle, result);
+}
+
+static rvswd_result_t ch32_write_memory_block(rvswd_handle_t *handle, uint32_t addr, const uint8_t *in, size_t count) {
+    uint32_t word;
+    rvswd_result_t result = dm_setup_transfer(handle, addr, progbuf_write, MP_ARRAY_SIZE(progbuf_write));
+    // The first word goes through an explicit command; after that every DATA0
+    // write loads x8 and runs the store program.
+    memcpy(&word, in, 4);
+    if (result == RVSWD_OK) result = rvswd_write(handle, DM_DATA0, word);
+    if (result == RVSWD_OK) result = rvswd_write(handle, DM_COMMAND, DM_CMD_WRITE_GPR_EXEC(8));
+    if (result == RVSWD_OK) result = dm_wait_idle(handle);
+    if (result == RVSWD_OK && count > 1) result = rvswd_write(handle, DM_ABSTRACTAUTO, 1);
+    for (size_t i = 1; i < count && result == RVSWD_OK; i++) {
+        memcpy(&word, in + 4 * i, 4);
+        result = rvswd_write(handle, DM_DATA0, word);
+    }
+    return dm_finish_transfer(handle, result);
+}
+
+// Fletcher-style pair of 32-bit running sums over [addr, addr + 4 * count),
+// computed by the target itself: a + w and b + a for every word w.
+static rvswd_result_t ch32_checksum_block(rvswd_handle_t *handle, uint32_t addr, size_t count, uint32_t sums[2]) {
+    rvswd_result_t result = rvswd_write(handle, DM_ABSTRACTAUTO, 0);
+    if (result == RVSWD_OK) result = dm_load_progbuf(handle, progbuf_checksum, MP_ARRAY_SIZE(progbuf_checksum));
+    if (result == RVSWD_OK) result = dm_set_gpr(handle, 8, addr);
+    if (result == RVSWD_OK) result = dm_set_gpr(handle, 11, addr + 4 * count);
+    if (result == RVSWD_OK) result = dm_set_gpr(handle, 12, 0);
+    if (result == RVSWD_OK) result = dm_set_gpr(handle, 13, 0);
+    if (result == RVSWD_OK) result = rvswd_write(handle, DM_COMMAND, DM_CMD_POSTEXEC);
+    if (result == RVSWD_OK) result = dm_wait_idle(handle);
+    if (result == RVSWD_OK) result = dm_get_gpr(handle, 12, &sums[0]);
+    if (result == RVSWD_OK) result = dm_get_gpr(handle, 13, &sums[1]);
+    return result;
+}
+
+static void checksum_words(const uint8_t *data, size_t len, uint32_t sums[2]) {
+    // Same sums as the target program, over little-endian words of data; a
+    // trailing partial word is padded with 0xff like erased flash.
+    uint32_t a = 0, b = 0;
+    for (size_t off = 0; off < len; off += 4) {
+        uint32_t word = 0;
+        for (size_t i = 0; i < 4; i++) {
+            uint32_t byte = (off + i < len) ? data[off + i] : 0xff;
+            word |= byte << (8 * i);
+        }
+        a += word;
+        b += a;
+    }
+    sums[0] = a;
+    sums[1] = b;
+}
+
+static void check_block_args(uint32_t addr, size_t len) {
+    if ((addr & 3) || (len & 3)) {
+        mp_raise_ValueError(MP_ERROR_TEXT("address and length must be multiples of 4"));
+    }
+}
+
 // ---------------------------------------------------------------------------
 // Constructor: RVSWD(swdio, swclk)
 // ---------------------------------------------------------------------------
@@ -182,6 +367,74 @@ static mp_obj_t mprvswd_write_memory(mp_obj_t self_in, mp_obj_t addr_in, mp_obj_
 }
 MP_DEFINE_CONST_FUN_OBJ_3(rvswd_write_memory_obj, mprvswd_write_memory);
 
+// readinto(addr, buf)
+// Fills buf (length a multiple of 4) with target memory starting at addr.
+static mp_obj_t mprvswd_readinto(mp_obj_t self_in, mp_obj_t addr_in, mp_obj_t buf_in) {
+    rvswd_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    uint32_t addr = (uint32_t)mp_obj_get_int(addr_in);
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(buf_in, &bufinfo, MP_BUFFER_WRITE);
+    check_block_args(addr, bufinfo.len);
+    if (bufinfo.len == 0) {
+        return mp_const_none;
+    }
+    raise_rvswd_result(ch32_read_memory_block(&self->handle, addr, bufinfo.buf, bufinfo.len / 4));
+    return mp_const_none;
+}
+MP_DEFINE_CONST_FUN_OBJ_3(rvswd_readinto_obj, mprvswd_readinto);
+
+// write(addr, data)
+// Stores data (length a multiple of 4) to target RAM or registers at addr.
+// Flash has to go through the *_write_flash() functions.
+static mp_obj_t mprvswd_write(mp_obj_t self_in, mp_obj_t addr_in, mp_obj_t data_in) {
+    rvswd_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    uint32_t addr = (uint32_t)mp_obj_get_int(addr_in);
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(data_in, &bufinfo, MP_BUFFER_READ);
+    check_block_args(addr, bufinfo.len);
+    if (bufinfo.len == 0) {
+        return mp_const_none;
+    }
+    raise_rvswd_result(ch32_write_memory_block(&self->handle, addr, bufinfo.buf, bufinfo.len / 4));
+    return mp_const_none;
+}
+MP_DEFINE_CONST_FUN_OBJ_3(rvswd_write_obj, mprvswd_write);
+
+// checksum(addr, length) -> (a, b)
+// Runs the Fletcher-style checksum loop on the target, no data is read back.
+static mp_obj_t mprvswd_checksum(mp_obj_t self_in, mp_obj_t addr_in, mp_obj_t len_in) {
+    rvswd_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    uint32_t addr = (uint32_t)mp_obj_get_int(addr_in);
+    size_t len = (size_t)mp_obj_get_int(len_in);
+    check_block_args(addr, len);
+    uint32_t sums[2] = {0, 0};
+    if (len > 0) {
+        raise_rvswd_result(ch32_checksum_block(&self->handle, addr, len / 4, sums));
+    }
+    mp_obj_t tuple[2] = { mp_obj_new_int_from_uint(sums[0]), mp_obj_new_int_from_uint(sums[1]) };
+    return mp_obj_new_tuple(2, tuple);
+}
+MP_DEFINE_CONST_FUN_OBJ_3(rvswd_checksum_obj, mprvswd_checksum);
+
+// verify(addr, data) -> bool
+// Compares target memory with data using checksum() instead of a read-back.
+// A trailing partial word of data is compared against 0xff padding.
+static mp_obj_t mprvswd_verify(mp_obj_t self_in, mp_obj_t addr_in, mp_obj_t data_in) {
+    rvswd_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    uint32_t addr = (uint32_t)mp_obj_get_int(addr_in);
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(data_in, &bufinfo, MP_BUFFER_READ);
+    size_t words = (bufinfo.len + 3) / 4;
+    check_block_args(addr, 4 * words);
+    uint32_t expected[2], actual[2] = {0, 0};
+    checksum_words(bufinfo.buf, bufinfo.len, expected);
+    if (words > 0) {
+        raise_rvswd_result(ch32_checksum_block(&self->handle, addr, words, actual));
+    }
+    return mp_obj_new_bool(expected[0] == actual[0] && expected[1] == actual[1]);
+}
+MP_DEFINE_CONST_FUN_OBJ_3(rvswd_verify_obj, mprvswd_verify);
+
 // Returns a 4-tuple of uint32 vendor bytes for chip identification.
 static mp_obj_t mprvswd_read_vendor_bytes(mp_obj_t self_in) {
     rvswd_obj_t *self = MP_OBJ_TO_PTR(self_in);
@@ -352,6 +605,10 @@ static const mp_rom_map_elem_t rvswd_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_reset_and_run),     MP_ROM_PTR(&rvswd_reset_and_run_obj) },
     { MP_ROM_QSTR(MP_QSTR_read_memory),       MP_ROM_PTR(&rvswd_read_memory_obj) },
     { MP_ROM_QSTR(MP_QSTR_write_memory),      MP_ROM_PTR(&rvswd_write_memory_obj) },
+    { MP_ROM_QSTR(MP_QSTR_readinto),          MP_ROM_PTR(&rvswd_readinto_obj) },
+    { MP_ROM_QSTR(MP_QSTR_write),             MP_ROM_PTR(&rvswd_write_obj) },
+    { MP_ROM_QSTR(MP_QSTR_checksum),          MP_ROM_PTR(&rvswd_checksum_obj) },
+    { MP_ROM_QSTR(MP_QSTR_verify),            MP_ROM_PTR(&rvswd_verify_obj) },
     { MP_ROM_QSTR(MP_QSTR_read_vendor_bytes), MP_ROM_PTR(&rvswd_read_vendor_bytes_obj) },
     // CH32V20x
     { MP_ROM_QSTR(MP_QSTR_v20x_program),      MP_ROM_PTR(&rvswd_v20x_program_obj) },
@@ -0,0 +1 @@
+// Host stand-in for MicroPython's py/mphal.h; nothing in it is used yet.
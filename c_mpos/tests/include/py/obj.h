@@ -0,0 +1,109 @@
+// Host stand-in for the parts of MicroPython's py/obj.h that the c_mpos
+// modules under test use. Objects are fake_obj_t values built by the test.
+
+#ifndef C_MPOS_TESTS_PY_OBJ_H
+#define C_MPOS_TESTS_PY_OBJ_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef intptr_t mp_int_t;
+typedef uintptr_t mp_uint_t;
+
+typedef enum {
+    FAKE_NONE,
+    FAKE_BOOL,
+    FAKE_INT,
+    FAKE_BUFFER,
+    FAKE_TUPLE,
+    FAKE_STR,
+    FAKE_INSTANCE,
+} fake_kind_t;
+
+typedef struct _fake_obj_t {
+    fake_kind_t kind;
+    mp_int_t value;
+    void *buf;
+    size_t len;
+    struct _fake_obj_t *items[4];
+} fake_obj_t;
+
+typedef fake_obj_t *mp_obj_t;
+
+typedef struct {
+    const char *name;
+} mp_obj_type_t;
+
+typedef struct {
+    const mp_obj_type_t *type;
+} mp_obj_base_t;
+
+typedef struct {
+    const void *key;
+    const void *value;
+} mp_rom_map_elem_t;
+
+typedef struct {
+    const mp_rom_map_elem_t *table;
+    size_t used;
+} mp_obj_dict_t;
+
+typedef struct {
+    mp_obj_base_t base;
+    mp_obj_dict_t *globals;
+} mp_obj_module_t;
+
+typedef struct {
+    const void *fun;
+} mp_obj_fun_builtin_t;
+
+typedef struct {
+    void *buf;
+    size_t len;
+    int typecode;
+} mp_buffer_info_t;
+
+#define MP_BUFFER_READ  (1)
+#define MP_BUFFER_WRITE (2)
+
+extern fake_obj_t fake_none_obj;
+extern fake_obj_t fake_true_obj;
+extern fake_obj_t fake_false_obj;
+extern const mp_obj_type_t mp_type_module;
+
+#define MP_OBJ_NULL ((mp_obj_t)NULL)
+#define mp_const_none (&fake_none_obj)
+#define MP_OBJ_TO_PTR(o) ((void *)(o))
+#define MP_OBJ_FROM_PTR(p) ((mp_obj_t)(p))
+
+mp_obj_t MP_OBJ_NEW_SMALL_INT(mp_int_t value);
+mp_int_t mp_obj_get_int(mp_obj_t o);
+mp_obj_t mp_obj_new_int_from_uint(mp_uint_t value);
+mp_obj_t mp_obj_new_bool(bool value);
+mp_obj_t mp_obj_new_str(const char *data, size_t len);
+mp_obj_t mp_obj_new_tuple(size_t n, const mp_obj_t *items);
+void mp_get_buffer_raise(mp_obj_t o, mp_buffer_info_t *bufinfo, int flags);
+
+// QSTRs are not interned on the host; macros that take one drop it.
+#define MP_ROM_QSTR(q) NULL
+#define MP_ROM_PTR(p) ((const void *)(p))
+#define MP_ROM_INT(i) ((const void *)(intptr_t)(i))
+
+#define MP_DEFINE_CONST_DICT(name, table) \
+    const mp_obj_dict_t name = { table, sizeof(table) / sizeof((table)[0]) }
+#define MP_DEFINE_CONST_OBJ_TYPE(name, qstr, flags, ...) \
+    const mp_obj_type_t name = { #name }
+#define MP_DEFINE_CONST_FUN_OBJ_0(name, fun) const mp_obj_fun_builtin_t name = { (const void *)(fun) }
+#define MP_DEFINE_CONST_FUN_OBJ_1(name, fun) const mp_obj_fun_builtin_t name = { (const void *)(fun) }
+#define MP_DEFINE_CONST_FUN_OBJ_2(name, fun) const mp_obj_fun_builtin_t name = { (const void *)(fun) }
+#define MP_DEFINE_CONST_FUN_OBJ_3(name, fun) const mp_obj_fun_builtin_t name = { (const void *)(fun) }
+#define MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(name, min, max, fun) \
+    const mp_obj_fun_builtin_t name = { (const void *)(fun) }
+#define MP_REGISTER_MODULE(qstr, module) extern const mp_obj_module_t module
+
+#define MP_ARRAY_SIZE(a) (sizeof(a) / sizeof((a)[0]))
+
+#define MP_TYPE_FLAG_NONE (0)
+
+#endif // C_MPOS_TESTS_PY_OBJ_H
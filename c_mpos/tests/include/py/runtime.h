@@ -0,0 +1,28 @@
+// Host stand-in for MicroPython's py/runtime.h. The mp_raise_*() functions
+// record the exception and longjmp back to the test (see fake_raised).
+
+#ifndef C_MPOS_TESTS_PY_RUNTIME_H
+#define C_MPOS_TESTS_PY_RUNTIME_H
+
+#include <stdlib.h>
+
+#include "py/obj.h"
+
+#define MP_ERROR_TEXT(s) (s)
+#define NORETURN __attribute__((noreturn))
+
+extern const mp_obj_type_t mp_type_RuntimeError;
+extern const mp_obj_type_t mp_type_ValueError;
+
+NORETURN void mp_raise_msg(const mp_obj_type_t *type, const char *msg);
+NORETURN void mp_raise_msg_varg(const mp_obj_type_t *type, const char *fmt, ...);
+NORETURN void mp_raise_ValueError(const char *msg);
+
+void mp_arg_check_num(size_t n_args, size_t n_kw, size_t n_args_min, size_t n_args_max, bool takes_kw);
+mp_obj_t mp_call_function_n_kw(mp_obj_t fun, size_t n_args, size_t n_kw, const mp_obj_t *args);
+
+#define mp_obj_malloc(struct_type, obj_type) \
+    ((struct_type *)fake_obj_malloc(sizeof(struct_type), (obj_type)))
+void *fake_obj_malloc(size_t size, const mp_obj_type_t *type);
+
+#endif // C_MPOS_TESTS_PY_RUNTIME_H
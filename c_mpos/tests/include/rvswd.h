@@ -0,0 +1,28 @@
+// Host stand-in for esp32-component-rvswd's rvswd.h. The test provides the
+// transport functions, backed by a simulated CH32 debug module.
+
+#ifndef C_MPOS_TESTS_RVSWD_H
+#define C_MPOS_TESTS_RVSWD_H
+
+#include <stdint.h>
+
+typedef int gpio_num_t;
+
+typedef enum {
+    RVSWD_OK = 0,
+    RVSWD_FAIL = 1,
+    RVSWD_INVALID_ARGS = 2,
+    RVSWD_PARITY_ERROR = 3,
+} rvswd_result_t;
+
+typedef struct {
+    gpio_num_t swdio;
+    gpio_num_t swclk;
+} rvswd_handle_t;
+
+rvswd_result_t rvswd_init(rvswd_handle_t *handle);
+rvswd_result_t rvswd_reset(rvswd_handle_t *handle);
+rvswd_result_t rvswd_write(rvswd_handle_t *handle, uint8_t reg, uint32_t value);
+rvswd_result_t rvswd_read(rvswd_handle_t *handle, uint8_t reg, uint32_t *value);
+
+#endif // C_MPOS_TESTS_RVSWD_H
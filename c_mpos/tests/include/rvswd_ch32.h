@@ -0,0 +1,17 @@
+// Host stand-in for esp32-component-rvswd's rvswd_ch32.h.
+
+#ifndef C_MPOS_TESTS_RVSWD_CH32_H
+#define C_MPOS_TESTS_RVSWD_CH32_H
+
+#include <stdbool.h>
+
+#include "rvswd.h"
+
+rvswd_result_t ch32_halt_microprocessor(rvswd_handle_t *handle);
+rvswd_result_t ch32_resume_microprocessor(rvswd_handle_t *handle);
+rvswd_result_t ch32_reset_microprocessor_and_run(rvswd_handle_t *handle);
+bool ch32_read_memory_word(rvswd_handle_t *handle, uint32_t address, uint32_t *value);
+bool ch32_write_memory_word(rvswd_handle_t *handle, uint32_t address, uint32_t value);
+bool ch32_read_vendor_bytes(rvswd_handle_t *handle, uint32_t vendor_bytes[4]);
+
+#endif // C_MPOS_TESTS_RVSWD_CH32_H
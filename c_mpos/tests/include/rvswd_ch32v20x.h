@@ -0,0 +1,19 @@
+// Host stand-in for esp32-component-rvswd's rvswd_ch32v20x.h.
+
+#ifndef C_MPOS_TESTS_RVSWD_CH32V20X_H
+#define C_MPOS_TESTS_RVSWD_CH32V20X_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "rvswd.h"
+
+typedef void (*ch32v20x_status_callback)(char const *msg, uint8_t progress);
+
+bool ch32v20x_program(rvswd_handle_t *handle, const uint8_t *firmware, size_t length, ch32v20x_status_callback status_callback);
+bool ch32v20x_unlock_flash(rvswd_handle_t *handle);
+bool ch32v20x_lock_flash(rvswd_handle_t *handle);
+bool ch32v20x_write_flash(rvswd_handle_t *handle, uint32_t address, const uint8_t *data, size_t length, ch32v20x_status_callback status_callback);
+bool ch32v20x_clear_running_operations(rvswd_handle_t *handle);
+
+#endif // C_MPOS_TESTS_RVSWD_CH32V20X_H
@@ -0,0 +1,478 @@
+// Host test for c_mpos/src/rvswd_module.c.
+//
+// The module is compiled against the stand-in headers in include/ and its
+// Python bindings are called directly. The RVSWD transport underneath is a
+// fake: rvswd_read()/rvswd_write() drive a simulated CH32 debug module with
+// DATA0/DATA1, COMMAND, ABSTRACTAUTO, an 8-word program buffer run by a small
+// RV32C interpreter, and 64 KiB of RAM at 0x20000000. Every register access
+// is counted, so the test also checks how many transfers a block costs.
+//
+// Run with: make -C c_mpos/tests
+
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "../src/rvswd_module.c"
+
+// ---------------------------------------------------------------------------
+// Fake MicroPython runtime
+// ---------------------------------------------------------------------------
+
+fake_obj_t fake_none_obj = { .kind = FAKE_NONE };
+fake_obj_t fake_true_obj = { .kind = FAKE_BOOL, .value = 1 };
+fake_obj_t fake_false_obj = { .kind = FAKE_BOOL, .value = 0 };
+const mp_obj_type_t mp_type_module = { "module" };
+const mp_obj_type_t mp_type_RuntimeError = { "RuntimeError" };
+const mp_obj_type_t mp_type_ValueError = { "ValueError" };
+
+// Objects returned by the bindings live in a pool that each test resets.
+static fake_obj_t obj_pool[64];
+static size_t obj_pool_used;
+
+static mp_obj_t new_obj(fake_kind_t kind) {
+    if (obj_pool_used >= MP_ARRAY_SIZE(obj_pool)) {
+        fprintf(stderr, "object pool exhausted\n");
+        exit(2);
+    }
+    mp_obj_t o = &obj_pool[obj_pool_used++];
+    memset(o, 0, sizeof(*o));
+    o->kind = kind;
+    return o;
+}
+
+mp_obj_t MP_OBJ_NEW_SMALL_INT(mp_int_t value) {
+    mp_obj_t o = new_obj(FAKE_INT);
+    o->value = value;
+    return o;
+}
+
+mp_int_t mp_obj_get_int(mp_obj_t o) {
+    return o->value;
+}
+
+mp_obj_t mp_obj_new_int_from_uint(mp_uint_t value) {
+    return MP_OBJ_NEW_SMALL_INT((mp_int_t)value);
+}
+
+mp_obj_t mp_obj_new_bool(bool value) {
+    return value ? &fake_true_obj : &fake_false_obj;
+}
+
+mp_obj_t mp_obj_new_str(const char *data, size_t len) {
+    mp_obj_t o = new_obj(FAKE_STR);
+    o->buf = (void *)data;
+    o->len = len;
+    return o;
+}
+
+mp_obj_t mp_obj_new_tuple(size_t n, const mp_obj_t *items) {
+    mp_obj_t o = new_obj(FAKE_TUPLE);
+    o->len = n;
+    for (size_t i = 0; i < n; i++) {
+        o->items[i] = items[i];
+    }
+    return o;
+}
+
+void mp_get_buffer_raise(mp_obj_t o, mp_buffer_info_t *bufinfo, int flags) {
+    (void)flags;
+    bufinfo->buf = o->buf;
+    bufinfo->len = o->len;
+    bufinfo->typecode = 'B';
+}
+
+void mp_arg_check_num(size_t n_args, size_t n_kw, size_t n_args_min, size_t n_args_max, bool takes_kw) {
+    (void)takes_kw;
+    if (n_args < n_args_min || n_args > n_args_max || n_kw > 0) {
+        mp_raise_msg(&mp_type_ValueError, "wrong number of arguments");
+    }
+}
+
+mp_obj_t mp_call_function_n_kw(mp_obj_t fun, size_t n_args, size_t n_kw, const mp_obj_t *args) {
+    (void)fun;
+    (void)n_args;
+    (void)n_kw;
+    (void)args;
+    return mp_const_none;
+}
+
+void *fake_obj_malloc(size_t size, const mp_obj_type_t *type) {
+    mp_obj_base_t *base = calloc(1, size);
+    base->type = type;
+    return base;
+}
+
+// Exceptions unwind to the CALL_RAISES() in progress.
+static jmp_buf *raise_target;
+static const mp_obj_type_t *raised_type;
+
+void mp_raise_msg(const mp_obj_type_t *type, const char *msg) {
+    (void)msg;
+    raised_type = type;
+    if (raise_target == NULL) {
+        fprintf(stderr, "unexpected %s: %s\n", type->name, msg);
+        exit(2);
+    }
+    longjmp(*raise_target, 1);
+}
+
+void mp_raise_msg_varg(const mp_obj_type_t *type, const char *fmt, ...) {
+    mp_raise_msg(type, fmt);
+}
+
+void mp_raise_ValueError(const char *msg) {
+    mp_raise_msg(&mp_type_ValueError, msg);
+}
+
+// ---------------------------------------------------------------------------
+// Fake RVSWD transport: a simulated CH32 debug module
+// ---------------------------------------------------------------------------
+
+#define RAM_BASE 0x20000000u
+#define RAM_SIZE 0x10000u
+
+#define CMDERR_EXCEPTION 3
+#define CMDERR_HALT_RESUME 4
+
+static uint8_t ram[RAM_SIZE];
+static uint32_t gpr[32];
+static uint32_t dm_data0, dm_data1, dm_command, dm_abstractauto, dm_cmderr;
+static uint32_t dm_progbuf[8];
+static long transfers;
+
+// Core view of memory: RAM plus the memory-mapped DATA0/DATA1.
+static uint32_t *core_word(uint32_t addr) {
+    if (addr == DM_DATA0_ADDR) {
+        return &dm_data0;
+    }
+    if (addr == DM_DATA1_ADDR) {
+        return &dm_data1;
+    }
+    if (addr < RAM_BASE || addr - RAM_BASE > RAM_SIZE - 4 || (addr & 3)) {
+        dm_cmderr = CMDERR_EXCEPTION;
+        return NULL;
+    }
+    return (uint32_t *)(ram + (addr - RAM_BASE));
+}
+
+// CL-format offset of c.lw/c.sw: uimm[5:3] in bits 12:10, [2] in 6, [6] in 5
+static uint32_t c_lsw_offset(uint16_t insn) {
+    return ((insn >> 10) & 7) << 3 | ((insn >> 6) & 1) << 2 | ((insn >> 5) & 1) << 6;
+}
+
+// Runs the program buffer until c.ebreak. Knows just the instructions the
+// module's programs use: c.lw, c.sw, c.addi, c.add, c.nop, c.ebreak, bne.
+static void run_progbuf(void) {
+    const uint8_t *prog = (const uint8_t *)dm_progbuf;
+    uint32_t pc = 0;
+    for (long steps = 0; pc + 2 <= sizeof(dm_progbuf); steps++) {
+        if (steps > 10000000) {
+            dm_cmderr = CMDERR_HALT_RESUME;
+            return;
+        }
+        uint16_t insn;
+        memcpy(&insn, prog + pc, 2);
+        if ((insn & 3) == 3) {
+            uint32_t word;
+            memcpy(&word, prog + pc, 4);
+            if ((word & 0x7f) != 0x63 || ((word >> 12) & 7) != 1) {
+                dm_cmderr = CMDERR_EXCEPTION;
+                return;
+            }
+            // bne rs1, rs2, imm
+            int32_t imm = ((word >> 31) & 1) << 12 | ((word >> 7) & 1) << 11 |
+                          ((word >> 25) & 63) << 5 | ((word >> 8) & 15) << 1;
+            if (imm & 0x1000) {
+                imm -= 0x2000;
+            }
+            pc += (gpr[(word >> 15) & 31] != gpr[(word >> 20) & 31]) ? (uint32_t)imm : 4;
+            continue;
+        }
+        const int funct3 = insn >> 13;
+        const int quadrant = insn & 3;
+        if (insn == 0x9002) {
+            return;  // c.ebreak
+        } else if (insn == 0x0001) {
+            // c.nop
+        } else if (quadrant == 0 && funct3 == 2) {
+            // c.lw rd', offset(rs1')
+            uint32_t *p = core_word(gpr[8 + ((insn >> 7) & 7)] + c_lsw_offset(insn));
+            if (p == NULL) {
+                return;
+            }
+            gpr[8 + ((insn >> 2) & 7)] = *p;
+        } else if (quadrant == 0 && funct3 == 6) {
+            // c.sw rs2', offset(rs1')
+            uint32_t *p = core_word(gpr[8 + ((insn >> 7) & 7)] + c_lsw_offset(insn));
+            if (p == NULL) {
+                return;
+            }
+            *p = gpr[8 + ((insn >> 2) & 7)];
+        } else if (quadrant == 1 && funct3 == 0) {
+            // c.addi rd, imm
+            int32_t imm = ((insn >> 2) & 31) | (((insn >> 12) & 1) ? ~31 : 0);
+            gpr[(insn >> 7) & 31] += (uint32_t)imm;
+        } else if (quadrant == 2 && (insn >> 12) == 9) {
+            // c.add rd, rs2
+            gpr[(insn >> 7) & 31] += gpr[(insn >> 2) & 31];
+        } else {
+            dm_cmderr = CMDERR_EXCEPTION;
+            return;
+        }
+        pc += 2;
+    }
+    dm_cmderr = CMDERR_EXCEPTION;  // ran off the end of the buffer
+}
+
+static void exec_command(void) {
+    if (dm_cmderr != 0) {
+        return;
+    }
+    // Access register: transfer bit 17, write bit 16, regno 0x1000 + n
+    if (dm_command & (1u << 17)) {
+        uint32_t regno = dm_command & 0xffff;
+        if (regno < 0x1000 || regno >= 0x1020) {
+            dm_cmderr = CMDERR_EXCEPTION;
+            return;
+        }
+        if (dm_command & (1u << 16)) {
+            gpr[regno - 0x1000] = dm_data0;
+        } else {
+            dm_data0 = gpr[regno - 0x1000];
+        }
+    }
+    if (dm_command & (1u << 18)) {
+        run_progbuf();
+    }
+}
+
+rvswd_result_t rvswd_read(rvswd_handle_t *handle, uint8_t reg, uint32_t *value) {
+    (void)handle;
+    transfers++;
+    switch (reg) {
+        case DM_DATA0:
+            *value = dm_data0;
+            if (dm_abstractauto & 1) {
+                exec_command();
+            }
+            break;
+        case DM_DATA1:
+            *value = dm_data1;
+            break;
+        case DM_ABSTRACTCS:
+            *value = dm_cmderr << 8;
+            break;
+        default:
+            *value = 0;
+            break;
+    }
+    return RVSWD_OK;
+}
+
+rvswd_result_t rvswd_write(rvswd_handle_t *handle, uint8_t reg, uint32_t value) {
+    (void)handle;
+    transfers++;
+    if (reg == DM_DATA0) {
+        dm_data0 = value;
+        if (dm_abstractauto & 1) {
+            exec_command();
+        }
+    } else if (reg == DM_DATA1) {
+        dm_data1 = value;
+    } else if (reg == DM_ABSTRACTCS) {
+        dm_cmderr &= ~((value >> 8) & 7);
+    } else if (reg == DM_COMMAND) {
+        dm_command = value;
+        exec_command();
+    } else if (reg == DM_ABSTRACTAUTO) {
+        dm_abstractauto = value;
+    } else if (reg >= DM_PROGBUF0 && reg < DM_PROGBUF0 + 8) {
+        dm_progbuf[reg - DM_PROGBUF0] = value;
+    }
+    return RVSWD_OK;
+}
+
+rvswd_result_t rvswd_init(rvswd_handle_t *handle) {
+    (void)handle;
+    return RVSWD_OK;
+}
+
+rvswd_result_t rvswd_reset(rvswd_handle_t *handle) {
+    (void)handle;
+    return RVSWD_OK;
+}
+
+// The chip-level helpers are not under test.
+rvswd_result_t ch32_halt_microprocessor(rvswd_handle_t *h) { (void)h; return RVSWD_OK; }
+rvswd_result_t ch32_resume_microprocessor(rvswd_handle_t *h) { (void)h; return RVSWD_OK; }
+rvswd_result_t ch32_reset_microprocessor_and_run(rvswd_handle_t *h) { (void)h; return RVSWD_OK; }
+bool ch32_read_memory_word(rvswd_handle_t *h, uint32_t a, uint32_t *v) { (void)h; (void)a; (void)v; return false; }
+bool ch32_write_memory_word(rvswd_handle_t *h, uint32_t a, uint32_t v) { (void)h; (void)a; (void)v; return false; }
+bool ch32_read_vendor_bytes(rvswd_handle_t *h, uint32_t v[4]) { (void)h; (void)v; return false; }
+bool ch32v20x_program(rvswd_handle_t *h, const uint8_t *f, size_t n, ch32v20x_status_callback cb) { (void)h; (void)f; (void)n; (void)cb; return false; }
+bool ch32v20x_unlock_flash(rvswd_handle_t *h) { (void)h; return false; }
+bool ch32v20x_lock_flash(rvswd_handle_t *h) { (void)h; return false; }
+bool ch32v20x_write_flash(rvswd_handle_t *h, uint32_t a, const uint8_t *d, size_t n, ch32v20x_status_callback cb) { (void)h; (void)a; (void)d; (void)n; (void)cb; return false; }
+bool ch32v20x_clear_running_operations(rvswd_handle_t *h) { (void)h; return false; }
+bool ch32x03x_program(rvswd_handle_t *h, const uint8_t *f, size_t n, ch32x03x_status_callback cb) { (void)h; (void)f; (void)n; (void)cb; return false; }
+bool ch32x03x_unlock_flash(rvswd_handle_t *h) { (void)h; return false; }
+bool ch32x03x_lock_flash(rvswd_handle_t *h) { (void)h; return false; }
+bool ch32x03x_write_flash(rvswd_handle_t *h, uint32_t a, const uint8_t *d, size_t n, ch32x03x_status_callback cb) { (void)h; (void)a; (void)d; (void)n; (void)cb; return false; }
+bool ch32x03x_clear_running_operations(rvswd_handle_t *h) { (void)h; return false; }
+
+// ---------------------------------------------------------------------------
+// Tests
+// ---------------------------------------------------------------------------
+
+static int failures;
+
+#define CHECK(cond) do { \
+        if (!(cond)) { \
+            fprintf(stderr, "%s:%d: %s: check failed: %s\n", __FILE__, __LINE__, __func__, #cond); \
+            failures++; \
+        } \
+} while (0)
+
+// Evaluates call and stores the exception type it raised, or NULL.
+#define CALL_RAISES(call, type_out) do { \
+        jmp_buf env; \
+        raise_target = &env; \
+        raised_type = NULL; \
+        if (setjmp(env) == 0) { \
+            (void)(call); \
+        } \
+        raise_target = NULL; \
+        (type_out) = raised_type; \
+} while (0)
+
+static mp_obj_t prog;
+
+static void reset_target(void) {
+    srand(1);
+    for (size_t i = 0; i < RAM_SIZE; i++) {
+        ram[i] = (uint8_t)rand();
+    }
+    memset(gpr, 0, sizeof(gpr));
+    dm_data0 = dm_data1 = dm_command = dm_abstractauto = dm_cmderr = 0;
+    transfers = 0;
+    obj_pool_used = 0;
+    mp_obj_t args[2] = { MP_OBJ_NEW_SMALL_INT(39), MP_OBJ_NEW_SMALL_INT(42) };
+    prog = rvswd_make_new(&rvswd_type, 2, 0, args);
+}
+
+static mp_obj_t int_obj(mp_int_t value) {
+    return MP_OBJ_NEW_SMALL_INT(value);
+}
+
+static mp_obj_t buffer_obj(void *buf, size_t len) {
+    mp_obj_t o = new_obj(FAKE_BUFFER);
+    o->buf = buf;
+    o->len = len;
+    return o;
+}
+
+static void test_readinto(void) {
+    static uint8_t out[4096 + 1];
+    reset_target();
+    // Unaligned host buffer: words are copied with memcpy()
+    mprvswd_readinto(prog, int_obj(RAM_BASE + 64), buffer_obj(out + 1, 4096));
+    CHECK(memcmp(out + 1, ram + 64, 4096) == 0);
+    // One RVSWD transfer per word plus a fixed setup cost
+    CHECK(transfers <= 1024 + 20);
+    CHECK(dm_abstractauto == 0);
+
+    // Single word, and a block ending at the last word of RAM: the last read
+    // must not make the target load past the end.
+    mprvswd_readinto(prog, int_obj(RAM_BASE + RAM_SIZE - 4), buffer_obj(out, 4));
+    CHECK(memcmp(out, ram + RAM_SIZE - 4, 4) == 0);
+    mprvswd_readinto(prog, int_obj(RAM_BASE + RAM_SIZE - 64), buffer_obj(out, 64));
+    CHECK(memcmp(out, ram + RAM_SIZE - 64, 64) == 0);
+    CHECK(dm_cmderr == 0);
+}
+
+static void test_write(void) {
+    static uint8_t in[4096];
+    reset_target();
+    for (size_t i = 0; i < sizeof(in); i++) {
+        in[i] = (uint8_t)(i * 7);
+    }
+    uint8_t before = ram[255], after = ram[256 + sizeof(in)];
+    mprvswd_write(prog, int_obj(RAM_BASE + 256), buffer_obj(in, sizeof(in)));
+    CHECK(memcmp(ram + 256, in, sizeof(in)) == 0);
+    CHECK(ram[255] == before);
+    CHECK(ram[256 + sizeof(in)] == after);
+    CHECK(transfers <= 1024 + 20);
+    CHECK(dm_abstractauto == 0);
+
+    uint8_t one[4] = { 1, 2, 3, 4 };
+    mprvswd_write(prog, int_obj(RAM_BASE + 8), buffer_obj(one, 4));
+    CHECK(memcmp(ram + 8, one, 4) == 0);
+}
+
+static void test_checksum_and_verify(void) {
+    reset_target();
+    uint32_t expected[2];
+    checksum_words(ram + 256, 4096, expected);
+    mp_obj_t sums = mprvswd_checksum(prog, int_obj(RAM_BASE + 256), int_obj(4096));
+    CHECK(sums->kind == FAKE_TUPLE && sums->len == 2);
+    CHECK((uint32_t)mp_obj_get_int(sums->items[0]) == expected[0]);
+    CHECK((uint32_t)mp_obj_get_int(sums->items[1]) == expected[1]);
+    // The target does the work: a handful of transfers, not one per word
+    CHECK(transfers < 40);
+
+    static uint8_t copy[4096];
+    memcpy(copy, ram + 256, sizeof(copy));
+    CHECK(mprvswd_verify(prog, int_obj(RAM_BASE + 256), buffer_obj(copy, sizeof(copy))) == &fake_true_obj);
+
+    // Swapped words keep the plain sum but not the running one
+    uint8_t word[4];
+    memcpy(word, ram + 256, 4);
+    memcpy(ram + 256, ram + 260, 4);
+    memcpy(ram + 260, word, 4);
+    CHECK(mprvswd_verify(prog, int_obj(RAM_BASE + 256), buffer_obj(copy, sizeof(copy))) == &fake_false_obj);
+
+    // A trailing partial word is compared against erased (0xff) padding
+    memset(ram + 0x1000, 0xff, 8);
+    memcpy(ram + 0x1000, "abcde", 5);
+    CHECK(mprvswd_verify(prog, int_obj(RAM_BASE + 0x1000), buffer_obj("abcde", 5)) == &fake_true_obj);
+    ram[0x1005] = 0;
+    CHECK(mprvswd_verify(prog, int_obj(RAM_BASE + 0x1000), buffer_obj("abcde", 5)) == &fake_false_obj);
+}
+
+static void test_errors(void) {
+    uint8_t buf[8] = { 0 };
+    const mp_obj_type_t *raised;
+    reset_target();
+
+    CALL_RAISES(mprvswd_readinto(prog, int_obj(RAM_BASE + 2), buffer_obj(buf, 8)), raised);
+    CHECK(raised == &mp_type_ValueError);
+    CALL_RAISES(mprvswd_write(prog, int_obj(RAM_BASE), buffer_obj(buf, 6)), raised);
+    CHECK(raised == &mp_type_ValueError);
+    CALL_RAISES(mprvswd_checksum(prog, int_obj(RAM_BASE), int_obj(5)), raised);
+    CHECK(raised == &mp_type_ValueError);
+    CHECK(transfers == 0);
+
+    // A load fault on the target surfaces as RuntimeError and the error is
+    // cleared for the next command.
+    CALL_RAISES(mprvswd_readinto(prog, int_obj(0x10000000), buffer_obj(buf, 8)), raised);
+    CHECK(raised == &mp_type_RuntimeError);
+    CHECK(dm_cmderr == 0);
+    CHECK(dm_abstractauto == 0);
+    mprvswd_readinto(prog, int_obj(RAM_BASE), buffer_obj(buf, 8));
+    CHECK(memcmp(buf, ram, 8) == 0);
+}
+
+int main(void) {
+    test_readinto();
+    test_write();
+    test_checksum_and_verify();
+    test_errors();
+    if (failures) {
+        printf("test_rvswd_module: %d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("test_rvswd_module: OK\n");
+    return 0;
+}
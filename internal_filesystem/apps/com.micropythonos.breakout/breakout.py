@@ -4,6 +4,12 @@
 # and flushes them sequentially using a flush-ready IRQ callback. A scheduled
 # (non-IRQ) handler advances chunks so it can work on larger-than-320x230
 # displays without requiring a full-size framebuffer.
+#
+# Native modules that have step()/render_rect() report which rectangles
+# changed each frame (ball, paddle, hit bricks), so only those are rendered
+# and sent; a level change still redraws the whole screen in chunks.
+import logging
+
 import lvgl as lv
 import mpos.ui
 from mpos import Activity, InputManager, SharedPreferences
@@ -14,6 +20,13 @@ if sys.platform == "esp32":
 else:
     import breakout_x64 as breakout
 
+logger = logging.getLogger(__name__)
+
+# Older builds of the native module only render whole-width slices
+_DIRTY_RECTS = hasattr(breakout, "step")
+if not _DIRTY_RECTS:
+    logger.warning("native module predates step(), rebuild it with c_mpos/breakout/build.sh; sending full frames")
+
 
 class Breakout(Activity):
 
@@ -204,6 +217,19 @@ class Breakout(Activity):
 
         self.render_next = False
 
+        if _DIRTY_RECTS:
+            count = breakout.step()
+            if count <= 0:
+                self.render_next = True
+                return
+            self.chunk_index = 0
+            self.chunk_total = count
+            self.chunk_in_progress = True
+            self.chunk_waiting = False
+            self.flush_ready = False
+            self._render_and_send_chunk()
+            return
+
         buffer_len = len(mpos.ui.main_display._frame_buffer1)
         bytes_per_row = self.hor_res * 2
         if bytes_per_row <= 0:
@@ -239,6 +265,16 @@ class Breakout(Activity):
             self.render_next = True
             return
 
+        if _DIRTY_RECTS:
+            bounds = breakout.render_rect(self.chunk_index)
+            if bounds is None:
+                self.chunk_in_progress = False
+                self.render_next = True
+                return
+            self.chunk_waiting = True
+            self.send_rect(*bounds)
+            return
+
         y_offset = self.chunk_index * self.chunk_rows_per
         rows = min(self.chunk_rows_per, self.ver_res - y_offset)
 
@@ -247,20 +283,21 @@ class Breakout(Activity):
         self.send_to_display(y_offset, rows)
 
     def send_to_display(self, y_offset=0, rows=None):
-        x1 = 0
-        x2 = mpos.ui.main_display.get_horizontal_resolution() - 1
-        x2 = x2 + mpos.ui.main_display._offset_x
-        x1 = x1 + mpos.ui.main_display._offset_x
-
         if rows is None:
             rows = mpos.ui.main_display.get_vertical_resolution()
-        y1 = y_offset
-        y2 = y_offset + rows - 1
+        x2 = mpos.ui.main_display.get_horizontal_resolution() - 1
+        self.send_rect(0, y_offset, x2, y_offset + rows - 1)
+
+    def send_rect(self, x1, y1, x2, y2):
+        # Send the framebuffer, packed with the rectangle's width as stride,
+        # to the inclusive screen rectangle (x1, y1)-(x2, y2).
+        bytes_needed = (x2 - x1 + 1) * (y2 - y1 + 1) * 2
+        x1 = x1 + mpos.ui.main_display._offset_x
+        x2 = x2 + mpos.ui.main_display._offset_x
         y1 = y1 + mpos.ui.main_display._offset_y
         y2 = y2 + mpos.ui.main_display._offset_y
 
         cmd = mpos.ui.main_display._set_memory_location(x1, y1, x2, y2)
-        bytes_needed = rows * mpos.ui.main_display.get_horizontal_resolution() * 2
         data_view = memoryview(mpos.ui.main_display._frame_buffer1)[:bytes_needed]
 
         tx_last = True
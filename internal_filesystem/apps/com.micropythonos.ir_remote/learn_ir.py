@@ -1,6 +1,6 @@
 import lvgl as lv
 
-from mpos import Activity, IRManager
+from mpos import Activity, IRManager, ir_protocols
 
 try:
     from machine import Pin
@@ -30,6 +30,11 @@ class LearnIR(Activity):
 
     def onResume(self, screen):
         super().onResume(screen)
+        self.ir = None
+        if IRManager.start_capture():
+            # The RMT peripheral times the pulses, so no faster task handler needed
+            self.check_timer = lv.timer_create(self.check_capture, 100, None)
+            return
         import mpos.ui
         mpos.ui.change_task_handler(100) # needed for accurate timings
         if simulation_mode:
@@ -47,6 +52,7 @@ class LearnIR(Activity):
         if self.check_timer is not None:
             self.check_timer.delete()
             self.check_timer = None
+        IRManager.stop_capture()
         if getattr(self, "ir", None):
             try:
                 self.ir.close()
@@ -56,6 +62,18 @@ class LearnIR(Activity):
         import mpos.ui
         mpos.ui.change_task_handler() # back to default
 
+    def check_capture(self, args):
+        durations = IRManager.read_capture()
+        if not durations:
+            return
+        burst = list(durations)
+        print(burst)
+        self.add_data(burst)
+        result = ir_protocols.decode(durations)
+        if result:
+            protocol, data, addr, ctrl = result
+            self.add_data(f"{protocol}: Data 0x{data:02x} Addr 0x{addr:04x} Ctrl 0x{ctrl:02x}")
+
     def check_data(self, args):
         if self.ir.data is not None:
             print(self.ir.data)
@@ -1,6 +1,6 @@
 import lvgl as lv
 
-from mpos import Activity, IRManager
+from mpos import Activity, IRManager, ir_protocols
 from learn_blaster_ir import LearnBlasterIR  # noqa: F401
 from learn_tcl_ir import LearnTCLIR  # noqa: F401
 
@@ -20,6 +20,7 @@ class LearnNECIR(Activity):
 
     status = None
     screen = None
+    capture_timer = None
 
     def onCreate(self):
         self.screen = lv.obj()
@@ -29,6 +30,11 @@ class LearnNECIR(Activity):
 
     def onResume(self, screen):
         super().onResume(screen)
+        self.ir = None
+        if IRManager.start_capture():
+            # The RMT peripheral times the pulses, so no faster task handler needed
+            self.capture_timer = lv.timer_create(self._poll_capture, 50, None)
+            return
         import mpos.ui
         mpos.ui.change_task_handler(100) # needed for accurate timings
         if simulation_mode:
@@ -44,6 +50,11 @@ class LearnNECIR(Activity):
             self.ir = None
 
     def onPause(self, screen):
+        if self.capture_timer is not None:
+            self.capture_timer.delete()
+            self.capture_timer = None
+            IRManager.stop_capture()
+            return
         if getattr(self, "ir", None):
             try:
                 self.ir.close()
@@ -53,6 +64,11 @@ class LearnNECIR(Activity):
         import mpos.ui
         mpos.ui.change_task_handler() # back to default
 
+    def _poll_capture(self, timer):
+        durations = IRManager.read_capture()
+        if durations:
+            self._on_ir(*ir_protocols.decode_nec(durations))
+
     def _on_ir(self, data, addr, ctrl):
         if data < 0:
             line = "Repeat code."
@@ -1,6 +1,6 @@
 import lvgl as lv
 
-from mpos import Activity, IRManager
+from mpos import Activity, IRManager, ir_protocols
 
 try:
     from machine import Pin
@@ -76,6 +76,7 @@ class LearnTCLIR(Activity):
 
     status = None
     screen = None
+    capture_timer = None
 
     def onCreate(self):
         self.screen = lv.obj()
@@ -85,6 +86,11 @@ class LearnTCLIR(Activity):
 
     def onResume(self, screen):
         super().onResume(screen)
+        self.ir = None
+        if IRManager.start_capture():
+            # The RMT peripheral times the pulses, so no faster task handler needed
+            self.capture_timer = lv.timer_create(self._poll_capture, 50, None)
+            return
         import mpos.ui
 
         mpos.ui.change_task_handler(100)
@@ -99,6 +105,11 @@ class LearnTCLIR(Activity):
             self.ir = None
 
     def onPause(self, screen):
+        if self.capture_timer is not None:
+            self.capture_timer.delete()
+            self.capture_timer = None
+            IRManager.stop_capture()
+            return
         if getattr(self, "ir", None):
             try:
                 self.ir.close()
@@ -109,6 +120,11 @@ class LearnTCLIR(Activity):
 
         mpos.ui.change_task_handler()
 
+    def _poll_capture(self, timer):
+        durations = IRManager.read_capture()
+        if durations:
+            self._on_ir(*ir_protocols.decode_tcl(durations))
+
     def _on_ir(self, cmd, addr, ctrl):
         if cmd < 0:
             line = "Decode error."
@@ -117,12 +117,19 @@ class ShowBattery(Activity):
 
             # --- BATTERY VALUES ---
 
-            if self.clear_cache_checkbox.get_state() & lv.STATE.CHECKED:
-                # Get "real-time" values by clearing the cache before reading
-                BatteryManager.clear_cache()
-
-            voltage = BatteryManager.read_battery_voltage()
-            percent = BatteryManager.get_battery_percentage()
+            try:
+                if self.clear_cache_checkbox.get_state() & lv.STATE.CHECKED:
+                    # Get "real-time" values by measuring before reading; the
+                    # fresh reading replaces the background estimate
+                    BatteryManager.read_raw_adc(True)
+                voltage = BatteryManager.read_battery_voltage()
+                percent = BatteryManager.get_battery_percentage()
+                raw = BatteryManager.read_raw_adc()
+            except RuntimeError as e:
+                # ADC2 boards can't measure while WiFi is busy
+                self.lbl_battery.set_text(f"{lv.SYMBOL.WARNING} {e}")
+                self.lbl_battery.set_style_text_color(lv.palette_main(lv.PALETTE.RED), 0)
+                return
 
             if percent > 80:
                 symbol = lv.SYMBOL.BATTERY_FULL
@@ -142,7 +149,11 @@ class ShowBattery(Activity):
                 bg_color = lv.PALETTE.RED
             self.lbl_battery.set_style_text_color(lv.palette_main(bg_color), 0)
 
-            self.lbl_battery_raw.set_text(f"Raw ADC: {BatteryManager.read_raw_adc()}")
+            age_ms = BatteryManager.estimate_age_ms()
+            if age_ms is None:
+                self.lbl_battery_raw.set_text(f"Raw ADC: {raw}")
+            else:
+                self.lbl_battery_raw.set_text(f"Raw ADC: {raw} (measured {age_ms // 1000}s ago)")
 
             # --- HISTORY GRAPH ---
             self.history_v.append(voltage)
@@ -5,6 +5,8 @@ import os
 import random
 import time
 
+from sorter_levels import LevelGenerator, apply_move, can_move, is_solved, make_lcg
+
 
 _EMOJI_FS_DIR = "builtin/res/emojis/32x32"
 _EMOJI_DIR = "M:" + _EMOJI_FS_DIR + "/"
@@ -27,6 +29,12 @@ _MAX_FILLED = 7
 _MAX_CAPACITY = 5
 _MAX_LEVEL = 100
 
+# Levels generated ahead in the background and kept in the app's prefs, and
+# how many solver states each background tick may expand.
+_LEVELS_AHEAD = 3
+_PRECOMPUTE_BUDGET = 150
+_PRECOMPUTE_PERIOD_MS = 20
+
 # RTTTL sound cues for buzzer output.
 _RTTTL_SELECT = "SortSel:d=16,o=7,b=250:8c"
 _RTTTL_MOVE = "SortMove:d=16,o=6,b=250:8e"
@@ -48,144 +56,6 @@ def _generate_emoji_order():
     return order[:count]
 
 
-def _top_run(tube):
-    if not tube:
-        return 0, None
-    top = tube[-1]
-    count = 0
-    for i in range(len(tube) - 1, -1, -1):
-        if tube[i] != top:
-            break
-        count += 1
-    return count, top
-
-
-def _can_move(source, target, capacity):
-    if not source:
-        return False
-    if len(target) >= capacity:
-        return False
-    count, top = _top_run(source)
-    if not target:
-        return True
-    tgt_count, tgt_top = _top_run(target)
-    return top == tgt_top
-
-
-def _apply_move(source, target, capacity):
-    count, top = _top_run(source)
-    if not target:
-        move = min(count, capacity - len(target))
-    else:
-        tgt_count, tgt_top = _top_run(target)
-        if top != tgt_top:
-            return
-        move = min(count, capacity - len(target))
-    for _ in range(move):
-        target.append(source.pop())
-
-
-def _is_solved(tubes):
-    """True when every color is fully gathered in one tube.
-
-    Each non-empty tube must be uniform and no color may be split across
-    multiple tubes. Empty tubes are allowed.
-    """
-    seen = set()
-    for tube in tubes:
-        if not tube:
-            continue
-        color = tube[0]
-        for item in tube:
-            if item != color:
-                return False
-        if color in seen:
-            return False
-        seen.add(color)
-    return True
-
-
-def _make_lcg(seed):
-    state = seed & 0x7FFFFFFF
-
-    def rand():
-        nonlocal state
-        state = (state * 1103515245 + 12345) & 0x7FFFFFFF
-        return state
-
-    return rand
-
-
-def _shuffle_seeded(lst, rand_int):
-    for i in range(len(lst) - 1, 0, -1):
-        j = rand_int() % (i + 1)
-        lst[i], lst[j] = lst[j], lst[i]
-
-
-def _solve_path(tubes, capacity, max_states):
-    if _is_solved(tubes):
-        return []
-    start = tuple(tuple(t) for t in tubes)
-    parent = {start: (None, None, None)}
-    queue = [start]
-    idx = 0
-    while idx < len(queue) and len(parent) < max_states:
-        state = queue[idx]
-        idx += 1
-        current = [list(t) for t in state]
-        for i, src in enumerate(current):
-            if not src:
-                continue
-            for j, tgt in enumerate(current):
-                if i == j:
-                    continue
-                if _can_move(src, tgt, capacity):
-                    new_tubes = [list(t) for t in state]
-                    _apply_move(new_tubes[i], new_tubes[j], capacity)
-                    new_state = tuple(tuple(t) for t in new_tubes)
-                    if new_state not in parent:
-                        parent[new_state] = (state, i, j)
-                        if _is_solved(new_tubes):
-                            path = [(i, j)]
-                            cur = state
-                            while parent[cur][0] is not None:
-                                _, s, t = parent[cur]
-                                path.append((s, t))
-                                cur = parent[cur][0]
-                            path.reverse()
-                            return path
-                        queue.append(new_state)
-    return []
-
-
-def _generate_level(filled, capacity, extra, rand_int, max_retries=30, progress_cb=None):
-    balls = []
-    for i in range(filled):
-        balls.extend([i] * capacity)
-
-    num_tubes = filled + extra
-    max_states = filled * 5000
-
-    for attempt in range(1, max_retries + 1):
-        if progress_cb:
-            progress_cb(attempt)
-        _shuffle_seeded(balls, rand_int)
-        tubes = []
-        pos = 0
-        for _ in range(filled):
-            tubes.append(list(balls[pos:pos + capacity]))
-            pos += capacity
-        for _ in range(extra):
-            tubes.append([])
-        if _is_solved(tubes):
-            continue
-        solution = _solve_path(tubes, capacity, max_states)
-        if solution:
-            return tubes, solution
-
-    return tubes, []
-
-
 def _level_params(level):
     level = max(1, min(level, _MAX_LEVEL))
     filled = min(_MAX_FILLED, _LEVEL1_FILLED + (level - 1) // _FILLED_STEP_EVERY)
@@ -194,6 +64,20 @@ def _level_params(level):
     return filled, capacity, extra
 
 
+def _order_seed(emoji_order):
+    s = 0
+    for val in emoji_order:
+        s = (s * 31 + val) & 0x7FFFFFFF
+    return s
+
+
+def _level_generator(seed, level, progress_cb=None):
+    """Generator for a level; the same seed and level always give the same level."""
+    filled, capacity, extra = _level_params(level)
+    return LevelGenerator(filled, capacity, extra, make_lcg(seed + level * 10007),
+                          progress_cb=progress_cb)
+
+
 class Sorter(Activity):
     TUBE_BORDER = lv.color_hex(0x5D6D7E)
 
@@ -221,7 +105,10 @@ class Sorter(Activity):
         self.emoji_order = []
         self.shuffle_moves = []
         self._anim = None
+        self._pregen = None
+        self._pregen_timer = None
         self.prefs = SharedPreferences(self.appFullName)
+        self._load_level_cache()
         self.highscore = self.prefs.get_int("highscore", 0)
         self.sound_effects = self._load_sound_effects()
         self.create_ui()
@@ -240,11 +127,23 @@ class Sorter(Activity):
         self.capacity = capacity
         self.moves = 0
         self.selected = -1
-        s = 0
-        for val in self.emoji_order:
-            s = (s * 31 + val) & 0x7FFFFFFF
-        rand = _make_lcg(s + self.level * 10007)
+        seed = _order_seed(self.emoji_order)
+        if seed != self._cache_seed:
+            self._cache_seed = seed
+            self._cached_levels = {}
+            self._pregen = None
+
+        cached = self._cached_levels.get(str(self.level))
+        if cached:
+            self.tubes = [list(t) for t in cached["tubes"]]
+            self.shuffle_moves = [tuple(m) for m in cached["moves"]]
+        else:
+            self.tubes, self.shuffle_moves = self._generate_now(seed)
+        self.initial_tubes = [list(t) for t in self.tubes]
+        self._start_precompute()
 
+    def _generate_now(self, seed):
+        """Generate the current level in the foreground, behind an overlay."""
         overlay = lv.obj(lv.layer_top())
         overlay.set_size(lv.pct(100), lv.pct(100))
         overlay.set_style_bg_opa(lv.OPA._20, 0)
@@ -259,17 +158,62 @@ class Sorter(Activity):
             label.set_text(f"Generating level, attempt {n}...")
             lv.timer_handler()
 
-        self.tubes, self.shuffle_moves = _generate_level(
-            filled, capacity, extra, rand, progress_cb=on_attempt
-        )
-        self.initial_tubes = [list(t) for t in self.tubes]
-
-        if not self.shuffle_moves:
-            label.set_text("Could not generate a solvable level!")
-            lv.timer_handler()
-            time.sleep(2)
+        # Finish the background run if it was already working on this level
+        pregen = self._pregen
+        self._pregen = None
+        if pregen and pregen[0] == seed and pregen[1] == self.level:
+            gen = pregen[2]
+            gen.progress_cb = on_attempt
+        else:
+            gen = _level_generator(seed, self.level, progress_cb=on_attempt)
+        try:
+            return gen.run()
+        finally:
+            overlay.delete()
+
+    # Levels ahead of the current one are generated a few solver states per
+    # timer tick and kept in prefs, so winning a level never waits on the solver.
+
+    def _load_level_cache(self):
+        cache = self.prefs.get_dict("level_cache")
+        self._cache_seed = cache.get("seed")
+        self._cached_levels = cache.get("levels") or {}
+
+    def _store_level(self, level, tubes, moves):
+        levels = {}
+        for key, value in self._cached_levels.items():
+            if self.level <= int(key) <= self.level + _LEVELS_AHEAD:
+                levels[key] = value
+        levels[str(level)] = {"tubes": tubes, "moves": [list(m) for m in moves]}
+        self._cached_levels = levels
+        editor = SharedPreferences(self.appFullName).edit()
+        editor.put_dict("level_cache", {"seed": self._cache_seed, "levels": levels})
+        editor.commit()
 
-        overlay.delete()
+    def _start_precompute(self):
+        if self._pregen_timer is None:
+            self._pregen_timer = lv.timer_create(self._precompute_tick, _PRECOMPUTE_PERIOD_MS, None)
+
+    def _stop_precompute(self):
+        if self._pregen_timer:
+            self._pregen_timer.delete()
+            self._pregen_timer = None
+        self._pregen = None
+
+    def _precompute_tick(self, timer):
+        if self._pregen is None:
+            for level in range(self.level + 1, self.level + 1 + _LEVELS_AHEAD):
+                if str(level) not in self._cached_levels:
+                    self._pregen = (self._cache_seed, level, _level_generator(self._cache_seed, level))
+                    break
+            else:
+                self._stop_precompute()
+                return
+        seed, level, gen = self._pregen
+        if gen.step(_PRECOMPUTE_BUDGET):
+            self._pregen = None
+            if seed == self._cache_seed:
+                self._store_level(level, gen.tubes, gen.solution)
 
     def create_ui(self):
         self.score_best_label = lv.label(self.screen)
@@ -623,16 +567,16 @@ class Sorter(Activity):
 
         src = self.tubes[self.selected]
         tgt = self.tubes[idx]
-        if _can_move(src, tgt, self.capacity):
+        if can_move(src, tgt, self.capacity):
             self._last_ts = now
-            _apply_move(src, tgt, self.capacity)
+            apply_move(src, tgt, self.capacity)
             self.moves += 1
             self.selected = -1
             self._play_rtttl(_RTTTL_MOVE)
             self.build_board()
             self._restore_focus(idx)
             self.refresh_labels()
-            if _is_solved(self.tubes):
+            if is_solved(self.tubes):
                 self.on_win()
         else:
             self._animate_top_emoji(self.selected, False)
@@ -697,6 +641,7 @@ class Sorter(Activity):
         self.refresh_labels()
 
     def onDestroy(self, screen):
+        self._stop_precompute()
         self._autosave()
         self._save_highscore()
         self._close_popup()
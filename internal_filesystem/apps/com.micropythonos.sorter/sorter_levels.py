@@ -0,0 +1,343 @@
+"""
+Level generation and solving for Emoji Sort, kept free of LVGL so it can be
+tested headless.
+
+Tubes are lists of color indices, bottom first. The solver packs each tube
+into an int with 3 bits per slot (color + 1, 0 = empty), so a state is a
+handful of small ints and a move is a few shifts and masks. Tubes are
+interchangeable, so states are deduplicated on the sorted tube codes, which
+makes the breadth-first search visit each arrangement once no matter which
+tube holds which stack.
+
+The search runs in bounded steps (LevelGenerator.step()) so levels can be
+generated ahead of time from an lv.timer without blocking the UI.
+"""
+
+_BITS = 3
+_MASK = 7
+_MAX_COLORS = 7
+
+
+# ----------------------------------------------------------------------
+# List based helpers, used by the game for the tubes on screen
+# ----------------------------------------------------------------------
+
+def top_run(tube):
+    if not tube:
+        return 0, None
+    top = tube[-1]
+    count = 0
+    for i in range(len(tube) - 1, -1, -1):
+        if tube[i] != top:
+            break
+        count += 1
+    return count, top
+
+
+def can_move(source, target, capacity):
+    if not source:
+        return False
+    if len(target) >= capacity:
+        return False
+    count, top = top_run(source)
+    if not target:
+        return True
+    tgt_count, tgt_top = top_run(target)
+    return top == tgt_top
+
+
+def apply_move(source, target, capacity):
+    count, top = top_run(source)
+    if not target:
+        move = min(count, capacity - len(target))
+    else:
+        tgt_count, tgt_top = top_run(target)
+        if top != tgt_top:
+            return
+        move = min(count, capacity - len(target))
+    for _ in range(move):
+        target.append(source.pop())
+
+
+def is_solved(tubes):
+    """True when every color is fully gathered in one tube.
+
+    Each non-empty tube must be uniform and no color may be split across
+    multiple tubes. Empty tubes are allowed.
+    """
+    seen = set()
+    for tube in tubes:
+        if not tube:
+            continue
+        color = tube[0]
+        for item in tube:
+            if item != color:
+                return False
+        if color in seen:
+            return False
+        seen.add(color)
+    return True
+
+
+def make_lcg(seed):
+    state = seed & 0x7FFFFFFF
+
+    def rand():
+        nonlocal state
+        state = (state * 1103515245 + 12345) & 0x7FFFFFFF
+        return state
+
+    return rand
+
+
+def shuffle_seeded(lst, rand_int):
+    for i in range(len(lst) - 1, 0, -1):
+        j = rand_int() % (i + 1)
+        lst[i], lst[j] = lst[j], lst[i]
+
+
+# ----------------------------------------------------------------------
+# Packed solver
+# ----------------------------------------------------------------------
+
+def tube_code(tube):
+    code = 0
+    for k, color in enumerate(tube):
+        code |= (color + 1) << (_BITS * k)
+    return code
+
+
+class Solver:
+    """
+    Breadth-first search for the shortest solution, expanding at most
+    `budget` states per step() call. When done, path holds the list of
+    (source, target) tube index moves, or [] if no solution was found within
+    max_states distinct states.
+    """
+
+    def __init__(self, tubes, capacity, max_states):
+        n = len(tubes)
+        self.capacity = capacity
+        self.max_states = max_states
+        self.path = []
+        self.done = False
+        self._n = n
+        self._shift = _BITS * capacity
+        self._tube_mask = (1 << self._shift) - 1
+        # _runs[c][k]: k balls of color digit c stacked from slot 0
+        self._runs = [[0] * (capacity + 1) for _ in range(_MAX_COLORS + 1)]
+        for c in range(1, _MAX_COLORS + 1):
+            for k in range(1, capacity + 1):
+                self._runs[c][k] = self._runs[c][k - 1] | (c << (_BITS * (k - 1)))
+        self._full = set(self._runs[c][capacity] for c in range(1, _MAX_COLORS + 1))
+        self._full.add(0)
+
+        # Scratch lists reused for every expanded state
+        self._codes = [0] * n
+        self._lens = [0] * n
+        self._sorted = [0] * n
+
+        codes = [tube_code(t) for t in tubes]
+        if self._unsolved(codes) == 0:
+            self.done = True
+            return
+        start = self._pack(codes)
+        self._parent = {self._canonical(codes): None}
+        self._queue = [(start, self._unsolved(codes))]
+        self._idx = 0
+
+    def _unsolved(self, codes):
+        full = self._full
+        return sum(1 for c in codes if c not in full)
+
+    def _pack(self, codes):
+        key = 0
+        shift = 0
+        for c in codes:
+            key |= c << shift
+            shift += self._shift
+        return key
+
+    def _canonical(self, codes):
+        s = self._sorted
+        for k in range(self._n):
+            s[k] = codes[k]
+        s.sort()
+        return self._pack(s)
+
+    def _finish(self, key):
+        path = []
+        entry = self._parent[key]
+        while entry is not None:
+            key, i, j = entry
+            path.append((i, j))
+            entry = self._parent[key]
+        path.reverse()
+        self.path = path
+        self.done = True
+
+    def step(self, budget):
+        """Expand up to budget states. Returns the number of states expanded."""
+        if self.done:
+            return 0
+        n = self._n
+        cap = self.capacity
+        shift = self._shift
+        tube_mask = self._tube_mask
+        runs = self._runs
+        full = self._full
+        parent = self._parent
+        queue = self._queue
+        codes = self._codes
+        lens = self._lens
+        expanded = 0
+        while expanded < budget:
+            if self._idx >= len(queue) or len(parent) >= self.max_states:
+                self._parent = self._queue = None
+                self.done = True
+                break
+            state, unsolved = queue[self._idx]
+            queue[self._idx] = None
+            self._idx += 1
+            expanded += 1
+
+            for k in range(n):
+                c = (state >> (shift * k)) & tube_mask
+                codes[k] = c
+                length = 0
+                while c:
+                    length += 1
+                    c >>= _BITS
+                lens[k] = length
+            key = self._canonical(codes)
+
+            for i in range(n):
+                li = lens[i]
+                if not li:
+                    continue
+                ci = codes[i]
+                top = (ci >> (_BITS * (li - 1))) & _MASK
+                run = 1
+                while run < li and ((ci >> (_BITS * (li - 1 - run))) & _MASK) == top:
+                    run += 1
+                tried_empty = False
+                for j in range(n):
+                    if j == i:
+                        continue
+                    lj = lens[j]
+                    if lj == cap:
+                        continue
+                    cj = codes[j]
+                    if lj == 0:
+                        # All empty tubes are equivalent, and moving a whole
+                        # uniform tube into one changes nothing
+                        if tried_empty or run == li:
+                            continue
+                        tried_empty = True
+                    elif ((cj >> (_BITS * (lj - 1))) & _MASK) != top:
+                        continue
+                    k = run if run < cap - lj else cap - lj
+                    new_ci = ci & ((1 << (_BITS * (li - k))) - 1)
+                    new_cj = cj | (runs[top][k] << (_BITS * lj))
+
+                    codes[i] = new_ci
+                    codes[j] = new_cj
+                    new_key = self._canonical(codes)
+                    codes[i] = ci
+                    codes[j] = cj
+                    if new_key in parent:
+                        continue
+                    new_unsolved = unsolved
+                    new_unsolved -= (ci not in full) + (cj not in full)
+                    new_unsolved += (new_ci not in full) + (new_cj not in full)
+                    parent[new_key] = (key, i, j)
+                    if new_unsolved == 0:
+                        self._finish(new_key)
+                        self._parent = self._queue = None
+                        return expanded
+                    new_state = state ^ ((ci ^ new_ci) << (shift * i)) ^ ((cj ^ new_cj) << (shift * j))
+                    queue.append((new_state, new_unsolved))
+        return expanded
+
+
+def solve_path(tubes, capacity, max_states):
+    """Shortest list of (source, target) moves that solves tubes, or []."""
+    solver = Solver(tubes, capacity, max_states)
+    while not solver.done:
+        solver.step(max_states)
+    return solver.path
+
+
+# ----------------------------------------------------------------------
+# Level generation
+# ----------------------------------------------------------------------
+
+class LevelGenerator:
+    """
+    Shuffles levels from rand_int until one is solvable, in bounded steps.
+
+    step(budget) spends at most about budget solver states and returns True
+    once done; tubes and solution then hold the level ([] if no solvable
+    shuffle was found within max_retries).
+    """
+
+    def __init__(self, filled, capacity, extra, rand_int, max_retries=30, progress_cb=None):
+        if filled > _MAX_COLORS:
+            raise ValueError("at most %d colors" % _MAX_COLORS)
+        self.filled = filled
+        self.capacity = capacity
+        self.extra = extra
+        self.rand_int = rand_int
+        self.max_retries = max_retries
+        self.progress_cb = progress_cb
+        self.max_states = filled * 5000
+        self.attempt = 0
+        self.tubes = []
+        self.solution = []
+        self.done = False
+        self._balls = []
+        for i in range(filled):
+            self._balls.extend([i] * capacity)
+        self._solver = None
+
+    def _next_shuffle(self):
+        self.attempt += 1
+        if self.progress_cb:
+            self.progress_cb(self.attempt)
+        balls = self._balls
+        shuffle_seeded(balls, self.rand_int)
+        cap = self.capacity
+        tubes = []
+        for k in range(self.filled):
+            tubes.append(balls[k * cap:(k + 1) * cap])
+        for _ in range(self.extra):
+            tubes.append([])
+        self.tubes = tubes
+
+    def step(self, budget):
+        while budget > 0 and not self.done:
+            if self._solver is None:
+                if self.attempt >= self.max_retries:
+                    self.done = True
+                    break
+                self._next_shuffle()
+                if is_solved(self.tubes):
+                    continue
+                self._solver = Solver(self.tubes, self.capacity, self.max_states)
+            budget -= max(1, self._solver.step(budget))
+            if self._solver.done:
+                if self._solver.path:
+                    self.solution = self._solver.path
+                    self.done = True
+                self._solver = None
+        return self.done
+
+    def run(self):
+        while not self.step(self.max_states):
+            pass
+        return self.tubes, self.solution
+
+
+def generate_level(filled, capacity, extra, rand_int, max_retries=30, progress_cb=None):
+    """Return (tubes, solution) for a solvable shuffle, see LevelGenerator."""
+    return LevelGenerator(filled, capacity, extra, rand_int, max_retries, progress_cb).run()
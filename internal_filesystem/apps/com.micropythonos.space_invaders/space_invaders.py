@@ -1,4 +1,5 @@
 from mpos import Activity, DisplayMetrics, InputManager, SharedPreferences
+from mpos.ui.sprites import SpriteLayer
 import random
 import time
 import lvgl as lv
@@ -139,12 +140,14 @@ class SpaceInvaders(Activity):
         self.player_x = 0
         self.player_dir = 0
         self._player_dir_until = 0
-        self.player_canvas = None
+        self.sprites = None
+        self.player_sprite = None
 
         self.invaders = []
         self.bullets = []
         self.enemy_bullets = []
-        self.invader_canvases = []
+        self.invader_sprites = []
+        self.invader_bitmaps = []
         self.bullet_pool = []
         self.enemy_bullet_pool = []
         self.explosion_pool = []
@@ -292,82 +295,34 @@ class SpaceInvaders(Activity):
         self._player_speed = self.ga_w * 0.55
         self._bullet_speed = self.ga_h * 0.9
 
-    def _make_sprite(self, parent, pixel_data, w, h, color):
-        canvas = lv.canvas(parent)
-        canvas.set_size(w, h)
-        buf = bytearray(w * h * 4)
-        canvas.set_buffer(buf, w, h, lv.COLOR_FORMAT.NATIVE)
-        canvas.set_style_border_width(0, 0)
-        canvas.set_style_bg_opa(lv.OPA.TRANSP, 0)
-
-        for y, row in enumerate(pixel_data):
-            if y >= h:
-                break
-            for x, ch in enumerate(row):
-                if x >= w:
-                    break
-                if ch == "#":
-                    canvas.set_px(x, y, color, lv.OPA.COVER)
-        return canvas
-
     def _create_entity_pools(self):
+        # Every invader, bullet and explosion is a sprite of one layer,
+        # drawn in a single pass; stacking follows the order they're added.
         max_invaders = COLS * 5
-        templates = [
-            (INVADER_A_TEMPLATE, _G),
-            (INVADER_B_TEMPLATE, _LG),
-            (INVADER_C_TEMPLATE, _P),
-        ]
+        layer = SpriteLayer(self.game_area, self.ga_w, self.ga_h, max_sprites=max_invaders + 21)
+        self.sprites = layer
 
-        self.invader_canvases = []
-        for i in range(max_invaders):
-            tmpl, col = templates[i % 3]
-            c = self._make_sprite(self.game_area, tmpl, SPRITE_W, SPRITE_H, col)
-            c.add_flag(lv.obj.FLAG.HIDDEN)
-            c.set_style_bg_opa(lv.OPA.TRANSP, 0)
-            self.invader_canvases.append(c)
+        self.invader_bitmaps = [
+            layer.add_bitmap(INVADER_A_TEMPLATE, _G, SPRITE_W, SPRITE_H),
+            layer.add_bitmap(INVADER_B_TEMPLATE, _LG, SPRITE_W, SPRITE_H),
+            layer.add_bitmap(INVADER_C_TEMPLATE, _P, SPRITE_W, SPRITE_H),
+        ]
+        self.invader_sprites = [
+            layer.add_sprite(self.invader_bitmaps[0]) for _ in range(max_invaders)
+        ]
 
-        self.player_canvas = self._make_sprite(
-            self.game_area, PLAYER_TEMPLATE, PLAYER_W, PLAYER_H, _C
+        self.player_sprite = layer.add_sprite(
+            layer.add_bitmap(PLAYER_TEMPLATE, _C, PLAYER_W, PLAYER_H)
         )
-        self.player_canvas.add_flag(lv.obj.FLAG.HIDDEN)
 
-        bullet_style = lv.style_t()
-        bullet_style.init()
-        bullet_style.set_bg_color(_Y)
-        bullet_style.set_bg_opa(lv.OPA.COVER)
-        bullet_style.set_border_width(0)
-        bullet_style.set_radius(2)
+        bullet = layer.add_rect(BULLET_W, BULLET_H, _Y, radius=2)
+        self.bullet_pool = [layer.add_sprite(bullet) for _ in range(8)]
 
-        self.bullet_pool = []
-        for _ in range(8):
-            b = lv.obj(self.game_area)
-            b.set_size(BULLET_W, BULLET_H)
-            b.add_style(bullet_style, 0)
-            b.add_flag(lv.obj.FLAG.HIDDEN)
-            self.bullet_pool.append(b)
-
-        enemy_style = lv.style_t()
-        enemy_style.init()
-        enemy_style.set_bg_color(_R)
-        enemy_style.set_bg_opa(lv.OPA.COVER)
-        enemy_style.set_border_width(0)
-        enemy_style.set_radius(4)
+        enemy_bullet = layer.add_rect(5, 10, _R, radius=4)
+        self.enemy_bullet_pool = [layer.add_sprite(enemy_bullet) for _ in range(8)]
 
-        self.enemy_bullet_pool = []
-        for _ in range(8):
-            b = lv.obj(self.game_area)
-            b.set_size(5, 10)
-            b.add_style(enemy_style, 0)
-            b.add_flag(lv.obj.FLAG.HIDDEN)
-            self.enemy_bullet_pool.append(b)
-
-        self.explosion_pool = []
-        for _ in range(4):
-            c = self._make_sprite(
-                self.game_area, EXPLOSION_TEMPLATE, SPRITE_W, SPRITE_H, _O
-            )
-            c.add_flag(lv.obj.FLAG.HIDDEN)
-            self.explosion_pool.append(c)
+        explosion = layer.add_bitmap(EXPLOSION_TEMPLATE, _O, SPRITE_W, SPRITE_H)
+        self.explosion_pool = [layer.add_sprite(explosion) for _ in range(4)]
 
     def _show_start_screen(self):
         self.game_state = "start"
@@ -459,7 +414,7 @@ class SpaceInvaders(Activity):
 
         self.player_x = self.ga_w // 2
         self.player_dir = 0
-        self.player_canvas.remove_flag(lv.obj.FLAG.HIDDEN)
+        self.sprites.show(self.player_sprite)
 
         self._update_entity_positions()
         self._update_labels()
@@ -480,44 +435,37 @@ class SpaceInvaders(Activity):
             i["y"] = self._invader_start_y + (i["row"] - min_row) * self._spacing_y
 
     def _update_entity_positions(self):
+        layer = self.sprites
         px = int(self.player_x - PLAYER_W // 2)
-        self.player_canvas.set_pos(
+        layer.move(
+            self.player_sprite,
             max(0, min(px, self.ga_w - PLAYER_W)), self.ga_h - PLAYER_H - 4
         )
 
         idx = 0
         for inv in self.invaders:
             if inv["alive"]:
-                c = self.invader_canvases[idx]
-                c.remove_flag(lv.obj.FLAG.HIDDEN)
-                c.set_pos(int(inv["x"]), int(inv["y"]))
+                s = self.invader_sprites[idx]
+                layer.set_bitmap(s, self.invader_bitmaps[inv["type"]])
+                layer.move(s, inv["x"], inv["y"])
+                layer.show(s)
                 idx += 1
-
-        for idx in range(idx, len(self.invader_canvases)):
-            self.invader_canvases[idx].add_flag(lv.obj.FLAG.HIDDEN)
-
-        for b in self.bullet_pool:
-            b.add_flag(lv.obj.FLAG.HIDDEN)
-        for i, b_data in enumerate(self.bullets):
-            if i < len(self.bullet_pool):
-                self.bullet_pool[i].remove_flag(lv.obj.FLAG.HIDDEN)
-                self.bullet_pool[i].set_pos(int(b_data["x"]), int(b_data["y"]))
-
-        for b in self.enemy_bullet_pool:
-            b.add_flag(lv.obj.FLAG.HIDDEN)
-        for i, b_data in enumerate(self.enemy_bullets):
-            if i < len(self.enemy_bullet_pool):
-                self.enemy_bullet_pool[i].remove_flag(lv.obj.FLAG.HIDDEN)
-                self.enemy_bullet_pool[i].set_pos(
-                    int(b_data["x"]), int(b_data["y"])
-                )
-
-        for e in self.explosion_pool:
-            e.add_flag(lv.obj.FLAG.HIDDEN)
-        for i, exp in enumerate(self.active_explosions):
-            if i < len(self.explosion_pool):
-                self.explosion_pool[i].remove_flag(lv.obj.FLAG.HIDDEN)
-                self.explosion_pool[i].set_pos(int(exp["x"]), int(exp["y"]))
+        for idx in range(idx, len(self.invader_sprites)):
+            layer.hide(self.invader_sprites[idx])
+
+        self._place_pool(self.bullet_pool, self.bullets)
+        self._place_pool(self.enemy_bullet_pool, self.enemy_bullets)
+        self._place_pool(self.explosion_pool, self.active_explosions)
+        layer.flush()
+
+    def _place_pool(self, pool, items):
+        layer = self.sprites
+        n = min(len(items), len(pool))
+        for i in range(n):
+            layer.move(pool[i], items[i]["x"], items[i]["y"])
+            layer.show(pool[i])
+        for i in range(n, len(pool)):
+            layer.hide(pool[i])
 
     def _update_labels(self):
         self.score_label.set_text("SCORE: " + str(self.score))
@@ -679,7 +627,7 @@ class SpaceInvaders(Activity):
         self._spawn_explosion(
             self.player_x - SPRITE_W // 2, self.ga_h - PLAYER_H - SPRITE_H
         )
-        self.player_canvas.add_flag(lv.obj.FLAG.HIDDEN)
+        self.sprites.hide(self.player_sprite)
         if self.lives <= 0:
             self.game_state = "game_over"
             self._on_game_over()
@@ -687,7 +635,7 @@ class SpaceInvaders(Activity):
             lv.timer_create(self._respawn_player, 1000, None).set_repeat_count(1)
 
     def _respawn_player(self, timer):
-        self.player_canvas.remove_flag(lv.obj.FLAG.HIDDEN)
+        self.sprites.show(self.player_sprite)
         self.player_x = self.ga_w // 2
 
     def _spawn_explosion(self, x, y):
@@ -739,7 +687,8 @@ class SpaceInvaders(Activity):
 
     def _on_game_over(self):
         self._save_highscore()
-        self.player_canvas.add_flag(lv.obj.FLAG.HIDDEN)
+        self.sprites.hide(self.player_sprite)
+        self.sprites.flush()
         self._close_cover_overlay()
         self._create_cover_overlay(
             " GAME OVER\n\nScore: "
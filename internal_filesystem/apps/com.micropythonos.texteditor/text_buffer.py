@@ -0,0 +1,242 @@
+"""
+Piece table backing store for the text editor.
+
+The document is described by a list of pieces, each a (source, offset,
+length) span of either the original file (read on demand from disk, never
+loaded whole) or the append-only add buffer that holds inserted text. Edits
+only touch the piece list and the add buffer, so a multi-hundred-kilobyte
+file costs a file handle plus whatever has actually been edited.
+
+Offsets are byte offsets into the UTF-8 document. The editor only shows a
+window of the document, cut at line boundaries (see window_end()), so the
+slices it reads always decode cleanly.
+
+A revision counter tracks dirtiness: every edit bumps it, saving records it.
+"""
+
+import os
+
+_ORIG = 0
+_ADD = 1
+
+_SCAN_CHUNK = 512
+
+
+class PieceTable:
+
+    def __init__(self, path=None):
+        self.path = None
+        self._file = None
+        self._pieces = []
+        self._add = bytearray()
+        self.length = 0
+        self.revision = 0
+        self.saved_revision = 0
+        if path is not None:
+            self._open(path)
+
+    def _open(self, path):
+        self.close()
+        f = open(path, "rb")
+        size = f.seek(0, 2)
+        self.path = path
+        self._file = f
+        self._pieces = [(_ORIG, 0, size)] if size else []
+        self._add = bytearray()
+        self.length = size
+
+    def close(self):
+        if self._file:
+            self._file.close()
+            self._file = None
+
+    @property
+    def dirty(self):
+        return self.revision != self.saved_revision
+
+    def mark_changed(self):
+        """Record an edit that hasn't been written into the table yet."""
+        self.revision += 1
+
+    # ------------------------------------------------------------------
+    # Reading
+    # ------------------------------------------------------------------
+
+    def read(self, start, n):
+        """Return n bytes of the document from byte offset start."""
+        out = bytearray()
+        pos = 0
+        end = start + n
+        for src, off, length in self._pieces:
+            if pos >= end:
+                break
+            if pos + length > start:
+                a = max(start - pos, 0)
+                b = min(end - pos, length)
+                if src == _ADD:
+                    out.extend(self._add[off + a:off + b])
+                else:
+                    self._file.seek(off + a)
+                    out.extend(self._file.read(b - a))
+            pos += length
+        return bytes(out)
+
+    def _chunks(self, start, end):
+        # Yield (offset, bytes) in _SCAN_CHUNK steps over [start, end)
+        while start < end:
+            n = min(_SCAN_CHUNK, end - start)
+            yield start, self.read(start, n)
+            start += n
+
+    def window_end(self, start, max_bytes):
+        """
+        End offset of a window starting at start and at most max_bytes long,
+        cut just after a newline when there is one, else at a UTF-8 character
+        boundary.
+        """
+        end = min(start + max_bytes, self.length)
+        if end == self.length:
+            return end
+        cut = -1
+        for off, data in self._chunks(start, end):
+            i = data.rfind(b"\n")
+            if i >= 0:
+                cut = off + i + 1
+        if cut > start:
+            return cut
+        end = self.char_start(end)
+        return end if end > start else min(start + max_bytes, self.length)
+
+    def char_start(self, pos):
+        """Move pos back off UTF-8 continuation bytes onto a character start."""
+        back = 0
+        while 0 < pos < self.length and back < 3 and (self.read(pos, 1)[0] & 0xC0) == 0x80:
+            pos -= 1
+            back += 1
+        return pos
+
+    def line_start_before(self, pos, max_back):
+        """
+        Start of the line containing pos, looking back at most max_back
+        bytes; a character boundary max_back bytes back if there is none.
+        """
+        lo = max(0, pos - max_back)
+        while pos > lo:
+            n = min(_SCAN_CHUNK, pos - lo)
+            data = self.read(pos - n, n)
+            i = data.rfind(b"\n")
+            if i >= 0:
+                return pos - n + i + 1
+            pos -= n
+        return self.char_start(lo)
+
+    # ------------------------------------------------------------------
+    # Editing
+    # ------------------------------------------------------------------
+
+    def replace(self, start, n, data):
+        """Replace n bytes at start with data (bytes)."""
+        end = start + n
+        pieces = []
+        pos = 0
+        inserted = False
+        for piece in self._pieces:
+            src, off, length = piece
+            p_end = pos + length
+            if p_end <= start or pos >= end:
+                if pos >= end and not inserted:
+                    self._append(pieces, data)
+                    inserted = True
+                pieces.append(piece)
+            else:
+                if pos < start:
+                    pieces.append((src, off, start - pos))
+                if not inserted:
+                    self._append(pieces, data)
+                    inserted = True
+                if p_end > end:
+                    pieces.append((src, off + end - pos, p_end - end))
+            pos = p_end
+        if not inserted:
+            self._append(pieces, data)
+        self._pieces = pieces
+        self.length += len(data) - n
+        self.revision += 1
+
+    def replace_changed(self, start, n, data):
+        """
+        Like replace(), but only the part of data that differs from the n
+        bytes at start is written, so committing a mostly unchanged window
+        adds just the edited span to the add buffer.
+        """
+        old = self.read(start, n)
+        limit = min(len(old), len(data))
+        prefix = 0
+        while prefix < limit and old[prefix] == data[prefix]:
+            prefix += 1
+        suffix = 0
+        limit -= prefix
+        while suffix < limit and old[-1 - suffix] == data[-1 - suffix]:
+            suffix += 1
+        if prefix == len(old) == len(data):
+            return
+        self.replace(start + prefix, n - prefix - suffix, data[prefix:len(data) - suffix])
+
+    def _append(self, pieces, data):
+        if data:
+            pieces.append((_ADD, len(self._add), len(data)))
+            self._add.extend(data)
+
+    # ------------------------------------------------------------------
+    # Saving
+    # ------------------------------------------------------------------
+
+    def save(self, path):
+        """
+        Stream the document to path and make that file the new original.
+        The previous original stays readable until the copy is complete, and
+        is kept as a backup until the copy has replaced it: if that fails the
+        backup is put back and the table keeps reading from it.
+        """
+        tmp = path + ".tmp"
+        with open(tmp, "wb") as out:
+            for src, off, length in self._pieces:
+                if src == _ADD:
+                    out.write(memoryview(self._add)[off:off + length])
+                else:
+                    f = self._file
+                    f.seek(off)
+                    while length:
+                        chunk = f.read(min(length, 4096))
+                        if not chunk:
+                            break
+                        out.write(chunk)
+                        length -= len(chunk)
+        orig = self.path
+        bak = path + ".bak"
+        self.close()
+        try:
+            os.remove(bak)
+        except OSError:
+            pass
+        try:
+            os.rename(path, bak)
+            backed_up = True
+        except OSError:
+            backed_up = False  # saving to a new file
+        try:
+            os.rename(tmp, path)
+        except OSError:
+            if backed_up:
+                os.rename(bak, path)
+            if orig is not None:
+                # The pieces still point into the original, so only reopen it
+                self._file = open(orig, "rb")
+            raise
+        self._open(path)
+        self.saved_revision = self.revision
+        if backed_up:
+            try:
+                os.remove(bak)
+            except OSError:
+                pass
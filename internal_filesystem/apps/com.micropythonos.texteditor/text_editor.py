@@ -5,6 +5,8 @@ import lvgl as lv
 
 from mpos import Activity, DisplayMetrics, InputActivity, Intent, MposKeyboard
 
+from text_buffer import PieceTable
+
 logger = logging.getLogger(__name__)
 
 
@@ -23,8 +25,18 @@ class TextEditor(Activity):
         ".ini",
     ]
 
+    # Bytes of the document held in the textarea at a time; the rest stays
+    # in the PieceTable (on disk for unedited parts).
+    _WINDOW_BYTES = 8192
+    # Scrolling to within this many pixels of the textarea's top/bottom
+    # edge slides the window.
+    _EDGE_PX = 8
+
     _filename = None
-    _saved_content = ""
+    _doc = None
+    _win_start = 0  # byte range of the document shown in the textarea
+    _win_end = 0
+    _win_dirty = False  # textarea edited since the window was loaded
     _loading = False
 
     _top_bar = None
@@ -85,6 +97,7 @@ class TextEditor(Activity):
         self._textarea.set_flex_grow(1)
         self._textarea.add_event_cb(self._on_text_changed, lv.EVENT.VALUE_CHANGED, None)
         self._textarea.add_event_cb(self._show_keyboard, lv.EVENT.CLICKED, None)
+        self._textarea.add_event_cb(self._on_scroll_end, lv.EVENT.SCROLL_END, None)
 
         self._keyboard = MposKeyboard(screen)
         self._keyboard.set_textarea(self._textarea)
@@ -101,14 +114,17 @@ class TextEditor(Activity):
         path = self.getIntent().extras.get("filename") or self.getIntent().data
         if path:
             self._load_file(path)
-        elif self._filename is None:
-            if self._textarea.get_text() == "" and self._saved_content == "":
-                self._new_file()
+        elif self._doc is None:
+            self._new_file()
         self._update_title()
 
     def onPause(self, screen):
         super().onPause(screen)
 
+    def onDestroy(self, screen):
+        if self._doc:
+            self._doc.close()
+
     def onBackPressed(self, screen):
         if self._exit_overlay:
             self._on_exit_cancel(self._exit_overlay)
@@ -135,34 +151,75 @@ class TextEditor(Activity):
         return name if name else path
 
     def _new_file(self):
-        self._filename = None
-        self._saved_content = ""
-        self._loading = True
-        try:
-            self._textarea.set_text("")
-        finally:
-            self._loading = False
-        self._update_title()
+        self._set_doc(PieceTable(), None)
 
     def _load_file(self, path):
         try:
-            with open(path, "r") as f:
-                content = f.read()
+            doc = PieceTable(path)
         except OSError as e:
             logger.error("TextEditor: failed to read %s: %s", path, e)
             self._new_file()
             return
+        self._set_doc(doc, path)
+
+    def _set_doc(self, doc, path):
+        if self._doc:
+            self._doc.close()
+        self._doc = doc
         self._filename = path
-        self._saved_content = content
+        self._show_window(0)
+        self._update_title()
+
+    def _show_window(self, start, cursor=None):
+        """Load the window starting at byte start into the textarea."""
+        doc = self._doc
+        end = doc.window_end(start, self._WINDOW_BYTES)
+        data = doc.read(start, end - start)
+        self._win_start = start
+        self._win_end = end
+        self._win_dirty = False
         self._loading = True
         try:
-            self._textarea.set_text(content)
+            self._textarea.set_text(data.decode())
         finally:
             self._loading = False
-        self._update_title()
+        if cursor is not None:
+            self._textarea.set_cursor_pos(len(data[:cursor - start].decode()))
+
+    def _commit_window(self):
+        """Write textarea edits back into the document."""
+        if not self._win_dirty:
+            return
+        data = self._textarea.get_text().encode()
+        self._doc.replace_changed(self._win_start, self._win_end - self._win_start, data)
+        self._win_end = self._win_start + len(data)
+        self._win_dirty = False
+
+    def _on_scroll_end(self, event):
+        ta = self._textarea
+        if self._win_end < self._doc.length and ta.get_scroll_bottom() <= self._EDGE_PX:
+            self._slide_window(True)
+        elif self._win_start > 0 and ta.get_scroll_y() <= self._EDGE_PX:
+            self._slide_window(False)
+
+    def _slide_window(self, forward):
+        # Move by about half a window, keeping the edge the user scrolled to
+        # in view by putting the cursor on it.
+        self._commit_window()
+        doc = self._doc
+        half = self._WINDOW_BYTES // 2
+        if forward:
+            anchor = self._win_end
+            start = doc.window_end(self._win_start, (self._win_end - self._win_start) // 2)
+        else:
+            anchor = self._win_start
+            start = 0
+            if anchor > half:
+                start = doc.line_start_before(anchor - half, half // 2)
+        self._show_window(start, anchor)
 
     def _has_unsaved_changes(self):
-        return self._textarea.get_text() != self._saved_content
+        return self._doc is not None and self._doc.dirty
 
     def _update_title(self):
         name = self._basename(self._filename) if self._filename else "Untitled"
@@ -173,7 +230,13 @@ class TextEditor(Activity):
     def _on_text_changed(self, event):
         if self._loading:
             return
-        self._update_title()
+        # O(1) per keystroke: the text is only compared/copied when the
+        # window is committed (on sliding or saving).
+        was_dirty = self._doc.dirty
+        self._doc.mark_changed()
+        self._win_dirty = True
+        if not was_dirty:
+            self._update_title()
 
     def _show_keyboard(self, event=None, textarea=None):
         ta = textarea or self._textarea
@@ -216,16 +279,14 @@ class TextEditor(Activity):
 
     def _perform_save(self, path):
         self._ensure_dir(self._default_dir_for(path))
-        content = self._textarea.get_text()
+        self._commit_window()
         try:
-            with open(path, "w") as f:
-                f.write(content)
+            self._doc.save(path)
         except OSError as e:
             logger.error("TextEditor: failed to write %s: %s", path, e)
             self._filename_label.set_text("Save failed")
             return
         self._filename = path
-        self._saved_content = content
         self._update_title()
 
     def _default_dir_for(self, path):
@@ -1,6 +1,7 @@
 import ssl
 import json
 import time
+from collections import deque
 
 import logging
 
@@ -13,6 +14,7 @@ from nostr.filter import Filter, Filters
 from nostr.event import Event, EncryptedDirectMessage
 from nostr.key import PrivateKey
 
+from .subscription_index import SubscriptionIndex
 
 logger = logging.getLogger(__name__)
 
@@ -247,8 +249,8 @@ class NostrManager:
         # LNBits (limit=) and on-chain (pageSize=) honour the user setting.
         self._nwc_list_limit = 21
 
-        # Nostr app state
-        self.events = []
+        # Nostr app state: a bounded window of the most recent events.
+        self.events = deque((), self.EVENTS_TO_SHOW)
         self._nostr_private_key = None
         self._default_relays = []
         self._current_nsec = None
@@ -257,6 +259,7 @@ class NostrManager:
         self._relay_list_published_for = None
         self._subscriptions = []
         self._subscription_ids = {}
+        self._subscription_index = None  # rebuilt lazily after changes
         self._nostr_configured = False
 
         # NWC state
@@ -731,6 +734,7 @@ class NostrManager:
         """Remove a named subscription and close it on relays."""
         self._subscriptions = [s for s in self._subscriptions if s.name != name]
         self._subscription_ids.pop(name, None)
+        self._subscription_index = None
         if self.relay_manager is not None:
             try:
                 self.relay_manager.close_subscription(name)
@@ -759,6 +763,7 @@ class NostrManager:
                 if limit is not None and f.limit is None:
                     f.limit = limit
 
+        self._subscription_index = None
         existing = None
         for s in self._subscriptions:
             if s.name == name:
@@ -1195,13 +1200,14 @@ class NostrManager:
                 except Exception as e:
                     logger.error("NostrManager: event handler error: %s", e)
 
-        # Store in events list for NostrApp
+        # Store in the bounded events window for NostrApp
         self.events.append(nostr_event)
-        if len(self.events) > self.EVENTS_TO_SHOW:
-            self.events = self.events[-self.EVENTS_TO_SHOW:]
 
-        # Per-subscription callbacks
-        for sub in self._subscriptions:
+        # Per-subscription callbacks, for the subscriptions the index says may match
+        index = self._subscription_index
+        if index is None or not index.built_from(self._subscriptions):
+            index = self._subscription_index = SubscriptionIndex(self._subscriptions)
+        for sub in index.candidates(event):
             try:
                 if sub.callback and sub.filters.match(event):
                     sub.callback(nostr_event)
@@ -0,0 +1,59 @@
+# Maps incoming events to the subscriptions that may match them.
+#
+# Every filter is indexed under the values of ONE of its fields, picking the
+# most selective one it sets (#e, then #p, authors, kinds). A filter can only
+# match an event that carries one of those values, so looking up the event's
+# e/p tags, pubkey and kind yields every subscription that could match. The
+# candidates are then checked with the full Filters.match(), so routing
+# behaves exactly like a linear scan over all subscriptions.
+
+_INDEXED_FIELDS = (("#e", "e"), ("#p", "p"), ("authors", "a"), ("kinds", "k"))
+
+
+class SubscriptionIndex:
+    def __init__(self, subscriptions):
+        self._subscriptions = subscriptions
+        self._index = {}  # (field, value) -> [position in subscriptions]
+        self._unindexed = []  # positions of subscriptions with a catch-all filter
+        for pos, sub in enumerate(subscriptions):
+            if sub.callback:
+                self._add(pos, sub)
+
+    def _add(self, pos, sub):
+        for f in sub.filters.data:
+            spec = f.to_json_object()
+            for field, key in _INDEXED_FIELDS:
+                values = spec.get(field)
+                if values:
+                    for value in values:
+                        self._put((key, value), pos)
+                    break
+            else:
+                if pos not in self._unindexed:
+                    self._unindexed.append(pos)
+
+    def _put(self, key, pos):
+        positions = self._index.get(key)
+        if positions is None:
+            self._index[key] = [pos]
+        elif pos not in positions:
+            positions.append(pos)
+
+    def built_from(self, subscriptions):
+        return self._subscriptions is subscriptions
+
+    def candidates(self, event):
+        """Return subscriptions that may match event, in registration order."""
+        index = self._index
+        found = set(self._unindexed)
+        for key in (("a", event.public_key), ("k", event.kind)):
+            positions = index.get(key)
+            if positions:
+                found.update(positions)
+        for tag in event.tags:
+            if len(tag) >= 2 and (tag[0] == "e" or tag[0] == "p"):
+                positions = index.get((tag[0], tag[1]))
+                if positions:
+                    found.update(positions)
+        subscriptions = self._subscriptions
+        return [subscriptions[pos] for pos in sorted(found)]
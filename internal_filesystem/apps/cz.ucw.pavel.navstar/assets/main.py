@@ -50,47 +50,6 @@ def clamp(x, lo, hi):
     return x
 
 
-def nmea_checksum_ok(line):
-    # line includes leading '$' and optional \r\n
-    line = line.strip()
-    if not line.startswith("$"):
-        return False
-    star = line.find("*")
-    if star < 0:
-        return False
-    body = line[1:star]
-    given = line[star + 1:]
-    if len(given) < 2:
-        return False
-    try:
-        want = int(given[:2], 16)
-    except ValueError:
-        return False
-
-    c = 0
-    for ch in body:
-        c ^= ord(ch)
-    return c == want
-
-
-def safe_float(s):
-    try:
-        return float(s)
-    except Exception:
-        return None
-
-
-def safe_int(s):
-    try:
-        return int(s)
-    except Exception:
-        return None
-
-
-def knots_to_kmh(knots):
-    return knots * 1.852
-
-
 def deg_to_rad(d):
     return d * math.pi / 180.0
 
@@ -125,63 +84,6 @@ def bearing_deg(lat1, lon1, lat2, lon2):
     return brd
 
 
-def parse_latlon(ddmm, hemi):
-    # NMEA format: latitude ddmm.mmmm, longitude dddmm.mmmm
-    if not ddmm or not hemi:
-        return None
-
-    v = safe_float(ddmm)
-    if v is None:
-        return None
-
-    # Split degrees and minutes
-    # For lat: 2 deg digits; for lon: 3 deg digits
-    # We infer by length before decimal.
-    s = ddmm
-    dot = s.find(".")
-    if dot < 0:
-        dot = len(s)
-
-    deg_digits = 2
-    if dot > 4:
-        deg_digits = 3
-
-    try:
-        deg = int(s[:deg_digits])
-        minutes = float(s[deg_digits:])
-    except Exception:
-        return None
-
-    dec = deg + (minutes / 60.0)
-    if hemi in ("S", "W"):
-        dec = -dec
-    return dec
-
-
-def parse_hhmmss(hhmmss):
-    # Returns (h,m,s) or None
-    if not hhmmss or len(hhmmss) < 6:
-        return None
-    try:
-        h = int(hhmmss[0:2])
-        m = int(hhmmss[2:4])
-        s = int(hhmmss[4:6])
-        return (h, m, s)
-    except Exception:
-        return None
-
-
-def parse_ddmmyy(ddmmyy):
-    if not ddmmyy or len(ddmmyy) != 6:
-        return None
-    try:
-        d = int(ddmmyy[0:2])
-        mo = int(ddmmyy[2:4])
-        y = int(ddmmyy[4:6]) + 2000
-        return (y, mo, d)
-    except Exception:
-        return None
-
 class Config:
     pass
 
@@ -218,7 +120,7 @@ class GPSState:
         self.date_ymd = None
 
         # Satellites in view from GSV:
-        # dict prn -> {el, az, snr}
+        # dict sat id (talker system << 8 | prn) -> {el, az, snr}
         self.sats_in_view = {}
 
         # Debug/diagnostic fields
@@ -235,6 +137,43 @@ class GPSState:
         # For display freshness
         self.last_update_ms = 0
 
+    def sync(self, fix):
+        # Copy the NMEAStream's integer state (mpos.nmea.GPSFix) into the
+        # float/tuple fields the pages draw; done once per tick, not per sentence.
+        self.lat = fix.lat
+        self.lon = fix.lon
+        self.alt_m = fix.alt_m
+        self.speed_kmh = fix.speed_kmh
+        self.course_deg = fix.course_deg
+
+        self.fix_quality = fix.quality
+        self.fix_valid = fix.valid
+        self.sats_used = fix.sats_used
+        self.hdop = fix.hdop
+
+        self.time_hms = None if fix.hour is None else (fix.hour, fix.minute, fix.second)
+        self.date_ymd = None if fix.year is None else (fix.year, fix.month, fix.day)
+
+        sats = {}
+        for k in range(fix.sat_count):
+            d = {"el": fix.sat_el[k], "az": fix.sat_az[k]}
+            if fix.sat_snr[k] >= 0:
+                d["snr"] = fix.sat_snr[k]
+            sats[fix.sat_id[k]] = d
+        self.sats_in_view = sats
+
+        self.last_rmc_status = None if fix.rmc_status is None else chr(fix.rmc_status)
+        self.last_gga_quality = fix.gga_quality
+        self.last_gsa_mode = None if fix.gsa_mode is None else chr(fix.gsa_mode)
+        self.last_gsa_fix_type = fix.gsa_fix_type
+        self.last_gsa_pdop = None if fix.gsa_pdop_c is None else fix.gsa_pdop_c / 100
+        self.last_gsa_hdop = None if fix.gsa_hdop_c is None else fix.gsa_hdop_c / 100
+        self.last_gsa_vdop = None if fix.gsa_vdop_c is None else fix.gsa_vdop_c / 100
+        self.last_gll_status = None if fix.gll_status is None else chr(fix.gll_status)
+        self.last_gsv_total = fix.gsv_total
+
+        self.last_update_ms = fix.updated_ms
+
     def has_fix(self):
         # Require RMC valid + lat/lon present
         return self.fix_valid and (self.lat is not None) and (self.lon is not None)
@@ -281,176 +220,6 @@ class GPSState:
         return f"No fix for {delta:.0f}"
     
 
-class NMEAParser:
-    def __init__(self, gps_state):
-        self.gps = gps_state
-
-        # GSV is multi-part, but we do not need to store parts,
-        # we just update sats_in_view as they arrive.
-        # Some modules send multiple talker IDs: GP, GN, GL, GA...
-        # We'll accept any.
-
-    def feed_line(self, line):
-        line = line.strip()
-        if not line.startswith("$"):
-            return
-
-        if not nmea_checksum_ok(line):
-            return
-
-        # Strip $ and checksum
-        star = line.find("*")
-        body = line[1:star]
-        fields = body.split(",")
-        if len(fields) < 1:
-            return
-
-        msg = fields[0]
-        # msg like GPRMC, GNRMC, etc.
-        if len(msg) < 5:
-            return
-
-        msg_type = msg[-3:]
-
-        if msg_type == "RMC":
-            self._parse_rmc(fields)
-        elif msg_type == "GGA":
-            self._parse_gga(fields)
-        elif msg_type == "GSV":
-            self._parse_gsv(fields)
-        elif msg_type == "GSA":
-            self._parse_gsa(fields)
-        elif msg_type == "GLL":
-            self._parse_gll(fields)
-
-        self.gps.last_update_ms = time.ticks_ms()
-
-    def _parse_rmc(self, f):
-        # $GPRMC,hhmmss.sss,A,llll.ll,a,yyyyy.yy,a,x.x,x.x,ddmmyy,x.x,a*hh
-        #  0      1          2 3       4 5       6 7   8   9      ...
-        if len(f) < 10:
-            return
-
-        self.gps.time_hms = parse_hhmmss(f[1])
-        status = f[2]
-        self.gps.last_rmc_status = status
-        self.gps.fix_valid = (status == "A")
-
-        lat = parse_latlon(f[3], f[4])
-        lon = parse_latlon(f[5], f[6])
-
-        if lat is not None and lon is not None:
-            self.gps.lat = lat
-            self.gps.lon = lon
-
-        sp_kn = safe_float(f[7])
-        if sp_kn is not None:
-            self.gps.speed_kmh = knots_to_kmh(sp_kn)
-
-        course = safe_float(f[8])
-        if course is not None:
-            self.gps.course_deg = course
-
-        self.gps.date_ymd = parse_ddmmyy(f[9])
-
-    def _parse_gga(self, f):
-        # $GPGGA,hhmmss.sss,lat,NS,lon,EW,quality,numSV,HDOP,alt,M,...
-        if len(f) < 10:
-            return
-
-        self.gps.time_hms = parse_hhmmss(f[1])
-
-        lat = parse_latlon(f[2], f[3])
-        lon = parse_latlon(f[4], f[5])
-        if lat is not None and lon is not None:
-            self.gps.lat = lat
-            self.gps.lon = lon
-
-        q = safe_int(f[6])
-        if q is not None:
-            self.gps.fix_quality = q
-            self.gps.last_gga_quality = q
-
-        sats = safe_int(f[7])
-        if sats is not None:
-            self.gps.sats_used = sats
-
-        hdop = safe_float(f[8])
-        if hdop is not None:
-            self.gps.hdop = hdop
-
-        alt = safe_float(f[9])
-        if alt is not None:
-            self.gps.alt_m = alt
-
-    def _parse_gsv(self, f):
-        # $GPGSV,total_msgs,msg_num,total_sats, [sat blocks...]
-        # Each sat block: prn, elev, az, snr
-        if len(f) < 4:
-            return
-
-        # total_msgs = safe_int(f[1])
-        # msg_num = safe_int(f[2])
-        total_sats = safe_int(f[3])
-        if total_sats is not None:
-            self.gps.last_gsv_total = total_sats
-
-        # sat blocks start at index 4
-        i = 4
-        while i + 3 < len(f):
-            prn = safe_int(f[i + 0])
-            el = safe_int(f[i + 1])
-            az = safe_int(f[i + 2])
-            snr = safe_int(f[i + 3])
-            i += 4
-
-            if prn is None:
-                continue
-
-            d = self.gps.sats_in_view.get(prn)
-            if d is None:
-                d = {}
-                self.gps.sats_in_view[prn] = d
-
-            if el is not None:
-                d["el"] = el
-            if az is not None:
-                d["az"] = az
-            if snr is not None:
-                d["snr"] = snr
-
-    def _parse_gsa(self, f):
-        # $GNGSA,mode1,mode2,sv1,sv2,...,sv12,pdop,hdop,vdop
-        if len(f) < 3:
-            return
-
-        mode1 = f[1] if len(f) > 1 else None
-        mode2 = safe_int(f[2]) if len(f) > 2 else None
-        pdop = safe_float(f[-3]) if len(f) >= 3 else None
-        hdop = safe_float(f[-2]) if len(f) >= 2 else None
-        vdop = safe_float(f[-1]) if len(f) >= 1 else None
-
-        self.gps.last_gsa_mode = mode1
-        self.gps.last_gsa_fix_type = mode2
-        self.gps.last_gsa_pdop = pdop
-        self.gps.last_gsa_hdop = hdop
-        self.gps.last_gsa_vdop = vdop
-
-    def _parse_gll(self, f):
-        # $GNGLL,lat,NS,lon,EW,hhmmss,status,mode
-        if len(f) < 7:
-            return
-
-        lat = parse_latlon(f[1], f[2])
-        lon = parse_latlon(f[3], f[4])
-        if lat is not None and lon is not None:
-            self.gps.lat = lat
-            self.gps.lon = lon
-
-        self.gps.time_hms = parse_hhmmss(f[5])
-        status = f[6]
-        self.gps.last_gll_status = status
-
 # ----------------------------
 # Track recording (EGT)
 # ----------------------------
@@ -571,7 +340,7 @@ class Main(PagedCanvas):
     def __init__(self):
         super().__init__()
         self.gps = GPSState()
-        self.parser = NMEAParser(self.gps)
+        self.stream = GPSManager.nmea_stream()
 
         self.track = Track()
         self.egt = EGTWriter()
@@ -583,6 +352,7 @@ class Main(PagedCanvas):
         self.last_track_add_ms = 0
 
         self.uart = None
+        self._uart_buf = bytearray(256)
 
         # Default nav point (Prague center) - change as desired
         # (Reality filter: this is just a reasonable example coordinate.)
@@ -602,12 +372,8 @@ class Main(PagedCanvas):
     def tick(self, t):
         #print("Navstar tick")
         lm.poll()
-        nmea = lm.get_nmea()
-        if nmea:
-            lines = nmea.split('\n')
-            for line in lines:
-                #print("line", line)
-                self.parser.feed_line(line)
+        lm.feed(self.stream)
+        self.gps.sync(self.stream.fix)
         self.update()
         self.draw()
 
@@ -638,16 +404,14 @@ class Main(PagedCanvas):
         if not self.uart:
             return
 
-        # We read line-by-line. Many GPS modules end lines with \r\n.
+        # Raw bytes go straight into the stream parser, line breaks and all.
+        buf = self._uart_buf
         while True:
-            line = self.uart.readline()
-            if not line:
+            n = self.uart.readinto(buf)
+            if not n:
                 break
-            try:
-                s = line.decode("ascii", "ignore")
-            except Exception:
-                continue
-            self.parser.feed_line(s)
+            self.stream.feed(buf, n)
+        self.gps.sync(self.stream.fix)
 
     def maybe_update_track(self):
         if not self.gps.has_fix():
@@ -925,6 +689,11 @@ class LocationManagerDBUS:
             return self.loc["4"]
         return None
 
+    def feed(self, stream):
+        nmea = self.get_nmea()
+        if nmea:
+            stream.feed(nmea + "\n")
+
 
 class LocationManager:
     def __init__(self):
@@ -932,23 +701,21 @@ class LocationManager:
         self.f = open(path, "rb")
         self.sel = uselect.poll()
         self.sel.register(self.f, uselect.POLLIN)
-        self.data = b""
+        self.buf = bytearray(256)
 
     def poll(self):
-        while True:
-            events = self.sel.poll(0)  # non-blocking
-            if not events:
-                break
-            self.data += self.f.readline()
+        pass
 
     def get_cellid(self):
         return None
 
-    def get_nmea(self):
-        d = self.data
-        print(d)
-        self.data = b""
-        return d.decode("ascii", "ignore")
+    def feed(self, stream):
+        # Hand raw bytes to the stream parser; it copes with partial lines.
+        while self.sel.poll(0):  # non-blocking
+            n = self.f.readinto(self.buf)
+            if not n:
+                break
+            stream.feed(self.buf, n)
 
 
 class LocationManagerUART:
@@ -972,42 +739,26 @@ class LocationManagerUART:
             uart_kwargs["tx"] = tx
 
         self.uart = UART(uart_id, **uart_kwargs)
-        self.data = b""
+        self.buf = bytearray(256)
         print(
             "LocationManagerUART init: uart_id=%s baudrate=%s tx=%s rx=%s"
             % (uart_id, baudrate, tx, rx)
         )
 
     def poll(self):
-        while True:
-            available = self.uart.any()
-            if not available:
-                break
-            chunk = self.uart.read(available)
-            if chunk:
-                #try:
-                #    preview = chunk.decode("ascii", "ignore")
-                #except Exception:
-                #    preview = "<decode error>"
-                #print("LocationManagerUART read %d bytes preview=%r"% (len(chunk), preview[:120]))
-                self.data += chunk
+        pass
 
     def get_cellid(self):
         return None
 
-    def get_nmea(self):
-        d = self.data
-        self.data = b""
-        if not d:
-            return ""
-        text = d.decode("ascii", "replace")
-        if "\ufffd" in text:
-            print("LocationManagerUART decode warning: replacement characters found")
-        lines = [line for line in text.split("\r\n") if line]
-        print("LocationManagerUART NMEA lines: %d" % len(lines))
-        for line in lines:
-            print("LocationManagerUART line: %s" % line)
-        return text
+    def feed(self, stream):
+        # Drain the UART through one preallocated buffer straight into the
+        # stream parser: no per-chunk bytes, no decode, no line splitting.
+        while self.uart.any():
+            n = self.uart.readinto(self.buf)
+            if not n:
+                break
+            stream.feed(self.buf, n)
 
 # ----------------------------
 # Fake NMEA source
@@ -1234,7 +985,7 @@ class FakeNMEASpiral:
         return out
 
     def poll(self):
-        self.data = '\n'.join(self.next_sentences())
+        self.data = '\n'.join(self.next_sentences()) + '\n'
         
     def get_cellid(self):
         return None
@@ -1242,6 +993,9 @@ class FakeNMEASpiral:
     def get_nmea(self):
         return self.data
 
+    def feed(self, stream):
+        stream.feed(self.data)
+
     def _gsv_sentences(self):
         # GSV: 4 sats per message
         sats = self.sats
@@ -6,16 +6,69 @@ from mpos import Activity
 # Canvas (LVGL)
 # -----------------------------
 
+# Primitive kinds in a recorded frame
+_TEXT = 0
+_LINE = 1
+_CIRCLE = 2
+_FILL_CIRCLE = 3
+_FILL_RECT = 4
+
+_TEXT_LINE_H = 18  # montserrat_14 line height, rounded up
+
+
+def _color_key(c):
+    return (c.red, c.green, c.blue)
+
+
+def _overlaps(a, b):
+    return a[0] <= b[2] and b[0] <= a[2] and a[1] <= b[3] and b[1] <= a[3]
+
+
+def merge_rects(rects, w, h):
+    """
+    Merge overlapping dirty rectangles (x1, y1, x2, y2, inclusive) and clip
+    them to the canvas. Falls back to one full-canvas rectangle once the dirty
+    area covers more than half of it, where per-region redraw stops paying off.
+    """
+    out = []
+    for r in rects:
+        r = (max(r[0], 0), max(r[1], 0), min(r[2], w - 1), min(r[3], h - 1))
+        if r[0] > r[2] or r[1] > r[3]:
+            continue
+        i = 0
+        while i < len(out):
+            o = out[i]
+            if _overlaps(o, r):
+                r = (min(o[0], r[0]), min(o[1], r[1]), max(o[2], r[2]), max(o[3], r[3]))
+                out.pop(i)
+                i = 0
+            else:
+                i += 1
+        out.append(r)
+    area = 0
+    for r in out:
+        area += (r[2] - r[0] + 1) * (r[3] - r[1] + 1)
+    if area * 2 > w * h:
+        return [(0, 0, w - 1, h - 1)]
+    return out
+
+
 class Canvas:
     """
-    LVGL canvas + layer drawing Canvas.
+    Retained-mode LVGL canvas.
+
+    Drawing calls between clear() and update() only record primitives.
+    update() compares the frame with the one on screen, repaints just the
+    rectangles covered by primitives that appeared or went away (clipped, so
+    unchanged neighbours are not drawn twice) and invalidates only those
+    rectangles. A frame identical to the previous one costs nothing.
 
     This matches ports where:
       - lv.canvas has init_layer() / finish_layer()
       - primitives are drawn via lv.draw_* into lv.layer_t
     """
 
-    def __init__(self, scr, canvas):
+    def __init__(self, scr, canvas, color_format=lv.COLOR_FORMAT.NATIVE):
         self.scr = scr
 
         # Screen size
@@ -33,16 +86,22 @@ class Canvas:
         self.canvas = canvas
 
         # Background: white (change if you want dark theme)
-        self.canvas.set_style_bg_color(lv.color_white(), lv.PART.MAIN)
+        self.bg = lv.color_white()
+        self.canvas.set_style_bg_color(self.bg, lv.PART.MAIN)
 
-        # Buffer: your working example uses 4 bytes/pixel
-        # Reality filter: this depends on LV_COLOR_DEPTH; but your example proves it works.
-        self.buf = bytearray(self.draw_w * self.draw_h * 4)
-        self.canvas.set_buffer(self.buf, self.draw_w, self.draw_h, lv.COLOR_FORMAT.NATIVE)
+        # NATIVE is RGB565 on the 16-bit displays, half the RAM of ARGB8888
+        px = lv.color_format_get_size(color_format)
+        self.buf = bytearray(self.draw_w * self.draw_h * px)
+        self.canvas.set_buffer(self.buf, self.draw_w, self.draw_h, color_format)
 
         # Layer used for draw engine
         self.layer = lv.layer_t()
         self.canvas.init_layer(self.layer)
+        # Per-region repaint needs to clip the layer and to dispatch it without
+        # finish_layer(), which invalidates the whole canvas. Older bindings
+        # lacking either get a full repaint of changed frames.
+        self._can_clip = hasattr(self.layer, "_clip_area")
+        self._can_dispatch = hasattr(lv, "draw_dispatch_layer") and hasattr(self.layer, "draw_task_head")
 
         # Persistent draw descriptors (avoid allocations)
         self._line_dsc = lv.draw_line_dsc_t()
@@ -52,11 +111,6 @@ class Canvas:
         self._line_dsc.round_end = 1
         self._line_dsc.round_start = 1
 
-        self._label_dsc = lv.draw_label_dsc_t()
-        lv.draw_label_dsc_t.init(self._label_dsc)
-        self._label_dsc.color = lv.color_black()
-        self._label_dsc.font = lv.font_montserrat_24
-
         self._rect_dsc = lv.draw_rect_dsc_t()
         lv.draw_rect_dsc_t.init(self._rect_dsc)
         self._rect_dsc.bg_opa = lv.OPA.TRANSP
@@ -70,8 +124,21 @@ class Canvas:
         self._fill_dsc.bg_color = lv.color_black()
         self._fill_dsc.border_width = 1
 
+        self._bg_dsc = lv.draw_rect_dsc_t()
+        lv.draw_rect_dsc_t.init(self._bg_dsc)
+        self._bg_dsc.bg_opa = lv.OPA.COVER
+        self._bg_dsc.bg_color = self.bg
+        self._bg_dsc.border_width = 0
+
+        self._area = lv.area_t()
+
+        # Frames: lists of (kind, args...) tuples, plus their bounding boxes
+        self._shown = []
+        self._frame = []
+        self.last_dirty = []
+
         # Clear once
-        self.clear()
+        self.canvas.fill_bg(self.bg, lv.OPA.COVER)
 
     # ----------------------------
     # Layer lifecycle
@@ -81,111 +148,155 @@ class Canvas:
         # Start drawing into the layer
         self.canvas.init_layer(self.layer)
 
-    def _end(self):
+    def _end(self, dirty):
         # Commit drawing
-        self.canvas.finish_layer(self.layer)
+        if not self._can_dispatch:
+            self.canvas.finish_layer(self.layer)
+            return
+        # Same loop as lv_canvas_finish_layer(), minus its full invalidation
+        layer = self.layer
+        disp = self.canvas.get_display()
+        while layer.draw_task_head:
+            lv.draw_dispatch_wait_for_request()
+            if not lv.draw_dispatch_layer(disp, layer):
+                lv.draw_wait_for_finish()
+                lv.draw_dispatch_request()
+        coords = lv.area_t()
+        self.canvas.get_coords(coords)
+        for r in dirty:
+            a = lv.area_t()
+            a.x1 = coords.x1 + r[0]
+            a.y1 = coords.y1 + r[1]
+            a.x2 = coords.x1 + r[2]
+            a.y2 = coords.y1 + r[3]
+            self.canvas.invalidate_area(a)
 
     # ----------------------------
     # Public API: drawing
     # ----------------------------
 
     def clear(self):
-        # Clear the canvas background
-        self.canvas.fill_bg(lv.color_white(), lv.OPA.COVER)
+        # Start recording a new frame
+        self._frame = []
 
     def text(self, x, y, s, fg = lv.color_black()):
-        self._begin()
-
-        dsc = lv.draw_label_dsc_t()
-        lv.draw_label_dsc_t.init(dsc)
-        dsc.text = str(s)
-        dsc.font = lv.font_montserrat_14
-        dsc.color = lv.color_black()
-
-        area = lv.area_t()
-        area.x1 = x
-        area.y1 = y
-        area.x2 = x + self.W
-        area.y2 = y + self.H
-
-        lv.draw_label(self.layer, dsc, area)
-
-        self._end()
+        s = str(s)
+        self._frame.append((_TEXT, int(x), int(y), s))
 
     def line(self, x1, y1, x2, y2, fg = lv.color_black()):
-        self._begin()
-
-        dsc = self._line_dsc
-        dsc.p1 = lv.point_precise_t()
-        dsc.p2 = lv.point_precise_t()
-        dsc.p1.x = int(x1)
-        dsc.p1.y = int(y1)
-        dsc.p2.x = int(x2)
-        dsc.p2.y = int(y2)
-
-        lv.draw_line(self.layer, dsc)
-
-        self._end()
+        self._frame.append((_LINE, int(x1), int(y1), int(x2), int(y2)))
 
     def circle(self, x, y, r, fg = lv.color_black()):
-        # Rounded rectangle trick (works everywhere)
-        self._begin()
-
-        a = lv.area_t()
-        a.x1 = int(x - r)
-        a.y1 = int(y - r)
-        a.x2 = int(x + r)
-        a.y2 = int(y + r)
-
-        dsc = self._rect_dsc
-        dsc.radius = lv.RADIUS_CIRCLE
-        dsc.border_color = fg
-
-        lv.draw_rect(self.layer, dsc, a)
-
-        self._end()
+        self._frame.append((_CIRCLE, int(x), int(y), int(r), _color_key(fg)))
 
     def fill_circle(self, x, y, r, fg = lv.color_black(), bg = lv.color_white()):
-        self._begin()
-
-        a = lv.area_t()
-        a.x1 = int(x - r)
-        a.y1 = int(y - r)
-        a.x2 = int(x + r)
-        a.y2 = int(y + r)
-
-        dsc = self._rect_dsc
-        dsc.radius = lv.RADIUS_CIRCLE
-        dsc.border_color = fg
-        dsc.bg_color = bg
-
-        lv.draw_rect(self.layer, dsc, a)
-
-        self._end()
+        self._frame.append((_FILL_CIRCLE, int(x), int(y), int(r), _color_key(fg), _color_key(bg)))
 
     def fill_rect(self, x, y, sx, sy, fg = lv.color_black(), bg = lv.color_white()):
-        self._begin()
-
-        a = lv.area_t()
-        a.x1 = x
-        a.y1 = y
-        a.x2 = x+sx
-        a.y2 = y+sy
+        self._frame.append((_FILL_RECT, int(x), int(y), int(sx), int(sy), _color_key(fg), _color_key(bg)))
 
-        dsc = self._fill_dsc
-        dsc.border_color = fg
-        dsc.bg_color = bg
+    def update(self):
+        # Show the recorded frame, repainting only what changed
+        frame = self._frame
+        shown = self._shown
+        if frame == shown:
+            self.last_dirty = []
+            return
+        old = set(shown)
+        new = set(frame)
+        rects = [self._bounds(op) for op in shown if op not in new]
+        rects += [self._bounds(op) for op in frame if op not in old]
+        w, h = self.draw_w, self.draw_h
+        dirty = merge_rects(rects, w, h) if self._can_clip else [(0, 0, w - 1, h - 1)]
+        self._shown = frame
+        self.last_dirty = dirty
+        if not dirty:
+            return
 
-        lv.draw_rect(self.layer, dsc, a)
+        self._begin()
+        layer = self.layer
+        a = self._area
+        for r in dirty:
+            a.x1, a.y1, a.x2, a.y2 = r
+            if self._can_clip:
+                layer._clip_area = a
+            lv.draw_rect(layer, self._bg_dsc, a)
+            for op in frame:
+                if _overlaps(self._bounds(op), r):
+                    self._draw(op)
+        self._end(dirty)
 
-        self._end()
+    # ----------------------------
+    # Rendering of recorded primitives
+    # ----------------------------
 
-    def update(self):
-        # Nothing needed; drawing is committed per primitive.
-        # If you want, you can change the implementation so that:
-        # - draw ops happen between clear() and update()
-        # But then you must ensure the app calls update() once per frame.
-        pass
+    def _bounds(self, op):
+        kind = op[0]
+        if kind == _TEXT:
+            lines = op[3].count("\n") + 1
+            return (op[1], op[2], self.draw_w - 1, op[2] + lines * _TEXT_LINE_H)
+        if kind == _LINE:
+            return (min(op[1], op[3]) - 1, min(op[2], op[4]) - 1,
+                    max(op[1], op[3]) + 1, max(op[2], op[4]) + 1)
+        if kind == _FILL_RECT:
+            return (op[1], op[2], op[1] + op[3], op[2] + op[4])
+        # circles
+        return (op[1] - op[3] - 1, op[2] - op[3] - 1, op[1] + op[3] + 1, op[2] + op[3] + 1)
+
+    def _draw(self, op):
+        kind = op[0]
+        if kind == _TEXT:
+            dsc = lv.draw_label_dsc_t()
+            lv.draw_label_dsc_t.init(dsc)
+            dsc.text = op[3]  # op stays referenced by _shown until dispatched
+            dsc.font = lv.font_montserrat_14
+            dsc.color = lv.color_black()
+
+            a = lv.area_t()
+            a.x1 = op[1]
+            a.y1 = op[2]
+            a.x2 = op[1] + self.W
+            a.y2 = op[2] + self.H
+
+            lv.draw_label(self.layer, dsc, a)
+        elif kind == _LINE:
+            dsc = self._line_dsc
+            dsc.p1 = lv.point_precise_t()
+            dsc.p2 = lv.point_precise_t()
+            dsc.p1.x = op[1]
+            dsc.p1.y = op[2]
+            dsc.p2.x = op[3]
+            dsc.p2.y = op[4]
+
+            lv.draw_line(self.layer, dsc)
+        elif kind == _FILL_RECT:
+            a = lv.area_t()
+            a.x1 = op[1]
+            a.y1 = op[2]
+            a.x2 = op[1] + op[3]
+            a.y2 = op[2] + op[4]
+
+            dsc = self._fill_dsc
+            dsc.border_color = lv.color_make(*op[5])
+            dsc.bg_color = lv.color_make(*op[6])
+
+            lv.draw_rect(self.layer, dsc, a)
+        else:
+            # Rounded rectangle trick (works everywhere)
+            x, y, r = op[1], op[2], op[3]
+            a = lv.area_t()
+            a.x1 = x - r
+            a.y1 = y - r
+            a.x2 = x + r
+            a.y2 = y + r
+
+            dsc = self._rect_dsc
+            dsc.radius = lv.RADIUS_CIRCLE
+            dsc.border_color = lv.color_make(*op[4])
+            if kind == _FILL_CIRCLE:
+                dsc.bg_color = lv.color_make(*op[5])
+
+            lv.draw_rect(self.layer, dsc, a)
 
 # ----------------------------
 # App logic
@@ -298,6 +409,7 @@ class PagedCanvas(Activity):
         y = 2*st
         ui.text(0, y, "Hello world, page is %d" % self.page)
         y += st
+        ui.update()
 
     def draw(self):
         self.draw_page_example()
@@ -1,6 +1,7 @@
 import hashlib
 import json
 import logging
+import os
 
 import ujson
 
@@ -177,6 +178,142 @@ async def report_badgehub_install(fullname, revision):
         if __debug__: logger.debug("report install failed for %s: %s", fullname, e)
 
 
+# ------------------------------------------------------------------
+# Streaming app index parsing
+# ------------------------------------------------------------------
+
+
+class IndexScanner:
+    """Incremental parser for a JSON array of objects, fed chunk by chunk.
+
+    Calls ``on_item(raw)`` with the raw bytes of each top-level object as soon
+    as it is complete, so only one entry is held at a time instead of the
+    whole index. Structural characters are located with bytes.find(), which
+    keeps the per-byte work in C. Raises ValueError on malformed input.
+    """
+
+    _QUOTE = 0x22
+    _BACKSLASH = 0x5C
+    _TOKENS = (b'"', b'{', b'}', b'[', b']')
+
+    def __init__(self, on_item):
+        self._on_item = on_item
+        self._carry = b''     # unfinished entry, from its opening brace
+        self._scanned = 0     # bytes of _carry already scanned
+        self._depth = 0
+        self._in_string = False
+        self.done = False
+        self.count = 0
+
+    def feed(self, chunk):
+        if self.done or not chunk:
+            return
+        buf = self._carry + chunk if self._carry else chunk
+        n = len(buf)
+        i = self._scanned
+        start = 0
+        depth = self._depth
+        in_string = self._in_string
+        nxt = [-1] * 5  # cached next position of each token
+        while i < n:
+            if in_string:
+                j = buf.find(b'"', i)
+                if j < 0:
+                    i = n
+                    break
+                k = j - 1
+                while buf[k] == self._BACKSLASH:
+                    k -= 1
+                i = j + 1
+                if (j - 1 - k) % 2 == 0:  # not escaped
+                    in_string = False
+                continue
+            j = n
+            t = -1
+            for k in range(5):
+                p = nxt[k]
+                if p < i and p != n:
+                    p = buf.find(self._TOKENS[k], i)
+                    if p < 0:
+                        p = n
+                    nxt[k] = p
+                if p < j:
+                    j = p
+                    t = k
+            if t < 0:
+                i = n
+                break
+            i = j + 1
+            if t == 0:
+                if depth < 2:
+                    raise ValueError("index entries must be objects")
+                in_string = True
+            elif t == 1 or t == 3:
+                if depth == 0 and t == 1:
+                    raise ValueError("index is not a JSON array")
+                if depth == 1:
+                    if t == 3:
+                        raise ValueError("index entries must be objects")
+                    start = j
+                depth += 1
+            else:
+                depth -= 1
+                if depth == 1:
+                    self.count += 1
+                    self._on_item(buf[start:i])
+                elif depth == 0:
+                    self.done = True
+                    break
+                elif depth < 0:
+                    raise ValueError("unbalanced index")
+        if depth >= 2 and not self.done:
+            self._carry = buf[start:]
+            self._scanned = i - start
+        else:
+            self._carry = b''
+            self._scanned = 0
+        self._depth = depth
+        self._in_string = in_string
+
+    def finish(self):
+        if not self.done:
+            raise ValueError("truncated index")
+
+
+def _file_exists(path):
+    try:
+        os.stat(path)
+        return True
+    except OSError:
+        return False
+
+
+def _make_dirs(path):
+    current = ""
+    for part in path.split("/"):
+        current = current + "/" + part if current else part
+        if not _file_exists(current):
+            os.mkdir(current)
+
+
+def _remove_quietly(path):
+    if not path:
+        return
+    try:
+        os.remove(path)
+    except OSError:
+        pass
+
+
+def _get_header(headers, name):
+    # Header names keep the server's capitalisation
+    if isinstance(headers, dict):
+        for key in headers:
+            if key.lower() == name:
+                return headers[key]
+    return None
+
+
 class AppUpdateState:
     IDLE = "idle"
     WAITING_WIFI = "waiting_wifi"
@@ -206,6 +343,12 @@ class AppUpdateManager:
 
     _PREF_KEY_BACKEND = "backend"
 
+    # Last downloaded index, revalidated with its ETag/Last-Modified (kept in
+    # _INDEX_CACHE_PREFS). None disables the local copy.
+    INDEX_CACHE_PATH = "prefs/com.micropythonos.appstore/app_index.json"
+    _INDEX_CACHE_PREFS = "index_cache.json"
+    _CACHE_READ_SIZE = 4096
+
     @classmethod
     def get_instance(cls):
         if cls._instance is None:
@@ -321,7 +464,9 @@ class AppUpdateManager:
     async def check_for_updates(self, index_url=None):
         """Download the app index and compare versions against installed apps.
 
-        ``index_url`` defaults to the production index.  The AppStore UI
+        The index is parsed entry by entry while it streams in (see
+        IndexScanner) and revalidated against the local copy, so an unchanged
+        index costs one 304 response. ``index_url`` defaults to the production index.  The AppStore UI
         may pass its own backend URL when the user has changed the backend setting.
         """
         if self._check_in_progress:
@@ -334,8 +479,23 @@ class AppUpdateManager:
             if index_url is None:
                 index_url, backend_type = self._get_index_url_and_type()
 
+            updatable = []
+
+            def _on_entry(raw):
+                # Parse one entry at a time and keep it only if it updates an
+                # installed app
+                try:
+                    app_data = ujson.loads(raw)
+                except Exception:
+                    raise ValueError("bad index entry")
+                self._check_entry(app_data, backend_type, updatable)
+
             try:
-                response = await DownloadManager.download_url(index_url)
+                await self._scan_index(index_url, IndexScanner(_on_entry))
+            except ValueError as e:
+                logger.error("JSON parse error: %s", e)
+                self._set_state(AppUpdateState.ERROR)
+                return
             except Exception as e:
                 logger.error("download error: %s", e)
                 if DownloadManager.is_network_error(e):
@@ -344,38 +504,6 @@ class AppUpdateManager:
                     self._set_state(AppUpdateState.ERROR)
                 return
 
-            try:
-                apps_json = ujson.loads(response)
-            except Exception as e:
-                logger.error("JSON parse error: %s", e)
-                self._set_state(AppUpdateState.ERROR)
-                return
-
-            updatable = []
-            for app_data in apps_json:
-                try:
-                    if backend_type == "badgehub":
-                        fullname = app_data.get("slug")
-                        remote_version = app_data.get("version")
-                        if not fullname or not remote_version:
-                            continue
-                        if AppManager.is_update_available(fullname, remote_version):
-                            updatable.append({
-                                "fullname": fullname,
-                                "version": remote_version,
-                                "name": app_data.get("name", fullname),
-                                "download_url": None,
-                            })
-                    else:
-                        fullname = app_data.get("fullname")
-                        remote_version = app_data.get("version")
-                        if not fullname or not remote_version:
-                            continue
-                        if AppManager.is_update_available(fullname, remote_version):
-                            updatable.append(app_data)
-                except Exception as e:
-                    logger.error("error checking %s: %s", app_data, e)
-
             self.updatable_apps = updatable
 
             if updatable:
@@ -388,6 +516,114 @@ class AppUpdateManager:
         finally:
             self._check_in_progress = False
 
+    def _check_entry(self, app_data, backend_type, updatable):
+        try:
+            if backend_type == "badgehub":
+                fullname = app_data.get("slug")
+                remote_version = app_data.get("version")
+                if not fullname or not remote_version:
+                    return
+                if AppManager.is_update_available(fullname, remote_version):
+                    updatable.append({
+                        "fullname": fullname,
+                        "version": remote_version,
+                        "name": app_data.get("name", fullname),
+                        "download_url": None,
+                    })
+            else:
+                fullname = app_data.get("fullname")
+                remote_version = app_data.get("version")
+                if not fullname or not remote_version:
+                    return
+                if AppManager.is_update_available(fullname, remote_version):
+                    updatable.append(app_data)
+        except Exception as e:
+            logger.error("error checking %s: %s", app_data, e)
+
+    async def _scan_index(self, index_url, scanner):
+        """Stream the index through scanner, revalidating the local copy.
+
+        The last index is kept at INDEX_CACHE_PATH with its ETag and
+        Last-Modified. While the copy is for the same URL the request is
+        conditional, and a 304 Not Modified rescans the copy from flash
+        instead of downloading the index again.
+        """
+        cache_path = self.INDEX_CACHE_PATH
+        prefs = SharedPreferences("com.micropythonos.appstore", self._INDEX_CACHE_PREFS)
+        headers = {}
+        if cache_path and prefs.get_string("url") == index_url and _file_exists(cache_path):
+            etag = prefs.get_string("etag")
+            last_modified = prefs.get_string("last_modified")
+            if etag:
+                headers["If-None-Match"] = etag
+            if last_modified:
+                headers["If-Modified-Since"] = last_modified
+
+        # The download goes to a temporary file that replaces the copy only
+        # once the whole index has parsed
+        tmp_path = None
+        fd = None
+        if cache_path:
+            try:
+                if "/" in cache_path:
+                    _make_dirs(cache_path[:cache_path.rfind("/")])
+                fd = open(cache_path + ".tmp", "wb")
+                tmp_path = cache_path + ".tmp"
+            except OSError as e:
+                logger.warning("not keeping a local app index: %s", e)
+
+        async def _chunk(chunk):
+            if fd:
+                fd.write(chunk)
+            scanner.feed(chunk)
+
+        response_info = {}
+        try:
+            await DownloadManager.download_url(
+                index_url, chunk_callback=_chunk, headers=headers or None, response_info=response_info
+            )
+        except BaseException:
+            if fd:
+                fd.close()
+                _remove_quietly(tmp_path)
+            raise
+        if fd:
+            fd.close()
+
+        if response_info.get("status") == 304:
+            if __debug__: logger.debug("app index not modified, scanning %s", cache_path)
+            _remove_quietly(tmp_path)
+            with open(cache_path, "rb") as f:
+                while not scanner.done:
+                    chunk = f.read(self._CACHE_READ_SIZE)
+                    if not chunk:
+                        break
+                    scanner.feed(chunk)
+                    await TaskManager.sleep_ms(0)
+            scanner.finish()
+            return
+
+        try:
+            scanner.finish()
+        except ValueError:
+            _remove_quietly(tmp_path)
+            raise
+        if not tmp_path:
+            return
+        _remove_quietly(cache_path)
+        try:
+            os.rename(tmp_path, cache_path)
+        except OSError as e:
+            logger.warning("could not keep the app index: %s", e)
+            _remove_quietly(tmp_path)
+            return
+        resp_headers = response_info.get("headers")
+        editor = prefs.edit()
+        editor.put_string("url", index_url)
+        editor.put_string("etag", _get_header(resp_headers, "etag") or "")
+        editor.put_string("last_modified", _get_header(resp_headers, "last-modified") or "")
+        editor.commit()
+
     # ------------------------------------------------------------------
     # Notification helpers
     # ------------------------------------------------------------------
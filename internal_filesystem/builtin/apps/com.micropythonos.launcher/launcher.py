@@ -11,11 +11,17 @@ logger = logging.getLogger(__name__)
 # - background image
 # - show splash icon or not when starting an app
 
+# Grid parameters
+ICON_SIZE = 64
+LABEL_HEIGHT = 24
+WIDTH_MARGIN = 25
+
 class Launcher(Activity):
     def __init__(self):
         super().__init__()
-        self._last_app_list = None          # list of tuples (name, path)
-        self._last_ui_built = False         # was UI built at least once?
+        self._tiles = {}                    # fullname -> [app_cont, image, label, (name, version, path)]
+        self._tile_order = []               # fullnames in grid order
+        self._tile_size = None              # (width, height) the tiles were laid out for
         self._last_started_fullname = None  # fullname of the last app the user launched
         self._app_cont_map = {}             # fullname -> app_cont widget
         self._splash_fullname = None        # fullname of the app being launched (splash shown)
@@ -36,96 +42,124 @@ class Launcher(Activity):
         self.setContentView(main_screen)
 
     def onResume(self, screen):
-        # If we were showing a splash, force a full rebuild to clean up
         self._exit_splash_mode(screen)
 
-        current_apps = []
-        for app in AppManager.get_app_list():
-            if app.category == "launcher":
-                continue
-            current_apps.append((app.name, app.installed_path))
-
-        # Compare with the cached list – if identical we skip UI rebuild
         start = time.ticks_ms()
-        rebuild_needed = True
-
-        if (self._last_app_list is not None and
-            len(self._last_app_list) == len(current_apps)):
-            # element-wise compare (name, path)
-            if all(a == b for a, b in zip(self._last_app_list, current_apps)):
-                rebuild_needed = False
-
-        if not rebuild_needed:
-            end = time.ticks_ms()
-            if __debug__: logger.debug("redraw took %dms (cached)", end - start)
-            self._focus_last_or_first()
-            return
-        else:
-            if __debug__: logger.debug("rebuild needed of launcher")
-
-        # UI needs (re)building – clear screen and create widgets
-        screen.clean()
-        self._app_cont_map = {}
-
-        # Grid parameters
-        icon_size = 64
-        label_height = 24
-        width_margin = 25
-        icons_fit_width = math.floor((DisplayMetrics.width()-width_margin) / icon_size)
-        iconcont_width = int((DisplayMetrics.width()-width_margin) / icons_fit_width)
-        iconcont_height = icon_size + label_height
-
+        apps = []
         for app in AppManager.get_app_list():
             if app.category == "launcher" or (app.fullname != "com.micropythonos.settings.wifi" and app.fullname.startswith("com.micropythonos.settings.")):
                 # Ignore launchers and MPOS settings (except wifi)
                 continue
+            apps.append(app)
 
-            app_name = app.name
-            app_dir_fullpath = app.installed_path
-
-            # ----- container ------------------------------------------------
-            app_cont = lv.obj(screen)
-            app_cont.set_size(iconcont_width, iconcont_height)
-            app_cont.set_style_border_width(0, lv.PART.MAIN)
-            app_cont.set_style_pad_all(0, lv.PART.MAIN)
-            app_cont.set_style_bg_opa(lv.OPA.TRANSP, lv.PART.MAIN)
-            app_cont.set_scrollbar_mode(lv.SCROLLBAR_MODE.OFF)
-
-            # ----- icon ----------------------------------------------------
-            image = lv.image(app_cont)
-            if app.icon_data:
-                image.set_src(lv.image_dsc_t({
-                    'data_size': len(app.icon_data),
-                    'data': app.icon_data
-                }))
-            else:
-                image.set_src(lv.SYMBOL.IMAGE)
-            image.align(lv.ALIGN.TOP_MID, 0, 0)
-            image.set_size(icon_size, icon_size)
-
-            # ----- label ---------------------------------------------------
-            label = lv.label(app_cont)
-            label.set_text(app_name)
-            label.set_long_mode(lv.label.LONG_MODE.WRAP)
-            label.set_width(iconcont_width)
-            label.align(lv.ALIGN.BOTTOM_MID, 0, 0)
-            label.set_style_text_align(lv.TEXT_ALIGN.CENTER, lv.PART.MAIN)
-
-            # ----- events --------------------------------------------------
-            app_cont.add_event_cb(lambda e, fullname=app.fullname: self._launch_app(fullname), lv.EVENT.CLICKED, None)
-            add_focus_highlight(app_cont)
-
-            self._app_cont_map[app.fullname] = app_cont
-
-        # Store the new representation for the next resume
-        self._last_app_list = current_apps
-        self._last_ui_built = True
-
-        end = time.ticks_ms()
-        if __debug__: logger.debug("launcher rebuild took %dms (full rebuild)", end - start)
+        changed = self._sync_tiles(screen, apps)
+
+        if __debug__: logger.debug("launcher sync took %dms (%d tiles changed)", time.ticks_diff(time.ticks_ms(), start), changed)
 
         self._focus_last_or_first()
 
+    def _sync_tiles(self, screen, apps):
+        """
+        Bring the grid in line with apps, keyed by fullname: tiles of removed
+        apps are deleted, new apps get a tile, changed apps are updated in
+        place and everything else (widgets and decoded icons) is kept.
+        Returns the number of tiles created, updated or deleted.
+        """
+        changed = 0
+        tiles = self._tiles
+
+        width = DisplayMetrics.width() - WIDTH_MARGIN
+        iconcont_width = int(width / math.floor(width / ICON_SIZE))
+        tile_size = (iconcont_width, ICON_SIZE + LABEL_HEIGHT)
+        if tile_size != self._tile_size:
+            self._tile_size = tile_size
+            for tile in tiles.values():
+                tile[0].set_size(*tile_size)
+                tile[2].set_width(iconcont_width)
+
+        wanted = {}
+        for app in apps:
+            wanted[app.fullname] = app
+        for fullname in [f for f in tiles if f not in wanted]:
+            tiles.pop(fullname)[0].delete()
+            del self._app_cont_map[fullname]
+            changed += 1
+
+        order = []
+        for app in apps:
+            order.append(app.fullname)
+            tile = tiles.get(app.fullname)
+            if tile is None:
+                self._create_tile(screen, app)
+                changed += 1
+            elif tile[3] != (app.name, app.version, app.installed_path):
+                self._update_tile(tile, app)
+                changed += 1
+
+        if order != self._tile_order:
+            # Flex layout follows child order; keep the focus group in the
+            # same order for next/prev navigation
+            focusgroup = lv.group_get_default()
+            for index, fullname in enumerate(order):
+                app_cont = tiles[fullname][0]
+                if app_cont.get_index() != index:
+                    app_cont.move_to_index(index)
+                if focusgroup:
+                    lv.group_remove_obj(app_cont)
+                    focusgroup.add_obj(app_cont)
+            self._tile_order = order
+        return changed
+
+    def _set_icon(self, image, app):
+        if app.icon_data:
+            image.set_src(lv.image_dsc_t({
+                'data_size': len(app.icon_data),
+                'data': app.icon_data
+            }))
+        else:
+            image.set_src(lv.SYMBOL.IMAGE)
+
+    def _create_tile(self, screen, app):
+        iconcont_width, iconcont_height = self._tile_size
+
+        # ----- container ------------------------------------------------
+        app_cont = lv.obj(screen)
+        app_cont.set_size(iconcont_width, iconcont_height)
+        app_cont.set_style_border_width(0, lv.PART.MAIN)
+        app_cont.set_style_pad_all(0, lv.PART.MAIN)
+        app_cont.set_style_bg_opa(lv.OPA.TRANSP, lv.PART.MAIN)
+        app_cont.set_scrollbar_mode(lv.SCROLLBAR_MODE.OFF)
+
+        # ----- icon ----------------------------------------------------
+        image = lv.image(app_cont)
+        self._set_icon(image, app)
+        image.align(lv.ALIGN.TOP_MID, 0, 0)
+        image.set_size(ICON_SIZE, ICON_SIZE)
+
+        # ----- label ---------------------------------------------------
+        label = lv.label(app_cont)
+        label.set_text(app.name)
+        label.set_long_mode(lv.label.LONG_MODE.WRAP)
+        label.set_width(iconcont_width)
+        label.align(lv.ALIGN.BOTTOM_MID, 0, 0)
+        label.set_style_text_align(lv.TEXT_ALIGN.CENTER, lv.PART.MAIN)
+
+        # ----- events --------------------------------------------------
+        app_cont.add_event_cb(lambda e, fullname=app.fullname: self._launch_app(fullname), lv.EVENT.CLICKED, None)
+        add_focus_highlight(app_cont)
+
+        self._tiles[app.fullname] = [app_cont, image, label, (app.name, app.version, app.installed_path)]
+        self._app_cont_map[app.fullname] = app_cont
+
+    def _update_tile(self, tile, app):
+        name, version, path = tile[3]
+        if app.name != name:
+            tile[2].set_text(app.name)
+        if app.version != version or app.installed_path != path:
+            # New version or location: its icon may have changed too
+            self._set_icon(tile[1], app)
+        tile[3] = (app.name, app.version, app.installed_path)
+
     def _launch_app(self, fullname):
         """Record which app was launched, show splash screen, then start it."""
         self._last_started_fullname = fullname
@@ -361,11 +361,11 @@ class ClientSession:
     def options(self, url, **kwargs):
         return self.request("OPTIONS", url, **kwargs)
 
-    def ws_connect(self, url, ssl=None):
-        return _WSRequestContextManager(self, self._ws_connect(url, ssl=ssl))
+    def ws_connect(self, url, ssl=None, max_msg_size=0):
+        ws_client = WebSocketClient(self._base_headers.copy(), max_msg_size)
+        return _WSRequestContextManager(self, self._ws_connect(ws_client, url, ssl=ssl), ws_client)
 
-    async def _ws_connect(self, url, ssl=None):
-        ws_client = WebSocketClient(self._base_headers.copy())
+    async def _ws_connect(self, ws_client, url, ssl=None):
         await ws_client.connect(url, ssl=ssl, handshake_request=self.request_raw)
         self._reader = ws_client.reader
         return ClientWebSocketResponse(ws_client)
@@ -56,8 +56,10 @@ class WebSocketClient:
     PING = 9
     PONG = 10
 
-    def __init__(self, params):
+    def __init__(self, params, max_msg_size=0):
         self.params = params
+        self.max_msg_size = max_msg_size  # 0 means unlimited
+        self.dropped = 0  # messages skipped for exceeding max_msg_size
         self.closed = False
         self.reader = None
         self.writer = None
@@ -169,7 +171,16 @@ class WebSocketClient:
             opcode, payload, final = await self._read_frame()
             while not final:
                 _, morepayload, final = await self._read_frame() # original opcode must be preserved
-                payload += morepayload
+                if payload is None or morepayload is None:
+                    payload = None
+                else:
+                    payload += morepayload
+                    if self.max_msg_size and len(payload) > self.max_msg_size:
+                        payload = None
+            if payload is None:
+                # Over max_msg_size: the payload was discarded while reading.
+                self.dropped += 1
+                continue
             send_opcode, data = self._process_websocket_frame(opcode, payload)
             if send_opcode:  # pragma: no cover
                 await self.send(data, send_opcode)
@@ -206,11 +217,20 @@ class WebSocketClient:
 
         if has_mask:  # pragma: no cover
             mask = await self.reader.readexactly(4)
+        if self.max_msg_size and length > self.max_msg_size:
+            await self._discard(length)
+            return opcode, None, fin
         payload = await self.reader.readexactly(length)
         if has_mask:  # pragma: no cover
             payload = bytes(x ^ mask[i % 4] for i, x in enumerate(payload))
         return opcode, payload, fin
 
+    async def _discard(self, length):
+        # Skip an oversized payload in small reads so it is never held in RAM.
+        while length > 0:
+            chunk = await self.reader.readexactly(min(length, 512))
+            length -= len(chunk)
+
 
 class ClientWebSocketResponse:
     def __init__(self, wsclient):
@@ -260,13 +280,25 @@ class ClientWebSocketResponse:
 
 
 class _WSRequestContextManager:
-    def __init__(self, client, request_co):
+    def __init__(self, client, request_co, ws_client=None):
         self.reqco = request_co
         self.client = client
+        self.ws_client = ws_client
+        self.response = None
 
     async def __aenter__(self):
-        return await self.reqco
+        self.response = await self.reqco
+        return self.response
 
     async def __aexit__(self, *args):
-        await self.client._reader.aclose()
+        # Close this connection's own reader: the session may be shared by
+        # several websockets, so client._reader is not necessarily ours.
+        if self.response is not None:
+            await self.response.ws.reader.aclose()
+        elif self.ws_client is not None:
+            # The handshake did not finish: close the socket if it got that far
+            if self.ws_client.reader is not None:
+                await self.ws_client.reader.aclose()
+        else:
+            await self.client._reader.aclose()
         return await asyncio.sleep(0)
@@ -38,6 +38,29 @@ class LogRecord:
         self.asctime = None
 
 
+class Lazy:
+    """Log argument that is only computed if the record is actually emitted.
+
+    Use with a %s placeholder on hot paths, for example:
+        logger.debug("stack used: %s", Lazy(micropython.stack_use))
+        logger.debug("data=%s", Lazy(preview, msg.data, 180))
+    """
+
+    def __init__(self, func, *args):
+        self.func = func
+        self.args = args
+
+    def __str__(self):
+        return str(self.func(*self.args))
+
+
+def preview(data, limit=80):
+    """Return str(data) cut to limit characters, for use with Lazy."""
+    if len(data) > limit:
+        data = data[:limit]
+    return str(data)
+
+
 class Handler:
     def __init__(self, level=NOTSET):
         self.level = level
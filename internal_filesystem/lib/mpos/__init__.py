@@ -28,6 +28,7 @@ from .lights import LightsManager
 from .battery_manager import BatteryManager
 from .webserver.webserver import WebServer
 from .notification_manager import NotificationManager, Notification
+from .status_service import StatusService
 
 # Common activities
 from .app.activities.chooser import ChooserActivity
@@ -83,7 +84,7 @@ __all__ = (
     "SharedPreferences",
     "ConnectivityManager", "DownloadManager", "WifiService", "AudioManager", "Intent",
     "ActivityNavigator", "AppManager", "TaskManager", "CameraManager", "BatteryManager", "WebServer",
-    "NotificationManager", "Notification",
+    "NotificationManager", "Notification", "StatusService",
     "LoRaManager", "IRManager", "GPSManager", "DeviceManager", "LightsManager",
     # Device and build info
     "DeviceInfo", "BuildInfo",
@@ -3,6 +3,9 @@ BatteryManager - Android-inspired battery and power information API.
 
 Provides direct query access to battery voltage, charge percentage, and raw ADC values.
 Handles ADC1/ADC2 pin differences on ESP32-S3 with adaptive caching to minimize WiFi interference.
+With start_sampling(), a background sampler keeps a filtered estimate that callers are
+served from. It samples ADC2 while WiFi is idle, and only briefly disables a connected
+WiFi once the estimate is older than ADC2_MAX_ESTIMATE_AGE_MS (see estimate_age_ms()).
 """
 
 import logging
@@ -24,12 +27,76 @@ _last_read_time = 0
 CACHE_DURATION_ADC1_MS = 30000   # 30 seconds (cheaper: no WiFi interference)
 CACHE_DURATION_ADC2_MS = 600000  # 600 seconds (expensive: requires WiFi disable)
 
+# Background sampling (see BatteryManager.start_sampling)
+SAMPLE_INTERVAL_MS = 30000
+# ADC2 samples wait for WiFi to be idle; an estimate this old is refreshed by
+# briefly disabling a connected WiFi, as often as the old read cache did
+ADC2_MAX_ESTIMATE_AGE_MS = CACHE_DURATION_ADC2_MS
+_MEASUREMENT_NOISE = 64.0  # variance of one 10-read average, in raw ADC units squared
+_PROCESS_NOISE = 0.1       # variance the battery may drift by per second, in raw ADC units squared
+_estimate_variance = None
+_sampler_timer = None
+
 
 def _is_adc2_pin(pin):
     """Check if pin is on ADC2 (ESP32-S3: GPIO11-20)."""
     return 11 <= pin <= 20
 
 
+def _get_wifi_service():
+    try:
+        # Needs actual path, not "from mpos" shorthand because it's mocked by test_battery_voltage.py
+        from mpos.net.wifi_service import WifiService
+        return WifiService
+    except ImportError:
+        return None
+
+
+def _measure(needs_wifi_disable):
+    """Average 10 ADC reads, with WiFi temporarily disabled if the pin is on ADC2."""
+    WifiService = _get_wifi_service() if needs_wifi_disable else None
+
+    # Temporarily disable WiFi for ADC2 reading
+    was_connected = False
+    if WifiService:
+        # This will raise RuntimeError if WiFi is already busy
+        was_connected = WifiService.temporarily_disable()
+        time.sleep(0.05)  # Brief delay for WiFi to fully disable
+
+    try:
+        total = sum(_adc.read() for _ in range(10))
+        return total / 10.0
+    finally:
+        # Re-enable WiFi (only if we disabled it)
+        if WifiService:
+            WifiService.temporarily_enable(was_connected)
+
+
+def _set_estimate(raw_value, now):
+    """Start the estimate over from a single measurement."""
+    global _cached_raw_adc, _last_read_time, _estimate_variance
+    _cached_raw_adc = raw_value
+    _estimate_variance = _MEASUREMENT_NOISE
+    _last_read_time = now
+
+
+def _fold_sample(raw_value, now):
+    """
+    Scalar Kalman update of the estimate. The battery is modelled as a random
+    walk, so a sample taken long after the previous one (as with ADC2) counts
+    for more than one of a quick series.
+    """
+    global _cached_raw_adc, _last_read_time, _estimate_variance
+    if _cached_raw_adc is None or _estimate_variance is None:
+        _set_estimate(raw_value, now)
+        return
+    variance = _estimate_variance + _PROCESS_NOISE * time.ticks_diff(now, _last_read_time) / 1000
+    gain = variance / (variance + _MEASUREMENT_NOISE)
+    _cached_raw_adc += gain * (raw_value - _cached_raw_adc)
+    _estimate_variance = (1 - gain) * variance
+    _last_read_time = now
+
+
 class BatteryManager:
     """
     Android-inspired BatteryManager for querying battery and power information.
@@ -85,7 +152,10 @@ class BatteryManager:
         """
         Read raw ADC value (0-4095) with adaptive caching.
 
-        On ESP32-S3 with ADC2, WiFi is temporarily disabled during reading.
+        While start_sampling() is active this returns the background estimate
+        unless force_refresh is set; if there is no estimate yet it takes the
+        first sample, and on ADC2 raises RuntimeError if WiFi is busy.
+        Otherwise, on ESP32-S3 with ADC2, WiFi is temporarily disabled during reading.
         Raises RuntimeError if WifiService is busy (connecting/scanning) when using ADC2.
 
         Args:
@@ -97,8 +167,6 @@ class BatteryManager:
         Raises:
             RuntimeError: If WifiService is busy (only when using ADC2)
         """
-        global _cached_raw_adc, _last_read_time
-
         # Desktop mode - return random value in typical ADC range
         if not _adc:
             import random
@@ -110,44 +178,21 @@ class BatteryManager:
         # Use different cache durations based on cost
         cache_duration = CACHE_DURATION_ADC2_MS if needs_wifi_disable else CACHE_DURATION_ADC1_MS
 
-        # Check cache
+        # Check cache; while the background sampler runs it keeps the
+        # estimate fresh, so it is always used
         current_time = time.ticks_ms()
+        if not force_refresh and _sampler_timer is not None:
+            if _cached_raw_adc is None and not BatteryManager.sample(current_time):
+                raise RuntimeError("No battery estimate yet, WiFi is busy")
+            return _cached_raw_adc
         if not force_refresh and _cached_raw_adc is not None:
             age = time.ticks_diff(current_time, _last_read_time)
             if age < cache_duration:
                 return _cached_raw_adc
 
-        # Import WifiService only if needed
-        WifiService = None
-        if needs_wifi_disable:
-            try:
-                # Needs actual path, not "from mpos" shorthand because it's mocked by test_battery_voltage.py
-                from mpos.net.wifi_service import WifiService
-            except ImportError:
-                pass
-
-        # Temporarily disable WiFi for ADC2 reading
-        was_connected = False
-        if needs_wifi_disable and WifiService:
-            # This will raise RuntimeError if WiFi is already busy
-            was_connected = WifiService.temporarily_disable()
-            time.sleep(0.05)  # Brief delay for WiFi to fully disable
-
-        try:
-            # Read ADC (average of 10 samples)
-            total = sum(_adc.read() for _ in range(10))
-            raw_value = total / 10.0
-
-            # Update cache
-            _cached_raw_adc = raw_value
-            _last_read_time = current_time
-
-            return raw_value
-
-        finally:
-            # Re-enable WiFi (only if we disabled it)
-            if needs_wifi_disable and WifiService:
-                WifiService.temporarily_enable(was_connected)
+        raw_value = _measure(needs_wifi_disable)
+        _set_estimate(raw_value, current_time)
+        return raw_value
 
     @staticmethod
     def read_battery_voltage(force_refresh=False, raw_adc_value=None):
@@ -182,7 +227,98 @@ class BatteryManager:
 
     @staticmethod
     def clear_cache():
-        """Clear the battery voltage cache to force fresh reading on next call."""
-        global _cached_raw_adc, _last_read_time
+        """
+        Clear the battery voltage cache to force fresh reading on next call.
+
+        While start_sampling() is active the sampler's estimate is kept, so
+        other readers aren't left without one; use read_raw_adc(force_refresh=True)
+        for a fresh reading instead.
+        """
+        global _cached_raw_adc, _last_read_time, _estimate_variance
+        if _sampler_timer is not None:
+            return
         _cached_raw_adc = None
         _last_read_time = 0
+        _estimate_variance = None
+
+    @staticmethod
+    def start_sampling(interval_ms=SAMPLE_INTERVAL_MS):
+        """
+        Sample the battery in the background every interval_ms and serve
+        read_raw_adc() and friends from the filtered estimate.
+
+        ADC1 pins are sampled on every tick. ADC2 pins are sampled while WiFi
+        is idle (not connected and not busy). While WiFi stays connected the
+        estimate ages, until it is ADC2_MAX_ESTIMATE_AGE_MS old (or there is
+        none yet): then one sample briefly disables WiFi and reconnects it.
+        Nothing is sampled while WiFi is busy connecting or scanning.
+        """
+        global _sampler_timer
+        if not _adc or _sampler_timer is not None:
+            return
+        import lvgl as lv
+        _sampler_timer = lv.timer_create(lambda t: BatteryManager.sample(), interval_ms, None)
+        BatteryManager.sample()
+
+    @staticmethod
+    def estimate_age_ms(now=None):
+        """
+        Get the age of the battery estimate, to tell the user it may be stale.
+
+        Returns:
+            int: Milliseconds since the last sample, or None if there is no estimate
+        """
+        if _cached_raw_adc is None:
+            return None
+        if now is None:
+            now = time.ticks_ms()
+        return time.ticks_diff(now, _last_read_time)
+
+    @staticmethod
+    def has_estimate():
+        """
+        Check whether reads can be served, i.e. the sampler is not waiting for its first sample.
+
+        Returns:
+            bool: False only while the sampler runs and has no sample yet
+        """
+        return not _adc or _sampler_timer is None or _cached_raw_adc is not None
+
+    @staticmethod
+    def stop_sampling():
+        global _sampler_timer
+        if _sampler_timer is not None:
+            _sampler_timer.delete()
+            _sampler_timer = None
+
+    @staticmethod
+    def sample(now=None):
+        """
+        Take one background sample. On ADC2 this skips a connected WiFi while
+        the estimate is younger than ADC2_MAX_ESTIMATE_AGE_MS, and a busy one always.
+
+        Returns:
+            bool: True if a sample was folded into the estimate
+        """
+        if not _adc:
+            return False
+        if now is None:
+            now = time.ticks_ms()
+        needs_wifi_disable = _adc_pin is not None and _is_adc2_pin(_adc_pin)
+        if needs_wifi_disable:
+            WifiService = _get_wifi_service()
+            if WifiService is not None:
+                if WifiService.wifi_busy:
+                    return False
+                if WifiService.is_connected():
+                    age = BatteryManager.estimate_age_ms(now)
+                    if age is not None and age < ADC2_MAX_ESTIMATE_AGE_MS:
+                        return False
+        try:
+            raw_value = _measure(needs_wifi_disable)
+        except RuntimeError as e:
+            # WiFi got busy in the meantime; try again on the next tick
+            if __debug__: logger.debug("Skipping battery sample: %s", e)
+            return False
+        _fold_sample(raw_value, now)
+        return True
@@ -1,5 +1,20 @@
 class GPSManager:
+    """GPS receiver pin/UART configuration plus a shared NMEA parser."""
+
     txPin = None
     rxPin = None
     connectionType = None
     connectionSpeed = None
+
+    _stream = None
+
+    @classmethod
+    def nmea_stream(cls):
+        """
+        Shared mpos.nmea.NMEAStream for the board's receiver. Feed it raw
+        bytes as they are read; its .fix holds the decoded state.
+        """
+        if cls._stream is None:
+            from .nmea import NMEAStream
+            cls._stream = NMEAStream()
+        return cls._stream
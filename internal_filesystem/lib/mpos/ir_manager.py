@@ -1,5 +1,99 @@
+"""
+IR pin configuration plus hardware-timed capture and transmit.
+
+Boards set txPin/rxPin. On ESP32 builds with the _ir_rmt module, capture
+runs on the RMT receiver: edges are timestamped by the peripheral, so pulse
+widths stay exact under Wi-Fi or display load, and a finished frame is read
+as an array('H') of mark/space durations in microseconds. Transmit uses
+esp32.RMT with hardware carrier generation. Decode frames with
+mpos.ir_protocols.
+
+Usage:
+    if IRManager.start_capture():
+        ...
+        durations = IRManager.read_capture()  # poll, e.g. from an lv.timer
+        if durations:
+            result = ir_protocols.decode(durations)
+        ...
+        IRManager.stop_capture()
+
+    IRManager.send(ir_protocols.encode_nec(7, 2, samsung=True))
+"""
+
+from array import array
+
+try:
+    import _ir_rmt
+except ImportError:
+    _ir_rmt = None
+
+
 class IRManager:
-    """Simple IR manager for sharing RX/TX pin configuration."""
+    """Shares RX/TX pin configuration and owns the RMT capture channel."""
 
     txPin = None
     rxPin = None
+
+    # A frame ends after this much idle line (NEC repeat gaps are ~40ms)
+    IDLE_US = 12000
+    # Longest frame kept, in durations (NEC needs 67)
+    MAX_DURATIONS = 256
+
+    _receiver = None
+    _buffer = None
+
+    @classmethod
+    def has_hw_capture(cls):
+        """True when capture can use the RMT peripheral and an RX pin is set."""
+        return _ir_rmt is not None and cls.rxPin is not None
+
+    @classmethod
+    def start_capture(cls, idle_us=None):
+        """Start capturing frames on rxPin. Returns False without RMT capture."""
+        if not cls.has_hw_capture():
+            return False
+        cls.stop_capture()
+        if cls._buffer is None:
+            cls._buffer = array("H", bytes(2 * cls.MAX_DURATIONS))
+        # One RMT symbol holds two durations
+        cls._receiver = _ir_rmt.RMTRx(
+            cls.rxPin,
+            idle_us=idle_us or cls.IDLE_US,
+            symbols=cls.MAX_DURATIONS // 2,
+        )
+        return True
+
+    @classmethod
+    def read_capture(cls):
+        """Return the durations (us) of the last finished frame, or None."""
+        if cls._receiver is None:
+            return None
+        n = cls._receiver.read(cls._buffer)
+        if not n:
+            return None
+        return cls._buffer[:n]
+
+    @classmethod
+    def stop_capture(cls):
+        if cls._receiver is not None:
+            cls._receiver.deinit()
+            cls._receiver = None
+
+    @classmethod
+    def send(cls, durations, freq=38000, duty=33):
+        """
+        Transmit mark/space durations (us, first mark first) on txPin with a
+        freq Hz carrier. Blocks until sent.
+        """
+        if cls.txPin is None:
+            raise ValueError("IRManager.txPin is not set")
+        from esp32 import RMT
+
+        # Some boards share the TX pin with an ADC that takes the GPIO back
+        # after every reading, so the channel is set up for each send.
+        rmt = RMT(0, pin=cls.txPin, clock_div=80, tx_carrier=(freq, duty, 1))  # 1us resolution
+        try:
+            rmt.write_pulses(tuple(min(d, 32767) for d in durations))
+            rmt.wait_done(timeout=200)
+        finally:
+            rmt.deinit()
@@ -0,0 +1,171 @@
+"""
+IR protocol decoders and encoders working on duration arrays.
+
+A frame is a sequence of mark/space durations in microseconds, first mark
+first, as captured by IRManager (or any other source, e.g. a recorded trace
+in a test). The trailing space is never part of a capture: the frame ends
+when the line goes idle.
+
+Decoders return (cmd, addr, ext) like the ir_rx callbacks do, with cmd set
+to one of the negative error codes below when the frame doesn't match.
+Encoders return a list of durations for IRManager.send().
+
+Timing thresholds follow Peter Hinch's micropython_ir decoders.
+"""
+
+# Result/error codes, same values as ir_rx.IR_RX
+REPEAT = -1
+BADSTART = -2
+BADBLOCK = -3
+BADREP = -4
+OVERRUN = -5
+BADDATA = -6
+BADADDR = -7
+
+
+def _bits_lsb_first(durations, start, count, threshold):
+    # Bit k is 1 when durations[start + 2 * k] exceeds threshold
+    val = 0
+    bit = 1
+    i = start
+    for _ in range(count):
+        if durations[i] > threshold:
+            val |= bit
+        bit <<= 1
+        i += 2
+    return val
+
+
+def decode_nec(durations, extended=True, samsung=False):
+    """NEC / Samsung: 9ms (4.5ms) mark, 4.5ms space, 32 pulse-distance bits."""
+    n = len(durations)
+    if n < 2:
+        return BADSTART, 0, 0
+    if durations[0] < (2500 if samsung else 4000):
+        return BADSTART, 0, 0
+    space = durations[1]
+    if space <= 3000:
+        if space > 1700:  # 2.25ms space: repeat code, one stop mark
+            return (REPEAT if n == 3 else BADREP), 0, 0
+        return BADSTART, 0, 0
+    if n < 67:
+        return BADBLOCK, 0, 0
+    val = _bits_lsb_first(durations, 3, 32, 1120)
+    addr = val & 0xFF
+    cmd = (val >> 16) & 0xFF
+    if cmd != (val >> 24) ^ 0xFF:
+        return BADDATA, 0, 0
+    if addr != ((val >> 8) ^ 0xFF) & 0xFF:  # 8 bit addr doesn't match check
+        if not extended:
+            return BADADDR, 0, 0
+        addr |= val & 0xFF00
+    return cmd, addr, 0
+
+
+def decode_sony(durations):
+    """Sony SIRC: 2.4ms mark, 600us space, 12/15/20 pulse-width bits."""
+    n = len(durations)
+    bits = (n - 1) // 2
+    if n > 41:
+        return OVERRUN, 0, 0
+    if bits not in (12, 15, 20):
+        return BADBLOCK, 0, 0
+    if not 1800 < durations[0] < 3000 or not 350 < durations[1] < 1000:
+        return BADSTART, 0, 0
+    val = _bits_lsb_first(durations, 2, bits, 900)
+    cmd = val & 0x7F
+    val >>= 7
+    if bits < 20:
+        return cmd, val & 0xFF, 0
+    return cmd, val & 0x1F, val >> 5
+
+
+def decode_tcl(durations):
+    """TCL: 4ms mark, 4ms space, 24 NEC-style bits without complements."""
+    n = len(durations)
+    if n < 4:
+        return BADBLOCK, 0, 0
+    if durations[0] < 3000 or durations[1] < 3000:
+        return BADSTART, 0, 0
+    if n < 2 + 24 * 2:
+        return BADBLOCK, 0, 0
+    val = _bits_lsb_first(durations, 3, 24, 1200)
+    return (val >> 16) & 0xFF, val & 0xFFFF, 0
+
+
+def decode(durations):
+    """
+    Pick a protocol from the header mark and decode with it. Returns
+    (protocol, cmd, addr, ext) with protocol "nec", "samsung", "tcl" or
+    "sony", or None if the frame doesn't decode.
+    """
+    n = len(durations)
+    if n < 2:
+        return None
+    first = durations[0]
+    if first >= 6000:
+        protocol = "nec"
+        cmd, addr, ext = decode_nec(durations)
+    elif first > 3000:
+        # Samsung (4.5ms) and TCL (4ms) headers are too close to tell apart
+        # reliably; their frame lengths differ though (67 and 51)
+        if n >= 67:
+            protocol = "samsung"
+            cmd, addr, ext = decode_nec(durations, samsung=True)
+        else:
+            protocol = "tcl"
+            cmd, addr, ext = decode_tcl(durations)
+    elif first > 1800:
+        protocol = "sony"
+        cmd, addr, ext = decode_sony(durations)
+    else:
+        return None
+    if cmd < 0 and cmd != REPEAT:
+        return None
+    return protocol, cmd, addr, ext
+
+
+def encode_nec(addr, cmd, samsung=False):
+    durations = [4500, 4500] if samsung else [9000, 4500]
+    if addr < 256:  # Short address: append complement
+        if samsung:
+            addr |= addr << 8
+        else:
+            addr |= (addr ^ 0xFF) << 8
+    val = addr | ((cmd | ((cmd ^ 0xFF) << 8)) << 16)
+    for _ in range(32):
+        durations.append(563)
+        durations.append(1687 if val & 1 else 563)
+        val >>= 1
+    durations.append(563)
+    return durations
+
+
+def encode_sony(addr, cmd, bits=12, ext=0):
+    if bits not in (12, 15, 20):
+        raise ValueError("bits must be 12, 15 or 20")
+    v = cmd & 0x7F
+    if bits == 15:
+        v |= (addr & 0xFF) << 7
+    else:
+        v |= (addr & 0x1F) << 7
+        if bits == 20:
+            v |= (ext & 0xFF) << 12
+    durations = [2400, 600]
+    for _ in range(bits):
+        durations.append(1200 if v & 1 else 600)
+        durations.append(600)
+        v >>= 1
+    durations.pop()  # no trailing space
+    return durations
+
+
+def encode_tcl(addr, cmd):
+    durations = [4000, 4000]
+    val = (addr & 0xFFFF) | ((cmd & 0xFF) << 16)
+    for _ in range(24):
+        durations.append(500)
+        durations.append(1950 if val & 1 else 500)
+        val >>= 1
+    durations.append(500)
+    return durations
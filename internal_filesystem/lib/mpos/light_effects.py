@@ -0,0 +1,225 @@
+"""
+NeoPixel effects for LightsManager.play().
+
+Effects render straight into the strip's byte buffer (wire order, usually
+GRB) with integer math only. Whole-strip work is done with slice copies
+(a solid fill doubles a 3 byte seed, a chase copies a window out of a
+pre-tiled pattern), so a frame costs a handful of Python operations no
+matter how many LEDs there are.
+
+An effect has:
+    duration: total run time in ms, or None to run until stopped
+    setup(num_leds, order): called once by play(), precompute here
+    render(buf, t_ms): draw the frame for t_ms since start into buf,
+        return True if buf changed (unchanged frames aren't sent)
+
+Usage:
+    from mpos import LightsManager
+    from mpos.light_effects import Breathe, Chase
+
+    LightsManager.play(Breathe((0, 0, 255), period_ms=2000))
+    LightsManager.play(Chase((255, 0, 0), step_ms=80, width=2))
+    LightsManager.stop()
+"""
+
+# Brightness levels are 0..256 so that (c * level) >> 8 spans 0..c
+
+
+def pack(color, order):
+    """Return (r, g, b) as 3 bytes in wire order, order as in NeoPixel.ORDER."""
+    out = bytearray(3)
+    out[order[0]] = color[0]
+    out[order[1]] = color[1]
+    out[order[2]] = color[2]
+    return out
+
+
+def encode(colors, num_leds, order):
+    """
+    Encode a frame: one (r, g, b) for the whole strip, or a list with one per
+    LED (shorter lists are padded with black).
+    """
+    buf = bytearray(3 * num_leds)
+    if colors and isinstance(colors[0], int):
+        fill(buf, pack(colors, order))
+        return buf
+    for i in range(min(len(colors), num_leds)):
+        buf[3 * i:3 * i + 3] = pack(colors[i], order)
+    return buf
+
+
+def fill(buf, seed):
+    """Fill buf with the 3 byte seed, doubling the copied span each pass."""
+    n = len(buf)
+    if n < 3:
+        return
+    buf[0] = seed[0]
+    buf[1] = seed[1]
+    buf[2] = seed[2]
+    mv = memoryview(buf)
+    done = 3
+    while done < n:
+        k = done if done < n - done else n - done
+        mv[done:done + k] = mv[0:k]
+        done += k
+
+
+def _scaled_fill(buf, seed, level):
+    fill(buf, ((seed[0] * level) >> 8, (seed[1] * level) >> 8, (seed[2] * level) >> 8))
+
+
+class Fade:
+    """Fade the whole strip from one color to another, then hold it."""
+
+    def __init__(self, start, end, duration_ms):
+        self.start = start
+        self.end = end
+        self.duration = max(1, duration_ms)
+        self._a = None
+        self._b = None
+
+    def setup(self, num_leds, order):
+        self._a = pack(self.start, order)
+        self._b = pack(self.end, order)
+
+    def render(self, buf, t_ms):
+        if t_ms > self.duration:
+            t_ms = self.duration
+        level = (t_ms << 8) // self.duration
+        a = self._a
+        b = self._b
+        fill(buf, (
+            a[0] + (((b[0] - a[0]) * level) >> 8),
+            a[1] + (((b[1] - a[1]) * level) >> 8),
+            a[2] + (((b[2] - a[2]) * level) >> 8),
+        ))
+        return True
+
+
+class Breathe:
+    """
+    Pulse one color between off and full brightness. The ramp is squared
+    so it looks even to the eye. Runs forever unless cycles is given.
+    """
+
+    def __init__(self, color, period_ms=2000, cycles=None):
+        self.color = color
+        self.period = max(2, period_ms)
+        self.duration = None if cycles is None else cycles * self.period
+        self._seed = None
+        self._level = -1
+
+    def setup(self, num_leds, order):
+        self._seed = pack(self.color, order)
+        self._level = -1
+
+    def render(self, buf, t_ms):
+        if self.duration is not None and t_ms >= self.duration:
+            level = 0
+        else:
+            tri = ((t_ms % self.period) << 9) // self.period  # 0..511
+            if tri > 256:
+                tri = 512 - tri
+            level = (tri * tri) >> 8
+        if level == self._level:
+            return False
+        self._level = level
+        _scaled_fill(buf, self._seed, level)
+        return True
+
+
+class Chase:
+    """
+    Move a band of width lit LEDs (followed by gap dark ones, default: the
+    rest of the strip) one position every step_ms. A tail fades the LEDs
+    behind the band out in that many steps.
+    """
+
+    def __init__(self, color, step_ms=100, width=1, gap=None, tail=0, reverse=False, duration_ms=None):
+        self.color = color
+        self.step_ms = max(1, step_ms)
+        self.width = max(1, width)
+        self.gap = gap
+        self.tail = tail
+        self.reverse = reverse
+        self.duration = duration_ms
+        self._tiled = None
+        self._period = 1
+        self._pos = -1
+
+    def setup(self, num_leds, order):
+        gap = self.gap if self.gap is not None else max(0, num_leds - self.width)
+        period = self.width + gap
+        # One period of the pattern in wire order: the band leads, the tail
+        # trails behind it
+        pattern = bytearray(3 * period)
+        seed = pack(self.color, order)
+        for i in range(self.width):
+            pattern[3 * i:3 * i + 3] = seed
+        for k in range(1, min(self.tail, gap) + 1):
+            level = ((self.tail + 1 - k) << 8) // (self.tail + 1)
+            i = (period - k) % period
+            pattern[3 * i:3 * i + 3] = bytes((seed[0] * level >> 8, seed[1] * level >> 8, seed[2] * level >> 8))
+        # Tile it so every rotation is one contiguous window of num_leds
+        reps = (num_leds + period - 1) // period + 1
+        self._tiled = memoryview(pattern * reps)
+        self._period = period
+        self._pos = -1
+
+    def render(self, buf, t_ms):
+        # The band moves towards higher indices: LED i shows pattern[i - pos]
+        pos = (t_ms // self.step_ms) % self._period
+        if pos == self._pos:
+            return False
+        self._pos = pos
+        offset = pos if self.reverse else (self._period - pos) % self._period
+        buf[:] = self._tiled[3 * offset:3 * offset + len(buf)]
+        return True
+
+
+class Keyframes:
+    """
+    Show a sequence of frames, each held for its duration. frames is a list
+    of (colors, duration_ms), colors as in encode(). Frames are encoded once
+    at setup, so playing them is one buffer copy per change.
+    """
+
+    def __init__(self, frames, loop=True):
+        self.frames = frames
+        self.loop = loop
+        self._encoded = None
+        self._ends = None
+        self._index = -1
+        total = 0
+        for _, ms in frames:
+            total += max(1, ms)
+        self._total = total
+        self.duration = None if loop else total
+
+    def setup(self, num_leds, order):
+        self._encoded = [encode(colors, num_leds, order) for colors, _ in self.frames]
+        ends = []
+        end = 0
+        for _, ms in self.frames:
+            end += max(1, ms)
+            ends.append(end)
+        self._ends = ends
+        self._index = -1
+
+    def render(self, buf, t_ms):
+        if not self._encoded:
+            return False
+        if self.loop:
+            t_ms %= self._total
+        ends = self._ends
+        last = len(ends) - 1
+        # Frames are usually stepped through in order, so start from the
+        # current one instead of searching
+        i = self._index if 0 <= self._index and (self._index == 0 or ends[self._index - 1] <= t_ms) else 0
+        while i < last and ends[i] <= t_ms:
+            i += 1
+        if i == self._index:
+            return False
+        self._index = i
+        buf[:] = self._encoded[i]
+        return True
@@ -1,18 +1,33 @@
 # LightsManager - Simple LED Control Service for MicroPythonOS
-# Provides one-shot LED control for NeoPixel RGB LEDs
-# Apps implement custom animations using the update_frame() pattern
+# Provides one-shot LED control for NeoPixel RGB LEDs, plus play()/stop() for
+# timer-driven effects from mpos.light_effects
+
+import time
 
 import logging
 logger = logging.getLogger(__name__)
 
+# 0 is taken by task_handler.py, 1 by ConnectivityManager
+_TIMER_ID = 2
+
 
 class LightsManager:
     def __init__(self):
         self._neopixel = None
         self._neopixel_pin = None
         self._num_leds = 0
+        # Animation engine
+        self._effect = None
+        self._frame = None
+        self._order = (0, 1, 2)
+        self._start_ms = 0
+        self._timer = None
+        self._lv_timer = False
+        self.frame_sink = None  # optional callback(frame) for every frame sent
 
     def _init_neopixel(self, clear_on_init):
+        self.stop()
+        self._frame = None
         if self._neopixel_pin is None or self._num_leds <= 0:
             self._neopixel = None
             return False
@@ -190,5 +205,115 @@ class LightsManager:
 
         return self.set_all(*color) and self.write()
 
+    # --- Animation engine ---
+
+    def _bind_frame(self):
+        # Render straight into the driver's own buffer when it has one, so a
+        # frame goes out with a single write() (one bitstream/RMT transfer)
+        np = self._neopixel
+        buf = getattr(np, "buf", None)
+        if isinstance(buf, bytearray) and len(buf) == 3 * self._num_leds:
+            self._frame = buf
+            self._order = getattr(np, "ORDER", (0, 1, 2))[:3]
+        else:
+            self._frame = bytearray(3 * self._num_leds)
+            self._order = (0, 1, 2)
+
+    def _send_frame(self):
+        np = self._neopixel
+        frame = self._frame
+        if frame is not getattr(np, "buf", None):
+            # Driver without a byte buffer
+            for i in range(self._num_leds):
+                np[i] = (frame[3 * i], frame[3 * i + 1], frame[3 * i + 2])
+        np.write()
+        if self.frame_sink:
+            self.frame_sink(frame)
+
+    def play(self, effect, fps=50, start=True):
+        """
+        Run an effect from mpos.light_effects on a fixed-rate timer, replacing
+        the one playing. Frames are rendered with integer math into the strip
+        buffer and only sent when they change.
+
+        Args:
+            effect: Effect object (Fade, Breathe, Chase, Keyframes, ...)
+            fps: Frame rate of the timer
+            start: False to set up without a timer and drive step() yourself
+
+        Returns:
+            bool: True if playing, False if LEDs unavailable
+        """
+        self.stop()
+        if not self._neopixel:
+            return False
+        if self._frame is None:
+            self._bind_frame()
+        effect.setup(self._num_leds, self._order)
+        self._effect = effect
+        self._start_ms = time.ticks_ms()
+        self.step(self._start_ms)
+        if start and self._effect is not None:
+            period = max(1, 1000 // fps)
+            try:
+                from machine import Timer
+                self._timer = Timer(_TIMER_ID)
+                self._timer.init(period=period, mode=Timer.PERIODIC, callback=self._on_timer)
+                self._lv_timer = False
+            except Exception:
+                # No free hardware timer (or desktop): tick from LVGL instead
+                import lvgl as lv
+                self._timer = lv.timer_create(self._on_timer, period, None)
+                self._lv_timer = True
+        return True
+
+    def step(self, now_ms=None):
+        """
+        Render and send the frame for now_ms (default: now). Called by the
+        timer; call it directly after play(start=False).
+
+        Returns:
+            bool: True while the effect is still running
+        """
+        effect = self._effect
+        if effect is None:
+            return False
+        if now_ms is None:
+            now_ms = time.ticks_ms()
+        t = time.ticks_diff(now_ms, self._start_ms)
+        done = effect.duration is not None and t >= effect.duration
+        if done:
+            t = effect.duration
+        if effect.render(self._frame, t):
+            self._send_frame()
+        if done:
+            self.stop()
+            return False
+        return True
+
+    def _on_timer(self, _timer):
+        try:
+            self.step()
+        except Exception as e:
+            logger.error("Effect error: %s", e)
+            self.stop()
+
+    def stop(self):
+        """Stop the playing effect. The LEDs keep its last frame."""
+        self._effect = None
+        if self._timer is not None:
+            if self._lv_timer:
+                self._timer.delete()
+            else:
+                self._timer.deinit()
+            self._timer = None
+
+    def is_playing(self):
+        """
+        Returns:
+            bool: True while an effect is playing
+        """
+        return self._effect is not None
+
 
 LightsManager = LightsManager()
@@ -71,7 +71,7 @@ class DownloadManager:
     @classmethod
     def download_url(cls, url, outfile=None, total_size=None,
                     progress_callback=None, chunk_callback=None, headers=None,
-                    speed_callback=None, redact_url=False):
+                    speed_callback=None, redact_url=False, response_info=None):
         """Download a URL with flexible output modes (sync or async wrapper).
 
         This method automatically detects whether it's being called from an async context
@@ -94,6 +94,11 @@ class DownloadManager:
                 logs; path + query are replaced with "/...REDACTED...".
                 Defaults to False to preserve current debug output for
                 callers fetching public URLs (app icons, OS updates, etc.).
+            response_info (dict, optional): Filled with the 'status' and
+                'headers' of the response, e.g. to read ETag/Last-Modified.
+                Pass If-None-Match/If-Modified-Since in headers to make the
+                request conditional: a 304 Not Modified returns right away
+                (b'' or True) with response_info['status'] == 304.
 
         Returns:
             bytes: Downloaded content (if outfile and chunk_callback are None)
@@ -111,12 +116,12 @@ class DownloadManager:
                 # We're in an async context, return the coroutine
                 return cls._download_url_async(url, outfile, total_size,
                                               progress_callback, chunk_callback, headers,
-                                              speed_callback, redact_url)
+                                              speed_callback, redact_url, response_info)
             except RuntimeError:
                 # No running event loop, run synchronously
                 return asyncio.run(cls._download_url_async(url, outfile, total_size,
                                                           progress_callback, chunk_callback, headers,
-                                                          speed_callback, redact_url))
+                                                          speed_callback, redact_url, response_info))
         except ImportError:
             # asyncio not available, shouldn't happen but handle gracefully
             raise ImportError("asyncio module not available")
@@ -148,7 +153,7 @@ class DownloadManager:
     @classmethod
     async def _download_url_async(cls, url, outfile=None, total_size=None,
                                  progress_callback=None, chunk_callback=None, headers=None,
-                                 speed_callback=None, redact_url=False):
+                                 speed_callback=None, redact_url=False, response_info=None):
         """Download a URL with flexible output modes.
         
         Args:
@@ -162,6 +167,8 @@ class DownloadManager:
             redact_url (bool, optional): When True, log a redacted URL
                 (scheme://host only) and suppress the response-headers dump.
                 See `download_url` for details and use cases.
+            response_info (dict, optional): Filled with the response 'status'
+                and 'headers'. See `download_url`.
 
         Returns:
             bytes: Downloaded content (if outfile and chunk_callback are None)
@@ -235,6 +242,13 @@ class DownloadManager:
                             raise OSError(-110, "Server does not support resume (HTTP %s)" % response.status)
                     else:
                         # ---- one-time setup, runs only on the first connection ----
+                        if response_info is not None:
+                            response_info['status'] = response.status
+                            response_info['headers'] = response.headers
+                        if response.status == 304:
+                            # Not Modified: the caller's copy is current, no body follows
+                            if __debug__: logger.debug("Not modified: %s", log_url)
+                            return True if chunk_callback or outfile else b''
                         # When redacting, suppress the headers dump entirely - response
                         # headers can include set-cookie / cf-ray tokens that correlate
                         # to a secret-bearing URL.
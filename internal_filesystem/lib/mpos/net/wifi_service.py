@@ -11,6 +11,7 @@ This service works alongside ConnectivityManager which monitors connection statu
 """
 
 import _thread
+import binascii
 import logging
 import time
 
@@ -22,6 +23,12 @@ logger = logging.getLogger(__name__)
 WIFI_SERVICE_PREFS_KEY = "com.micropythonos.system.wifiservice" # com.micropythonos.settings.wifi would make more sense but legacy devices use this
 HOTSPOT_PREFS_KEY = "com.micropythonos.settings.hotspot"
 
+# How often a pending connection is checked, and how long it may take
+CONNECT_POLL_MS = 100
+CONNECT_TIMEOUT_MS = 13000
+# The remembered access point gets a shorter try before falling back to a scan
+FAST_PATH_TIMEOUT_MS = 6000
+
 # Try to import network module (not available on desktop)
 HAS_NETWORK_MODULE = False
 try:
@@ -196,9 +203,15 @@ class WifiService:
             network_module: Network module for dependency injection (testing)
             time_module: Time module for dependency injection (testing)
 
+        If the last network we connected to is still saved, it is tried first
+        on the access point (BSSID) we joined last time, without scanning.
+
         Returns:
             bool: True if successfully connected, False otherwise
         """
+        if WifiService._connect_last_ap(network_module, time_module):
+            return True
+
         # Scan for available networks using internal method
         networks = WifiService._scan_networks_raw(network_module)
 
@@ -226,6 +239,7 @@ class WifiService:
                     time_module=time_module,
                 ):
                     if __debug__: logger.debug("Connected to '%s'", ssid)
+                    WifiService._remember_ap(ssid, n[1])
                     return True
                 else:
                     logger.error("Failed to connect to '%s'", ssid)
@@ -245,6 +259,7 @@ class WifiService:
                     time_module=time_module,
                 ):
                     if __debug__: logger.debug("Connected to hidden network '%s'", ssid)
+                    WifiService._remember_ap(ssid, None)
                     return True
                 else:
                     logger.info("Failed to connect to hidden network '%s'", ssid)
@@ -253,7 +268,114 @@ class WifiService:
         return False
 
     @staticmethod
-    def attempt_connecting(ssid, password, network_module=None, time_module=None):
+    def _connect_last_ap(network_module=None, time_module=None):
+        """
+        Fast path for connect(): rejoin the last access point without a scan.
+
+        Returns:
+            bool: True if connected, False if there is no usable last AP or it didn't answer
+        """
+        if WifiService._is_desktop_mode(network_module):
+            return False
+        ssid = mpos.shared_preferences.SharedPreferences(WIFI_SERVICE_PREFS_KEY).get_string("last_ssid", None)
+        config = WifiService.access_points.get(ssid) if ssid else None
+        if not config or not config.get("bssid"):
+            return False
+
+        if __debug__: logger.debug("Trying last access point of '%s' (%s)", ssid, config.get("bssid"))
+        net = WifiService._get_network_module(network_module)
+        try:
+            WifiService._get_sta_wlan(net).active(True)
+            bssid = binascii.unhexlify(config.get("bssid"))
+        except Exception as e:
+            logger.info("Fast reconnect unavailable: %s", e)
+            return False
+
+        if WifiService.attempt_connecting(
+            ssid,
+            config.get("password"),
+            network_module=network_module,
+            time_module=time_module,
+            bssid=bssid,
+            timeout_ms=FAST_PATH_TIMEOUT_MS,
+        ):
+            return True
+
+        # Stop the driver's own retries before scanning
+        try:
+            WifiService._get_sta_wlan(net).disconnect()
+        except Exception:
+            pass
+        return False
+
+    @staticmethod
+    def _remember_ap(ssid, bssid):
+        """
+        Persist the network and access point we just joined for _connect_last_ap().
+        Only writes when something changed, to spare the flash.
+        """
+        config = WifiService.access_points.get(ssid)
+        if config is None:
+            return
+        bssid_hex = None
+        if isinstance(bssid, (bytes, bytearray)) and len(bssid) == 6:
+            bssid_hex = binascii.hexlify(bssid).decode()
+
+        prefs = mpos.shared_preferences.SharedPreferences(WIFI_SERVICE_PREFS_KEY)
+        if prefs.get_string("last_ssid", None) == ssid and config.get("bssid") == bssid_hex:
+            return
+
+        config = dict(config)
+        if bssid_hex:
+            config["bssid"] = bssid_hex
+        else:
+            config.pop("bssid", None)
+        editor = prefs.edit()
+        editor.put_dict_item("access_points", ssid, config)
+        editor.put_string("last_ssid", ssid)
+        editor.commit()
+        WifiService.access_points[ssid] = config
+
+    @staticmethod
+    def _wait_for_connection(wlan, net, time_mod, timeout_ms):
+        """
+        Follow the station's status until it is connected, reports a failure,
+        gets deactivated or timeout_ms passes.
+
+        Returns:
+            bool: True if connected
+        """
+        # Terminal states reported by wlan.status(); ports without it are only
+        # checked with isconnected() and active()
+        failed = (
+            getattr(net, "STAT_WRONG_PASSWORD", None),
+            getattr(net, "STAT_NO_AP_FOUND", None),
+            getattr(net, "STAT_CONNECT_FAIL", None),
+        )
+        status = getattr(wlan, "status", None)
+        waited = 0
+        while True:
+            if wlan.isconnected():
+                if __debug__: logger.debug("Connected after %s ms", waited)
+                return True
+            if not wlan.active():
+                # WiFi was disabled during connection attempt
+                if __debug__: logger.debug("WiFi disabled during connection, aborting")
+                return False
+            if status:
+                state = status()
+                if state is not None and state in failed:
+                    logger.info("Connection failed with status %s", state)
+                    return False
+            if waited >= timeout_ms:
+                logger.info("Connection timeout after %s ms", waited)
+                return False
+            time_mod.sleep_ms(CONNECT_POLL_MS)
+            waited += CONNECT_POLL_MS
+
+    @staticmethod
+    def attempt_connecting(ssid, password, network_module=None, time_module=None,
+                           bssid=None, timeout_ms=CONNECT_TIMEOUT_MS):
         """
         Attempt to connect to a specific WiFi network.
 
@@ -262,6 +384,8 @@ class WifiService:
             password: Network password
             network_module: Network module for dependency injection (testing)
             time_module: Time module for dependency injection (testing)
+            bssid: Optional access point MAC (6 bytes) to join directly
+            timeout_ms: How long to wait for the connection
 
         Returns:
             bool: True if successfully connected, False otherwise
@@ -286,32 +410,24 @@ class WifiService:
 
         try:
             wlan = WifiService._get_sta_wlan(net)
-            wlan.connect(ssid, password)
-
-            # Wait up to 13 seconds for connection
-            for i in range(13):
-                if wlan.isconnected():
-                    if __debug__: logger.debug("Connected to '%s' after %s seconds with IP: %s", ssid, i+1, wlan.ipconfig('addr4'))
-
-                    # Sync time from NTP server if possible
-                    try:
-                        mpos.time.sync_time()
-                    except Exception as e:
-                        logger.warning("Could not sync time: %s", e)
+            if bssid:
+                wlan.connect(ssid, password, bssid=bssid)
+            else:
+                wlan.connect(ssid, password)
 
-                    WifiService._needs_hotspot_restore = False
-                    return True
+            if WifiService._wait_for_connection(wlan, net, time_mod, timeout_ms):
+                if __debug__: logger.debug("Connected to '%s' with IP: %s", ssid, wlan.ipconfig('addr4'))
 
-                elif not wlan.active():
-                    # WiFi was disabled during connection attempt
-                    if __debug__: logger.debug("WiFi disabled during connection, aborting")
-                    WifiService._restore_hotspot_if_needed(network_module=network_module)
-                    return False
+                # Sync time from NTP server if possible
+                try:
+                    mpos.time.sync_time()
+                except Exception as e:
+                    logger.warning("Could not sync time: %s", e)
 
-                if __debug__: logger.debug("Waiting for connection, attempt %s/10", i+1)
-                time_mod.sleep(1)
+                WifiService._needs_hotspot_restore = False
+                return True
 
-            logger.info("Connection timeout for '%s'", ssid)
+            logger.info("Could not connect to '%s'", ssid)
             WifiService._restore_hotspot_if_needed(network_module=network_module)
             return False
 
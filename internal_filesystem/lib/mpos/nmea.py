@@ -0,0 +1,466 @@
+# Streaming NMEA 0183 parser.
+#
+# Raw receiver bytes (straight from UART.readinto(), any chunking) are
+# assembled into one fixed sentence buffer, checksummed and split in place,
+# and decoded into the preallocated fields of a GPSFix. Numbers are parsed
+# from the bytes into scaled integers, so no str, list or float objects are
+# created per sentence; the float properties of GPSFix only allocate when an
+# app reads them.
+#
+# Understands RMC, GGA, GSA, GSV and GLL from any talker (GP, GN, GL, GA, BD...).
+
+from array import array
+import time
+
+_MAX_SENTENCE = 96  # NMEA allows 82 chars; leave room for proprietary extras
+_MAX_FIELDS = 32
+
+_DOLLAR = 0x24
+_STAR = 0x2A
+_COMMA = 0x2C
+_DOT = 0x2E
+_MINUS = 0x2D
+_CR = 0x0D
+_LF = 0x0A
+
+
+def _hex(b):
+    if 48 <= b <= 57:
+        return b - 48
+    b |= 0x20
+    if 97 <= b <= 102:
+        return b - 87
+    return -1
+
+
+class GPSFix:
+    """
+    Latest receiver state, updated in place by NMEAStream.
+
+    Positions are micro-degrees, speed is hundredths of a knot, course tenths
+    of a degree, altitude decimetres and DOPs hundredths. Fields are None
+    until a sentence has reported them.
+    """
+
+    def __init__(self, max_sats=32):
+        self.lat_e6 = None
+        self.lon_e6 = None
+        self.alt_dm = None
+        self.speed_ckn = None
+        self.course_ddeg = None
+
+        self.valid = False       # RMC status "A"
+        self.quality = 0         # GGA fix quality
+        self.sats_used = 0
+        self.hdop_c = None
+
+        self.hour = None         # UTC time of the last RMC/GGA/GLL
+        self.minute = None
+        self.second = None
+        self.year = None         # UTC date of the last RMC (20yy)
+        self.month = None
+        self.day = None
+
+        # Diagnostics: raw status characters as ints (e.g. ord("A")), or None
+        self.rmc_status = None
+        self.gga_quality = None
+        self.gsa_mode = None
+        self.gsa_fix_type = None
+        self.gsa_pdop_c = None
+        self.gsa_hdop_c = None
+        self.gsa_vdop_c = None
+        self.gll_status = None
+        self.gsv_total = None
+
+        # Satellites in view: parallel arrays, first sat_count slots used.
+        # sat_id is talker system << 8 | PRN, so GPS 5 and Galileo 5 differ.
+        self.max_sats = max_sats
+        self.sat_count = 0
+        zeros = [0] * max_sats
+        self.sat_id = array("H", zeros)
+        self.sat_el = array("h", zeros)
+        self.sat_az = array("h", zeros)
+        self.sat_snr = array("h", zeros)  # -1 = not tracked
+        self.sat_seen = array("L", zeros)  # sentence counter at last report
+
+        self.sentences = 0       # accepted sentences
+        self.errors = 0          # bad checksum or overlong
+        self.updated_ms = 0
+
+    @property
+    def lat(self):
+        return None if self.lat_e6 is None else self.lat_e6 / 1000000
+
+    @property
+    def lon(self):
+        return None if self.lon_e6 is None else self.lon_e6 / 1000000
+
+    @property
+    def alt_m(self):
+        return None if self.alt_dm is None else self.alt_dm / 10
+
+    @property
+    def speed_kmh(self):
+        return None if self.speed_ckn is None else self.speed_ckn * 0.01852
+
+    @property
+    def course_deg(self):
+        return None if self.course_ddeg is None else self.course_ddeg / 10
+
+    @property
+    def hdop(self):
+        return None if self.hdop_c is None else self.hdop_c / 100
+
+    def has_position(self):
+        return self.lat_e6 is not None and self.lon_e6 is not None
+
+
+class NMEAStream:
+    """
+    Incremental NMEA parser: feed() it bytes as they arrive, read fix.
+
+        stream = NMEAStream()
+        n = uart.readinto(buf)
+        stream.feed(buf, n)
+        if stream.fix.valid: ...
+    """
+
+    def __init__(self, fix=None):
+        self.fix = fix if fix is not None else GPSFix()
+        self._buf = bytearray(_MAX_SENTENCE)
+        self._n = 0
+        self._offs = array("H", [0] * (_MAX_FIELDS + 1))
+        self._nf = 0
+
+    def reset(self):
+        self._n = 0
+
+    def feed(self, data, n=-1):
+        """Consume n bytes of data (all of it by default)."""
+        if isinstance(data, str):
+            data = data.encode()
+        if n < 0:
+            n = len(data)
+        buf = self._buf
+        pos = self._n
+        for i in range(n):
+            b = data[i]
+            if b == _DOLLAR:
+                buf[0] = b
+                pos = 1
+            elif b == _LF or b == _CR:
+                if pos:
+                    self._n = pos
+                    self._sentence()
+                    pos = 0
+            elif pos:
+                if pos < _MAX_SENTENCE:
+                    buf[pos] = b
+                    pos += 1
+                else:
+                    self.fix.errors += 1
+                    pos = 0  # overlong: drop until the next '$'
+        self._n = pos
+
+    # ------------------------------------------------------------------
+    # Sentence level
+    # ------------------------------------------------------------------
+
+    def _sentence(self):
+        buf = self._buf
+        n = self._n
+        offs = self._offs
+        # Checksum and split in one pass over $<body>*hh
+        c = 0
+        nf = 0
+        offs[0] = 1
+        star = -1
+        for i in range(1, n):
+            b = buf[i]
+            if b == _STAR:
+                star = i
+                break
+            c ^= b
+            if b == _COMMA and nf < _MAX_FIELDS - 1:
+                nf += 1
+                offs[nf] = i + 1
+        if star < 0 or star + 2 >= n:
+            self.fix.errors += 1
+            return
+        hi = _hex(buf[star + 1])
+        lo = _hex(buf[star + 2])
+        if hi < 0 or lo < 0 or (hi << 4 | lo) != c:
+            self.fix.errors += 1
+            return
+        nf += 1
+        offs[nf] = star + 1  # sentinel: field i is buf[offs[i]:offs[i+1]-1]
+        self._nf = nf
+
+        end = offs[1] - 1  # end of the address field ("GPRMC")
+        if end - 1 < 5:
+            return
+        t0, t1, t2 = buf[end - 3], buf[end - 2], buf[end - 1]
+        fix = self.fix
+        if t0 == 0x52 and t1 == 0x4D and t2 == 0x43:      # RMC
+            self._rmc()
+        elif t0 == 0x47 and t1 == 0x47 and t2 == 0x41:    # GGA
+            self._gga()
+        elif t0 == 0x47 and t1 == 0x53 and t2 == 0x56:    # GSV
+            self._gsv()
+        elif t0 == 0x47 and t1 == 0x53 and t2 == 0x41:    # GSA
+            self._gsa()
+        elif t0 == 0x47 and t1 == 0x4C and t2 == 0x4C:    # GLL
+            self._gll()
+        else:
+            return
+        fix.sentences += 1
+        fix.updated_ms = time.ticks_ms()
+
+    # ------------------------------------------------------------------
+    # Field decoding (all in place on _buf)
+    # ------------------------------------------------------------------
+
+    # Field i spans buf[_offs[i]:_offs[i + 1] - 1]; the helpers inline that
+    # instead of returning (start, end) tuples, which would be allocated.
+
+    def _char(self, i):
+        if i >= self._nf:
+            return None
+        a = self._offs[i]
+        return self._buf[a] if self._offs[i + 1] - 1 > a else None
+
+    def _int(self, i):
+        if i >= self._nf:
+            return None
+        a = self._offs[i]
+        e = self._offs[i + 1] - 1
+        if e <= a:
+            return None
+        buf = self._buf
+        v = 0
+        for k in range(a, e):
+            d = buf[k] - 48
+            if d < 0 or d > 9:
+                if buf[k] == _DOT:
+                    break
+                return None
+            v = v * 10 + d
+        return v
+
+    def _dec(self, i, places):
+        # Decimal field scaled by 10**places, extra digits truncated
+        if i >= self._nf:
+            return None
+        a = self._offs[i]
+        e = self._offs[i + 1] - 1
+        if e <= a:
+            return None
+        buf = self._buf
+        neg = buf[a] == _MINUS
+        if neg:
+            a += 1
+        v = 0
+        frac = -1
+        for k in range(a, e):
+            b = buf[k]
+            if b == _DOT:
+                if frac >= 0:
+                    return None
+                frac = 0
+                continue
+            d = b - 48
+            if d < 0 or d > 9:
+                return None
+            if frac < 0:
+                v = v * 10 + d
+            elif frac < places:
+                v = v * 10 + d
+                frac += 1
+        if frac < 0:
+            frac = 0
+        while frac < places:
+            v *= 10
+            frac += 1
+        return -v if neg else v
+
+    def _coord(self, i):
+        # ddmm.mmmm / dddmm.mmmm plus hemisphere field -> micro-degrees
+        h = self._char(i + 1)
+        if h is None:
+            return None
+        a = self._offs[i]
+        e = self._offs[i + 1] - 1
+        if e <= a:
+            return None
+        buf = self._buf
+        dot = a
+        while dot < e and buf[dot] != _DOT:
+            dot += 1
+        deg = 0
+        for k in range(a, dot - 2):
+            d = buf[k] - 48
+            if d < 0 or d > 9:
+                return None
+            deg = deg * 10 + d
+        # minutes scaled by 1e5, parsed from mm.mmmmm
+        m = 0
+        places = 0
+        for k in range(dot - 2, e):
+            if k < a:
+                continue
+            b = buf[k]
+            if b == _DOT:
+                continue
+            d = b - 48
+            if d < 0 or d > 9:
+                return None
+            if k > dot:
+                if places == 5:
+                    break
+                places += 1
+            m = m * 10 + d
+        while places < 5:
+            m *= 10
+            places += 1
+        v = deg * 1000000 + (m + 3) // 6  # minutes * 1e5 -> micro-degrees
+        if h == 0x53 or h == 0x57:  # S, W
+            v = -v
+        return v
+
+    def _time(self, i):
+        if i >= self._nf:
+            return
+        a = self._offs[i]
+        if self._offs[i + 1] - 1 - a < 6:
+            return
+        buf = self._buf
+        for k in range(a, a + 6):
+            if buf[k] < 48 or buf[k] > 57:
+                return
+        fix = self.fix
+        fix.hour = (buf[a] - 48) * 10 + buf[a + 1] - 48
+        fix.minute = (buf[a + 2] - 48) * 10 + buf[a + 3] - 48
+        fix.second = (buf[a + 4] - 48) * 10 + buf[a + 5] - 48
+
+    def _position(self, i):
+        lat = self._coord(i)
+        lon = self._coord(i + 2)
+        if lat is not None and lon is not None:
+            self.fix.lat_e6 = lat
+            self.fix.lon_e6 = lon
+
+    # ------------------------------------------------------------------
+    # Sentences
+    # ------------------------------------------------------------------
+
+    def _rmc(self):
+        # $xxRMC,hhmmss.ss,A,llll.ll,a,yyyyy.yy,a,x.x,x.x,ddmmyy,...
+        if self._nf < 10:
+            return
+        fix = self.fix
+        self._time(1)
+        status = self._char(2)
+        fix.rmc_status = status
+        fix.valid = status == 0x41  # "A"
+        self._position(3)
+        v = self._dec(7, 2)
+        if v is not None:
+            fix.speed_ckn = v
+        v = self._dec(8, 1)
+        if v is not None:
+            fix.course_ddeg = v
+        v = self._int(9)
+        if v is not None and self._offs[10] - 1 - self._offs[9] == 6:
+            fix.day = v // 10000
+            fix.month = v // 100 % 100
+            fix.year = 2000 + v % 100
+
+    def _gga(self):
+        # $xxGGA,hhmmss.ss,lat,NS,lon,EW,quality,numSV,HDOP,alt,M,...
+        if self._nf < 10:
+            return
+        fix = self.fix
+        self._time(1)
+        self._position(2)
+        v = self._int(6)
+        if v is not None:
+            fix.quality = v
+            fix.gga_quality = v
+        v = self._int(7)
+        if v is not None:
+            fix.sats_used = v
+        v = self._dec(8, 2)
+        if v is not None:
+            fix.hdop_c = v
+        v = self._dec(9, 1)
+        if v is not None:
+            fix.alt_dm = v
+
+    def _gsa(self):
+        # $xxGSA,mode1,mode2,sv1..sv12,pdop,hdop,vdop
+        nf = self._nf
+        if nf < 3:
+            return
+        fix = self.fix
+        fix.gsa_mode = self._char(1)
+        fix.gsa_fix_type = self._int(2)
+        fix.gsa_pdop_c = self._dec(nf - 3, 2)
+        fix.gsa_hdop_c = self._dec(nf - 2, 2)
+        fix.gsa_vdop_c = self._dec(nf - 1, 2)
+
+    def _gll(self):
+        # $xxGLL,lat,NS,lon,EW,hhmmss.ss,status,mode
+        if self._nf < 7:
+            return
+        self._position(1)
+        self._time(5)
+        self.fix.gll_status = self._char(6)
+
+    def _gsv(self):
+        # $xxGSV,total_msgs,msg_num,total_sats,{prn,el,az,snr}...
+        nf = self._nf
+        if nf < 4:
+            return
+        fix = self.fix
+        v = self._int(3)
+        if v is not None:
+            fix.gsv_total = v
+        system = self._buf[2]  # second talker letter: P, L, A, B, N...
+        i = 4
+        while i + 3 < nf:
+            prn = self._int(i)
+            if prn is not None:
+                slot = self._sat_slot(system << 8 | prn & 0xFF)
+                v = self._int(i + 1)
+                if v is not None:
+                    fix.sat_el[slot] = v
+                v = self._int(i + 2)
+                if v is not None:
+                    fix.sat_az[slot] = v
+                v = self._int(i + 3)
+                fix.sat_snr[slot] = -1 if v is None else v
+                fix.sat_seen[slot] = fix.sentences
+            i += 4
+
+    def _sat_slot(self, sat_id):
+        fix = self.fix
+        ids = fix.sat_id
+        count = fix.sat_count
+        for k in range(count):
+            if ids[k] == sat_id:
+                return k
+        if count < fix.max_sats:
+            fix.sat_count = count + 1
+            slot = count
+        else:
+            # Table full: reuse the satellite not reported for longest
+            seen = fix.sat_seen
+            slot = 0
+            for k in range(1, count):
+                if seen[k] < seen[slot]:
+                    slot = k
+        ids[slot] = sat_id
+        fix.sat_el[slot] = 0
+        fix.sat_az[slot] = 0
+        fix.sat_snr[slot] = -1
+        return slot
@@ -1,6 +1,9 @@
 import logging
+import os
 import time
 
+import ujson
+
 from .shared_preferences import SharedPreferences
 from .content.intent import Intent
 from .audio.audiomanager import AudioManager
@@ -127,11 +130,77 @@ class Notification:
         )
 
 
+def _sort_key(n):
+    return (int(n.priority), int(n.updated_at or 0), int(n.created_at or 0))
+
+
+class NotificationJournal:
+    """
+    Append-only log of notification changes, one JSON record per line:
+    ["put", {...}] adds or replaces a notification, ["del", id] removes one
+    and ["clear"] removes all. Replaying it over the last snapshot gives the
+    current set; replaying twice gives the same result, so a crash between
+    writing a snapshot and truncating the log is harmless.
+    """
+
+    def __init__(self, path):
+        self.path = path
+
+    def append(self, records):
+        self._ensure_dir()
+        with open(self.path, "a") as f:
+            for record in records:
+                f.write(ujson.dumps(record))
+                f.write("\n")
+
+    def read(self):
+        """Return the records in order, skipping lines that don't parse (e.g. a torn last write)."""
+        records = []
+        try:
+            f = open(self.path, "r")
+        except OSError:
+            return records
+        with f:
+            for line in f:
+                line = line.strip()
+                if not line:
+                    continue
+                try:
+                    records.append(ujson.loads(line))
+                except ValueError:
+                    logger.warning("Skipping unreadable notification journal record")
+        return records
+
+    def clear(self):
+        try:
+            os.remove(self.path)
+        except OSError:
+            pass
+
+    def _ensure_dir(self):
+        parts = self.path.split("/")[:-1]
+        path = ""
+        for part in parts:
+            path = part if not path else path + "/" + part
+            try:
+                os.stat(path)
+            except OSError:
+                os.mkdir(path)
+
+
 class NotificationManager:
     _MAX_NOTIFICATIONS = 20
     _PREFS_APP_NAME = "com.micropythonos.system"
     _PREFS_FILENAME = "notifications.json"
     _PREFS_KEY = "notifications"
+    _JOURNAL_FILENAME = "notifications.journal"  # next to the snapshot, in the prefs app dir
+    # Fold the journal into the snapshot once it holds this many records
+    _COMPACT_AFTER = 60
+
+    # Change kinds passed to delta listeners
+    ADDED = "added"
+    UPDATED = "updated"
+    REMOVED = "removed"
 
     _SETTINGS_APP_NAME = "com.micropythonos.settings"
     _SETTINGS_KEY = "notification_sound"
@@ -140,8 +209,15 @@ class NotificationManager:
     _initialized = False
     _settings_prefs = None
     _notifications = {}
+    # Notifications sorted like get_notifications(), kept up to date on every change
+    _ordered = []
     _listeners = []
+    _delta_listeners = []
+    _journal = None
+    _journal_records = 0
+    _pending_records = []
     _persist_write_count = 0
+    _compact_count = 0
     _pending_persist = False
     _debounce_timer = None
     _last_sound_ts = None
@@ -163,6 +239,12 @@ class NotificationManager:
             )
         return cls._prefs
 
+    @classmethod
+    def _get_journal(cls):
+        if cls._journal is None:
+            cls._journal = NotificationJournal(cls._get_prefs().appdir + "/" + cls._JOURNAL_FILENAME)
+        return cls._journal
+
     @classmethod
     def _get_settings_prefs(cls):
         if cls._settings_prefs is None:
@@ -213,51 +295,129 @@ class NotificationManager:
             return
         cls._initialized = True
         cls._notifications = {}
+        cls._ordered = []
+        cls._pending_records = []
         prefs = cls._get_prefs()
         for item in prefs.get_list(cls._PREFS_KEY, []):
-            n = Notification.from_persisted_dict(item)
-            if n is None:
-                continue
-            if n.created_at is None:
-                n.created_at = cls._now_seconds()
-            if n.updated_at is None:
-                n.updated_at = n.created_at
-            cls._notifications[n.notification_id] = n
+            cls._load_item(item)
+        records = cls._get_journal().read()
+        for record in records:
+            cls._replay(record)
+        cls._journal_records = len(records)
         cls._trim_to_limit(persist=False)
 
+    @classmethod
+    def _load_item(cls, item):
+        n = Notification.from_persisted_dict(item)
+        if n is None:
+            return
+        if n.created_at is None:
+            n.created_at = cls._now_seconds()
+        if n.updated_at is None:
+            n.updated_at = n.created_at
+        cls._remove(n.notification_id)
+        cls._insert(n)
+
+    @classmethod
+    def _replay(cls, record):
+        if not isinstance(record, list) or not record:
+            return
+        op = record[0]
+        if op == "put" and len(record) > 1:
+            cls._load_item(record[1])
+        elif op == "del" and len(record) > 1:
+            cls._remove(record[1])
+        elif op == "clear":
+            cls._notifications = {}
+            cls._ordered = []
+
+    # ------------------------------------------------------------------
+    # Sorted index
+    # ------------------------------------------------------------------
+
+    @classmethod
+    def _insert(cls, n):
+        """Add n to the index and return its position; ahead of equal keys, so newer wins ties."""
+        ordered = cls._ordered
+        key = _sort_key(n)
+        lo = 0
+        hi = len(ordered)
+        while lo < hi:
+            mid = (lo + hi) // 2
+            if _sort_key(ordered[mid]) > key:
+                lo = mid + 1
+            else:
+                hi = mid
+        ordered.insert(lo, n)
+        cls._notifications[n.notification_id] = n
+        return lo
+
+    @classmethod
+    def _remove(cls, notification_id):
+        """Drop a notification from the index and return its old position, or -1."""
+        n = cls._notifications.pop(notification_id, None)
+        if n is None:
+            return -1
+        ordered = cls._ordered
+        for i in range(len(ordered)):
+            if ordered[i] is n:
+                del ordered[i]
+                return i
+        return -1
+
     @classmethod
     def _trim_to_limit(cls, persist=True):
-        if len(cls._notifications) <= cls._MAX_NOTIFICATIONS:
+        if len(cls._ordered) <= cls._MAX_NOTIFICATIONS:
             return False
-        ordered = cls._sorted_notifications()
-        while len(ordered) > cls._MAX_NOTIFICATIONS:
-            cls._notifications.pop(ordered.pop().notification_id, None)
-        if persist:
-            cls._persist()
+        while len(cls._ordered) > cls._MAX_NOTIFICATIONS:
+            n = cls._ordered[-1]
+            index = cls._remove(n.notification_id)
+            if persist:
+                cls._pending_records.append(["del", n.notification_id])
+            cls._notify_delta(cls.REMOVED, n, index)
         return True
 
     @classmethod
     def _sorted_notifications(cls):
-        return sorted(
-            cls._notifications.values(),
-            key=lambda n: (int(n.priority), int(n.updated_at or 0), int(n.created_at or 0)),
-            reverse=True,
-        )
+        return list(cls._ordered)
+
+    # ------------------------------------------------------------------
+    # Persistence
+    # ------------------------------------------------------------------
 
     @classmethod
     def _do_persist(cls, _timer=None):
+        """Append the pending changes to the journal, compacting it when it gets long."""
         cls._pending_persist = False
         cls._debounce_timer = None
-        prefs = cls._get_prefs()
-        payload = [n.to_persisted_dict() for n in cls._sorted_notifications()]
-        editor = prefs.edit()
+        records = cls._pending_records
+        cls._pending_records = []
+        if not records:
+            return
+        if cls._journal_records + len(records) > cls._COMPACT_AFTER:
+            cls._compact()
+        else:
+            cls._get_journal().append(records)
+            cls._journal_records += len(records)
+        cls._persist_write_count += 1
+
+    @classmethod
+    def _compact(cls):
+        # Snapshot first, then drop the journal: replaying it over the new
+        # snapshot is harmless if we stop in between.
+        payload = [n.to_persisted_dict() for n in cls._ordered]
+        editor = cls._get_prefs().edit()
         editor.put_list(cls._PREFS_KEY, payload)
         editor.commit()
-        cls._persist_write_count += 1
+        cls._get_journal().clear()
+        cls._journal_records = 0
+        cls._compact_count += 1
 
     @classmethod
-    def _persist(cls, immediate=False):
-        """Schedule a deferred write. Pass immediate=True to skip debounce (e.g. on cancel)."""
+    def _persist(cls, record=None, immediate=False):
+        """Queue a journal record and schedule a deferred write. Pass immediate=True to skip debounce (e.g. on cancel)."""
+        if record is not None:
+            cls._pending_records.append(record)
         if immediate:
             # Cancel any pending debounce timer and write now
             if cls._debounce_timer is not None:
@@ -282,6 +442,18 @@ class NotificationManager:
             # LVGL not available (unit tests): write immediately
             cls._do_persist()
 
+    # ------------------------------------------------------------------
+    # Listeners
+    # ------------------------------------------------------------------
+
+    @classmethod
+    def _notify_delta(cls, change, notification, index):
+        for callback in cls._delta_listeners:
+            try:
+                callback(change, notification, index)
+            except Exception as e:
+                logger.error("Listener callback failed: %s", e)
+
     @classmethod
     def _notify_listeners(cls):
         for callback in cls._listeners:
@@ -291,25 +463,47 @@ class NotificationManager:
                 logger.error("Listener callback failed: %s", e)
 
     @classmethod
-    def register_listener(cls, callback, notify_immediately=True):
+    def register_listener(cls, callback, notify_immediately=True, deltas=False):
+        """
+        Call callback() whenever the notifications change.
+
+        With deltas=True it is called as callback(change, notification, index)
+        instead, once per change: change is ADDED, UPDATED or REMOVED and
+        index the notification's position in get_notifications() after the
+        change (before it, for REMOVED). An update that changes the order is
+        reported as REMOVED then ADDED. notify_immediately replays the current
+        notifications as ADDED.
+        """
         cls._ensure_initialized()
-        if callback not in cls._listeners:
-            cls._listeners.append(callback)
-        if notify_immediately:
-            try:
+        listeners = cls._delta_listeners if deltas else cls._listeners
+        if callback not in listeners:
+            listeners.append(callback)
+        if not notify_immediately:
+            return
+        try:
+            if deltas:
+                for i, n in enumerate(list(cls._ordered)):
+                    callback(cls.ADDED, n, i)
+            else:
                 callback()
-            except Exception as e:
-                logger.error("Initial callback failed: %s", e)
+        except Exception as e:
+            logger.error("Initial callback failed: %s", e)
 
     @classmethod
     def unregister_listener(cls, callback):
         cls._listeners = [cb for cb in cls._listeners if cb != callback]
+        cls._delta_listeners = [cb for cb in cls._delta_listeners if cb != callback]
 
     @classmethod
     def get_notifications(cls):
         cls._ensure_initialized()
         return cls._sorted_notifications()
 
+    @classmethod
+    def get_top_notification(cls):
+        cls._ensure_initialized()
+        return cls._ordered[0] if cls._ordered else None
+
     @classmethod
     def get_notification(cls, notification_id):
         cls._ensure_initialized()
@@ -325,17 +519,26 @@ class NotificationManager:
         existing = cls._notifications.get(notification.notification_id)
         if existing:
             # Update content + timestamp but do NOT persist — same ID, no flash write
+            notification_id = existing.notification_id
+            old_index = cls._remove(notification_id)
             existing.update_from(notification)
             existing.updated_at = now_ts
-            notification_id = existing.notification_id
+            index = cls._insert(existing)
+            if index == old_index:
+                cls._notify_delta(cls.UPDATED, existing, index)
+            else:
+                cls._notify_delta(cls.REMOVED, existing, old_index)
+                cls._notify_delta(cls.ADDED, existing, index)
         else:
             if notification.created_at is None:
                 notification.created_at = now_ts
             notification.updated_at = now_ts
-            cls._notifications[notification.notification_id] = notification
-            cls._trim_to_limit(persist=False)
-            cls._persist()           # debounced write
             notification_id = notification.notification_id
+            index = cls._insert(notification)
+            cls._notify_delta(cls.ADDED, notification, index)
+            cls._pending_records.append(["put", notification.to_persisted_dict()])
+            cls._trim_to_limit()
+            cls._persist()           # debounced write
 
         cls._notify_listeners()
         cls._play_notification_sound()
@@ -344,10 +547,12 @@ class NotificationManager:
     @classmethod
     def cancel(cls, notification_id):
         cls._ensure_initialized()
-        if notification_id not in cls._notifications:
+        n = cls._notifications.get(notification_id)
+        if n is None:
             return False
-        del cls._notifications[notification_id]
-        cls._persist(immediate=True)   # removal must be immediate; we don't want it to reappear on reboot
+        index = cls._remove(notification_id)
+        cls._persist(["del", notification_id], immediate=True)   # removal must be immediate; we don't want it to reappear on reboot
+        cls._notify_delta(cls.REMOVED, n, index)
         cls._notify_listeners()
         return True
 
@@ -356,8 +561,12 @@ class NotificationManager:
         cls._ensure_initialized()
         if not cls._notifications:
             return
+        removed = cls._ordered
         cls._notifications = {}
-        cls._persist(immediate=True)
+        cls._ordered = []
+        cls._persist(["clear"], immediate=True)
+        for i in range(len(removed) - 1, -1, -1):
+            cls._notify_delta(cls.REMOVED, removed[i], i)
         cls._notify_listeners()
 
     @classmethod
@@ -406,8 +615,13 @@ class NotificationManager:
     def _reset_for_tests(cls, clear_storage=False):
         cls._initialized = False
         cls._notifications = {}
+        cls._ordered = []
         cls._listeners = []
+        cls._delta_listeners = []
+        cls._pending_records = []
+        cls._journal_records = 0
         cls._persist_write_count = 0
+        cls._compact_count = 0
         cls._pending_persist = False
         cls._debounce_timer = None
         cls._last_sound_ts = None
@@ -421,4 +635,6 @@ class NotificationManager:
             editor = prefs.edit()
             editor.remove_all()
             editor.commit()
+            NotificationJournal(prefs.appdir + "/" + cls._JOURNAL_FILENAME).clear()
         cls._prefs = None
+        cls._journal = None
@@ -0,0 +1,162 @@
+"""
+Status values for the top bar (clock, Wi-Fi, battery, temperature), pushed
+to subscribers only when they change.
+
+Sources publish() values; publishing the value a key already has is a no-op,
+so subscribers (widgets) only ever see real changes and never redraw for
+nothing. Sources that have to be polled are added with add_poller() and
+can be paused while nobody looks at them. The clock is a source of its own
+that wakes up on second (or, when coarse, minute) boundaries instead of on
+a free-running interval.
+
+Usage:
+    StatusService.subscribe(StatusService.WIFI, lambda connected: ...)
+    StatusService.add_poller(StatusService.WIFI, WifiService.is_connected, 1500)
+    StatusService.start_clock()
+"""
+
+import logging
+import time
+
+logger = logging.getLogger(__name__)
+
+# Wake a little after the boundary so localtime() is already past it
+_CLOCK_SLACK_MS = 5
+
+
+class StatusService:
+    CLOCK = "clock"              # (hours, minutes, seconds)
+    WIFI = "wifi"                # bool: station connected
+    BATTERY = "battery"          # int: percentage
+    TEMPERATURE = "temperature"  # int: degrees C, or None if unreadable
+
+    _values = {}
+    _listeners = {}
+    _pollers = {}                # key -> [read, timer]
+    _clock_timer = None
+    _clock_seconds = True
+
+    @classmethod
+    def get(cls, key, default=None):
+        return cls._values.get(key, default)
+
+    @classmethod
+    def subscribe(cls, key, callback, notify_immediately=True):
+        """Call callback(value) whenever key changes, and now if it has a value."""
+        listeners = cls._listeners.setdefault(key, [])
+        if callback not in listeners:
+            listeners.append(callback)
+        if notify_immediately and key in cls._values:
+            callback(cls._values[key])
+
+    @classmethod
+    def unsubscribe(cls, key, callback):
+        listeners = cls._listeners.get(key)
+        if listeners and callback in listeners:
+            listeners.remove(callback)
+
+    @classmethod
+    def publish(cls, key, value):
+        """Set key to value. Returns True (and notifies) only if it changed."""
+        values = cls._values
+        if key in values and values[key] == value:
+            return False
+        values[key] = value
+        for callback in cls._listeners.get(key, ()):
+            try:
+                callback(value)
+            except Exception as e:
+                logger.error("status listener for %s failed: %s", key, e)
+        return True
+
+    # --- Polled sources ---
+
+    @classmethod
+    def add_poller(cls, key, read, interval_ms):
+        """
+        Publish read() every interval_ms (and once now). read() may raise to
+        skip a sample. Replaces an earlier poller for key.
+        """
+        cls.remove_poller(key)
+        import lvgl as lv
+        timer = lv.timer_create(lambda t, k=key: cls.poll(k), interval_ms, None)
+        cls._pollers[key] = [read, timer]
+        cls.poll(key)
+
+    @classmethod
+    def remove_poller(cls, key):
+        poller = cls._pollers.pop(key, None)
+        if poller is not None and poller[1] is not None:
+            poller[1].delete()
+
+    @classmethod
+    def poll(cls, key):
+        """Sample a polled source now. Returns True if its value changed."""
+        poller = cls._pollers.get(key)
+        if poller is None:
+            return False
+        try:
+            value = poller[0]()
+        except Exception as e:
+            logger.error("status source %s failed: %s", key, e)
+            return False
+        return cls.publish(key, value)
+
+    @classmethod
+    def set_poller_paused(cls, key, paused):
+        """Stop sampling key while nothing shows it; resuming samples at once."""
+        poller = cls._pollers.get(key)
+        if poller is None:
+            return
+        if paused:
+            poller[1].pause()
+        else:
+            poller[1].resume()
+            cls.poll(key)
+
+    # --- Clock ---
+
+    @classmethod
+    def start_clock(cls, seconds=True):
+        """Publish CLOCK now and then on every second (or minute) boundary."""
+        cls._clock_seconds = seconds
+        if cls._clock_timer is None:
+            import lvgl as lv
+            cls._clock_timer = lv.timer_create(cls._clock_tick, 1000, None)
+        cls._clock_tick(cls._clock_timer)
+
+    @classmethod
+    def set_clock_seconds(cls, seconds):
+        """Switch between second and minute wake-ups, e.g. while the bar is hidden."""
+        if seconds == cls._clock_seconds:
+            return
+        cls._clock_seconds = seconds
+        if cls._clock_timer is not None:
+            cls._clock_tick(cls._clock_timer)
+
+    @classmethod
+    def _clock_tick(cls, timer):
+        import mpos.time
+        # Sub-second first: if the second rolls over in between, the next
+        # wake-up is just early (and publishes nothing) rather than late
+        subsecond = cls._subsecond_ms()
+        lt = mpos.time.localtime()
+        cls.publish(cls.CLOCK, (lt[3], lt[4], lt[5]))
+        timer.set_period(cls.clock_delay_ms(lt[5], subsecond, cls._clock_seconds))
+        timer.reset()
+
+    @staticmethod
+    def clock_delay_ms(second, subsecond_ms, seconds=True):
+        """Milliseconds from now until just past the next second/minute boundary."""
+        delay = 1000 - subsecond_ms
+        if not seconds:
+            delay += (59 - second) * 1000
+        return delay + _CLOCK_SLACK_MS
+
+    @staticmethod
+    def _subsecond_ms():
+        # time.time() only has whole seconds on MicroPython; time_ns() has the rest
+        try:
+            return (time.time_ns() // 1000000) % 1000
+        except AttributeError:
+            return 0
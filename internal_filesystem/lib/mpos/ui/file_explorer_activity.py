@@ -14,10 +14,37 @@ from .display_metrics import DisplayMetrics
 from .input_activity import InputActivity
 
 
+def _merge_sorted(a, b):
+    """Merge two sorted lists into a new sorted list."""
+    out = []
+    i = j = 0
+    na = len(a)
+    nb = len(b)
+    while i < na and j < nb:
+        if b[j] < a[i]:
+            out.append(b[j])
+            j += 1
+        else:
+            out.append(a[i])
+            i += 1
+    if i < na:
+        out.extend(a[i:])
+    if j < nb:
+        out.extend(b[j:])
+    return out
+
+
 class FileExplorerActivity(Activity):
     MODE_BROWSE = "browse"
     MODE_PICK = "pick"
 
+    # Directory entries read per os.ilistdir() batch; the first batch is
+    # shown immediately, the rest streams in from a timer.
+    LIST_BATCH = 64
+    # Rows kept beyond the visible ones, so focus can move onto a row
+    # before it scrolls into view.
+    EXTRA_ROWS = 2
+
     # Widgets
     _screen = None
     _path_label = None
@@ -34,16 +61,29 @@ class FileExplorerActivity(Activity):
     # State
     _current_path = None
     _selected_paths = None
-    _path_to_btn = None
     _selected_style = None
     _mode = None
     _path_pattern = None
     _start_dir = None
 
+    # Long-pressed entry, tracked by path because rows are recycled: it is
+    # shown with a "> " prefix while the action bar is open, and the click
+    # that ends its long press is suppressed.
     _selected_path = None
-    _suppress_btn = None
-    _highlighted_btn = None
-    _highlighted_text = None
+    _suppress_path = None
+
+    # Virtual list: sorted names, and a small pool of recycled row buttons.
+    # Entry i is "< Back" (when not at /), then dirs, then files; entry i
+    # is shown by row i % len(_rows).
+    _dirs = None
+    _files = None
+    _has_back = False
+    _listing = None  # os.ilistdir() iterator while the listing streams in
+    _list_timer = None
+    _rows = None
+    _row_entry = None
+    _row_h = 0
+    _spacer = None
 
     def onCreate(self):
         sdcard.mount_with_optional_format("/sdcard")
@@ -57,7 +97,6 @@ class FileExplorerActivity(Activity):
         if isinstance(self._path_pattern, str):
             self._path_pattern = [self._path_pattern]
         self._selected_paths = []
-        self._path_to_btn = {}
 
         screen = lv.obj()
         screen.set_flex_flow(lv.FLEX_FLOW.COLUMN)
@@ -97,6 +136,8 @@ class FileExplorerActivity(Activity):
         self._list = lv.list(screen)
         self._list.set_width(lv.pct(100))
         self._list.set_flex_grow(1)
+        self._list.add_event_cb(lambda e: self._sync_rows(), lv.EVENT.SCROLL, None)
+        self._list.add_event_cb(lambda e: self._sync_rows(), lv.EVENT.SIZE_CHANGED, None)
 
         if self._mode == self.MODE_PICK:
             self._create_bottom_bar(screen)
@@ -107,6 +148,9 @@ class FileExplorerActivity(Activity):
     def onResume(self, screen):
         sdcard.mount_with_optional_format("/sdcard")
 
+    def onDestroy(self, screen):
+        self._stop_listing()
+
     def _resolve_start_dir(self, start_dir):
         path = start_dir.rstrip("/")
         if path == "":
@@ -165,64 +209,200 @@ class FileExplorerActivity(Activity):
     def _populate_dir(self, path):
         self._dismiss_action_bar()
         self._clear_highlight()
-        self._list.clean()
-        self._path_to_btn = {}
+        self._stop_listing()
         path = path.rstrip("/") + "/"
         self._current_path = path
         self._path_label.set_text("  " + path)
+        self._has_back = path != "/"
+        self._dirs = []
+        self._files = []
+        self._reset_rows()
 
-        if path != "/":
-            parent = "/".join(path.rstrip("/").split("/")[:-1]) + "/"
-            if parent == "":
-                parent = "/"
-            btn = self._list.add_button(None, "< Back")
-            btn.add_event_cb(lambda e, p=parent: self._populate_dir(p), lv.EVENT.CLICKED, None)
-
-        # FAT32 (SD card) rejects paths ending with '/' for os.listdir(),
+        # FAT32 (SD card) rejects paths ending with '/' for os.ilistdir(),
         # returning EINVAL (Errno 22), while the internal LittleFS filesystem
         # accepts them. Strip the trailing slash only for the listing call;
         # keep it on the main path string so child paths concatenate correctly.
         try:
-            items = os.listdir(path.rstrip("/") or "/")
+            self._listing = os.ilistdir(path.rstrip("/") or "/")
         except OSError:
+            self._sync_rows()
             return
-
+        if self._read_batch():
+            self._list_timer = lv.timer_create(self._read_batch_timer, 5, None)
+
+    def _read_batch(self):
+        """
+        Add up to LIST_BATCH entries from the listing to the sorted name
+        lists. Returns True while there are more to read.
+        """
         dirs = []
         files = []
-        for item in items:
-            full = path + item
-            try:
-                if os.stat(full)[0] & 0x4000:
-                    dirs.append(item)
+        more = False
+        try:
+            for entry in self._listing:
+                name = entry[0]
+                kind = entry[1]
+                if kind == 0:
+                    # Type unknown to this filesystem: fall back to stat
+                    try:
+                        kind = os.stat(self._current_path + name)[0] & 0xF000
+                    except OSError:
+                        kind = 0x8000
+                if kind == 0x4000:
+                    dirs.append(name)
                 else:
-                    files.append(item)
-            except OSError:
-                files.append(item)
-
-        dirs.sort()
-        files.sort()
+                    files.append(name)
+                if len(dirs) + len(files) >= self.LIST_BATCH:
+                    more = True
+                    break
+        except OSError as e:
+            logger.error("FileExplorer: listing %s failed: %s", self._current_path, e)
+        if dirs:
+            dirs.sort()
+            self._dirs = _merge_sorted(self._dirs, dirs)
+        if files:
+            files.sort()
+            self._files = _merge_sorted(self._files, files)
+        if not more:
+            self._listing = None
+        self._refresh_rows()
+        return more
+
+    def _read_batch_timer(self, timer):
+        if not self._read_batch():
+            self._stop_listing()
+
+    def _stop_listing(self):
+        if self._list_timer:
+            self._list_timer.delete()
+            self._list_timer = None
+        self._listing = None
+
+    def _entry_count(self):
+        return (1 if self._has_back else 0) + len(self._dirs) + len(self._files)
+
+    def _entry(self, i):
+        """Return (label, path, is_dir) for entry i; path None for "< Back"."""
+        if self._has_back:
+            if i == 0:
+                return "< Back", None, True
+            i -= 1
+        nd = len(self._dirs)
+        if i < nd:
+            name = self._dirs[i]
+            return lv.SYMBOL.DIRECTORY + "  " + name, self._current_path + name + "/", True
+        name = self._files[i - nd]
+        return lv.SYMBOL.FILE + "  " + name, self._current_path + name, False
+
+    def _parent_path(self):
+        parent = "/".join(self._current_path.rstrip("/").split("/")[:-1]) + "/"
+        return parent if parent != "" else "/"
+
+    def _reset_rows(self):
+        # Rows are created once per activity and only rebound afterwards
+        if self._rows is None:
+            self._list.clean()
+            self._rows = []
+            self._spacer = lv.obj(self._list)
+            self._spacer.remove_style_all()
+            self._spacer.add_flag(lv.obj.FLAG.IGNORE_LAYOUT)
+            self._spacer.remove_flag(lv.obj.FLAG.CLICKABLE)
+            self._spacer.set_pos(0, 0)
+        self._row_entry = [-1] * len(self._rows)
+        for btn in self._rows:
+            btn.add_flag(lv.obj.FLAG.HIDDEN)
+        self._list.scroll_to_y(0, False)
+
+    def _new_row(self):
+        r = len(self._rows)
+        btn = self._list.add_button(None, "")
+        btn.add_flag(lv.obj.FLAG.IGNORE_LAYOUT)
+        btn.set_width(lv.pct(100))
+        btn.add_event_cb(lambda e, r=r: self._on_row_clicked(e, r), lv.EVENT.CLICKED, None)
+        btn.add_event_cb(lambda e, r=r: self._on_row_long_pressed(e, r), lv.EVENT.LONG_PRESSED, None)
+        self._rows.append(btn)
+        self._row_entry.append(-1)
+        if not self._row_h:
+            btn.update_layout()
+            self._row_h = max(1, btn.get_height())
+        btn.set_height(self._row_h)
+        return btn
+
+    def _refresh_rows(self):
+        # Entries were inserted: every bound row may now show another entry
+        for r in range(len(self._row_entry)):
+            self._row_entry[r] = -1
+        self._sync_rows()
+
+    def _sync_rows(self):
+        """Bind the row pool to the entries around the current scroll position."""
+        if self._rows is None:
+            return
+        count = self._entry_count()
+        if not self._rows and count:
+            self._new_row()
+        row_h = self._row_h
+        if not row_h:
+            return
+        self._spacer.set_size(1, count * row_h)
+        needed = min(count, self._list.get_height() // row_h + 1 + self.EXTRA_ROWS)
+        while len(self._rows) < needed:
+            self._new_row()
+            # Ownership of entries moves when the pool grows
+            for r in range(len(self._row_entry)):
+                self._row_entry[r] = -1
+        pool = len(self._rows)
+        first = max(0, self._list.get_scroll_y() // row_h - 1)
+        first = min(first, max(0, count - pool))
+        for i in range(first, first + pool):
+            r = i % pool
+            btn = self._rows[r]
+            if i >= count:
+                btn.add_flag(lv.obj.FLAG.HIDDEN)
+                self._row_entry[r] = -1
+                continue
+            if self._row_entry[r] != i:
+                self._bind_row(r, i)
+
+    def _bind_row(self, r, i):
+        btn = self._rows[r]
+        label, path, is_dir = self._entry(i)
+        if self._action_bar and path is not None and path == self._selected_path:
+            label = "> " + label
+        self._list.set_button_text(btn, label)
+        if path is not None and path in self._selected_paths:
+            self._set_selected_style(btn)
+        else:
+            self._set_unselected_style(btn)
+        btn.set_y(i * self._row_h)
+        btn.remove_flag(lv.obj.FLAG.HIDDEN)
+        self._row_entry[r] = i
 
-        for d in dirs:
-            fullpath = path + d + "/"
-            btn = self._list.add_button(None, lv.SYMBOL.DIRECTORY + "  " + d)
-            btn.add_event_cb(lambda e, p=fullpath: self._on_item_clicked(e, p, True), lv.EVENT.CLICKED, None)
-            btn.add_event_cb(lambda e, p=fullpath: self._on_any_long_press(e, p), lv.EVENT.LONG_PRESSED, None)
-            self._path_to_btn[fullpath] = btn
+    def _on_row_clicked(self, e, r):
+        i = self._row_entry[r]
+        if i < 0:
+            return
+        label, path, is_dir = self._entry(i)
+        if path is None:
+            self._populate_dir(self._parent_path())
+        else:
+            self._on_item_clicked(e, path, is_dir)
 
-        for f in files:
-            fullpath = path + f
-            btn = self._list.add_button(None, lv.SYMBOL.FILE + "  " + f)
-            btn.add_event_cb(lambda e, p=fullpath: self._on_item_clicked(e, p, False), lv.EVENT.CLICKED, None)
-            btn.add_event_cb(lambda e, p=fullpath: self._on_any_long_press(e, p), lv.EVENT.LONG_PRESSED, None)
-            self._path_to_btn[fullpath] = btn
+    def _on_row_long_pressed(self, e, r):
+        i = self._row_entry[r]
+        if i < 0:
+            return
+        label, path, is_dir = self._entry(i)
+        if path is not None:
+            self._on_any_long_press(e, path)
 
     def _on_item_clicked(self, e, path, is_dir):
         target = e.get_target_obj()
         if self._mode == self.MODE_PICK:
             self._toggle_selection(path, target)
             return
-        if target == self._suppress_btn:
-            self._suppress_btn = None
+        if path == self._suppress_path:
+            self._suppress_path = None
             if __debug__: logger.debug("FileExplorer: CLICK (suppressed) on %s", path)
             self._focus_action_bar()
             return
@@ -275,24 +455,21 @@ class FileExplorerActivity(Activity):
     def _on_any_long_press(self, e, path):
         if self._mode == self.MODE_PICK:
             return
-        btn = e.get_target_obj()
-        self._suppress_btn = btn
+        self._dismiss_action_bar()
+        self._suppress_path = path
         self._selected_path = path
-        self._highlight_btn(btn)
         self._show_action_bar()
+        self._rebind_path(path)
         if __debug__: logger.debug("FileExplorer: LONG_PRESSED on %s", path)
 
-    def _highlight_btn(self, btn):
-        self._clear_highlight()
-        self._highlighted_btn = btn
-        self._highlighted_text = self._list.get_button_text(btn)
-        self._list.set_button_text(btn, "> " + self._highlighted_text)
-
-    def _clear_highlight(self):
-        if self._highlighted_btn:
-            self._list.set_button_text(self._highlighted_btn, self._highlighted_text)
-            self._highlighted_btn = None
-            self._highlighted_text = None
+    def _rebind_path(self, path):
+        """Rebind the row showing path, if any, to update its highlight."""
+        if self._rows is None or path is None:
+            return
+        for r in range(len(self._rows)):
+            i = self._row_entry[r]
+            if i >= 0 and self._entry(i)[1] == path:
+                self._bind_row(r, i)
 
     def _focus_action_bar(self):
         if not self._cancel_btn:
@@ -333,11 +510,11 @@ class FileExplorerActivity(Activity):
         self._action_bar = bar
 
     def _dismiss_action_bar(self):
-        self._clear_highlight()
         if self._action_bar:
             self._action_bar.delete()
             self._action_bar = None
             self._cancel_btn = None
+            self._rebind_path(self._selected_path)
 
     def _delete_selected(self):
         self._dismiss_action_bar()
@@ -112,6 +112,8 @@ class MposKeyboard:
     # Store textarea reference (we DON'T pass it to LVGL to avoid double-typing)
     _textarea = None
     _textarea_emoji_font_applied = False
+    # Key label -> whether it contains an emoji codepoint, shared by all keyboards
+    _emoji_key_cache = {}
     # Optional callbacks invoked when the keyboard is shown/hidden.
     _on_show = None
     _on_hide = None
@@ -167,13 +169,11 @@ class MposKeyboard:
         if not ta:
             return
 
-        current_text = ta.get_text()
-        new_text = current_text
-
-        # Handle special keys
+        # Edit at the cursor with LVGL's incremental textarea operations
+        # instead of rebuilding and re-setting the whole text on every key.
         if text == lv.SYMBOL.BACKSPACE:
-            # Delete last character
-            new_text = current_text[:-1]
+            # Delete the character before the cursor
+            ta.delete_char()
         elif text == lv.SYMBOL.UP:
             # Switch to uppercase
             self.set_mode(self.MODE_UPPERCASE)
@@ -192,7 +192,7 @@ class MposKeyboard:
             return  # Don't modify text
         elif text == self.LABEL_SPACE:
             # Space bar
-            new_text = current_text + " "
+            ta.add_char(ord(" "))
         elif text ==  lv.SYMBOL.OK:
             self._keyboard.send_event(lv.EVENT.READY, None)
             return
@@ -203,14 +203,11 @@ class MposKeyboard:
                 self._keyboard.send_event(lv.EVENT.READY, None)
                 return
             else:
-                new_text = current_text + "\n"
+                ta.add_char(ord("\n"))
         else:
             # Regular character
-            new_text = current_text + text
             self._ensure_textarea_emoji_font(ta, text)
-
-        # Update textarea
-        ta.set_text(new_text)
+            ta.add_text(text)
 
     def _without_newline_key(self, key_map, ctrl_map):
         """
@@ -249,8 +246,9 @@ class MposKeyboard:
             on_show: Optional callback invoked when the keyboard is shown
             on_hide: Optional callback invoked after the keyboard is hidden
         """
+        if textarea is not self._textarea:
+            self._textarea_emoji_font_applied = False
         self._textarea = textarea
-        self._textarea_emoji_font_applied = False
         self._on_show = on_show
         self._on_hide = on_hide
 
@@ -310,14 +308,22 @@ class MposKeyboard:
         if not text:
             return False
 
+        cached = self._emoji_key_cache.get(text)
+        if cached is not None:
+            return cached
+
         emoji_codepoints = FontManager.getEmojiCodepoints()
         if not emoji_codepoints:
             return False
 
+        found = False
         for char in text:
             if ord(char) in emoji_codepoints:
-                return True
-        return False
+                found = True
+                break
+        # Only key labels reach here, so the cache stays as small as the layouts
+        self._emoji_key_cache[text] = found
+        return found
 
     def get_textarea(self):
         """
@@ -0,0 +1,233 @@
+"""
+Particle emitter widget for confetti-style effects.
+
+Particle state is kept in one packed array('i') and integrated by the
+native _particles module (c_mpos/src/particles.c) when the firmware has it,
+with a plain Python fallback otherwise. All particles are drawn in a single
+DRAW_MAIN pass onto the emitter object's layer, so there are no per-particle
+LVGL objects, styles or invalidations.
+
+Usage:
+    emitter = ParticleEmitter(lv.layer_top(), ["M:res/star.png", "M:res/heart.png"])
+    emitter.on_frame = lambda dt_ms: emitter.emit(160, 0, 0, 0, 3000, kind=1)
+    emitter.start()
+    ...
+    emitter.stop()  # stops calling on_frame, live particles finish their flight
+"""
+
+from array import array
+import time
+
+import lvgl as lv
+
+from .display_metrics import DisplayMetrics
+
+try:
+    import _particles as _native
+except ImportError:
+    _native = None
+
+# Words per particle, see c_mpos/src/particles.c for the layout
+STRIDE = 10
+_X, _Y, _VX, _VY, _ROT, _SPIN, _AGE, _LIFE, _KIND, _SCALE = range(STRIDE)
+_MIN_SCALE = 77
+
+# Longest step integrated at once, so a stalled frame doesn't teleport particles
+_MAX_DT_MS = 100
+
+
+def _mul_div(v, dt):
+    # C-style truncating v * dt / 1000, to match the native integrator
+    if v < 0:
+        return -(-v * dt // 1000)
+    return v * dt // 1000
+
+
+def _step_py(s, count, dt, gravity, width, height, margin):
+    """Python twin of _particles.step()."""
+    if dt <= 0:
+        return count
+    dvy = _mul_div(gravity * 256, dt)
+    xmin = -margin * 256
+    xmax = (width + margin) * 256
+    ymax = (height + margin) * 256
+    i = 0
+    while i < count:
+        o = i * STRIDE
+        age = s[o + _AGE] + dt
+        life = s[o + _LIFE]
+        x = s[o + _X] + _mul_div(s[o + _VX], dt)
+        y = s[o + _Y] + _mul_div(s[o + _VY], dt)
+        if age >= life or x < xmin or x > xmax or y > ymax:
+            count -= 1
+            if i != count:
+                last = count * STRIDE
+                for k in range(STRIDE):
+                    s[o + k] = s[last + k]
+            continue
+        s[o + _X] = x
+        s[o + _Y] = y
+        s[o + _VY] += dvy
+        s[o + _ROT] = (s[o + _ROT] + _mul_div(s[o + _SPIN], dt)) % 3600
+        s[o + _AGE] = age
+        scale = 256 - (256 - _MIN_SCALE) * age // life
+        s[o + _SCALE] = scale if scale > _MIN_SCALE else _MIN_SCALE
+        i += 1
+    return count
+
+
+step = _native.step if _native else _step_py
+
+
+class ParticleEmitter:
+    """
+    Fixed-capacity particle system drawn onto one transparent full-size object.
+
+    Args:
+        parent: LVGL object to draw on (lv.layer_top() for overlays)
+        sources: image sources; a particle's kind indexes this list
+        max_particles: capacity of the packed state array
+        gravity: downward acceleration in px/s^2
+        margin: how far (px) particles may leave the sides/bottom before dying
+    """
+
+    def __init__(self, parent, sources, max_particles=256, gravity=100, margin=60):
+        self.max_particles = max_particles
+        self.gravity = gravity
+        self.margin = margin
+        self.state = array("i", [0] * (max_particles * STRIDE))
+        self.count = 0
+        self.running = False
+        self.on_frame = None  # optional callable(dt_ms), e.g. to spawn particles
+        self.on_finished = None  # optional callable() once stopped and empty
+
+        self.width = DisplayMetrics.width()
+        self.height = DisplayMetrics.height()
+
+        self.sources = list(sources)
+        self.src_width = []
+        self.src_height = []
+        self.src_scale = []  # per-source scale multiplier, 256 = 1.0
+        probe = lv.image(parent)
+        try:
+            header = lv.image_header_t()
+            for src in self.sources:
+                header.w = header.h = 0
+                probe.decoder_get_info(src, header)
+                self.src_width.append(max(1, int(header.w)))
+                self.src_height.append(max(1, int(header.h)))
+                self.src_scale.append(256)
+        finally:
+            probe.delete()
+
+        obj = lv.obj(parent)
+        obj.remove_style_all()
+        obj.set_size(self.width, self.height)
+        obj.set_pos(0, 0)
+        obj.remove_flag(lv.obj.FLAG.CLICKABLE)
+        obj.remove_flag(lv.obj.FLAG.SCROLLABLE)
+        obj.add_flag(lv.obj.FLAG.HIDDEN)
+        obj.add_event_cb(self._draw, lv.EVENT.DRAW_MAIN, None)
+        self.obj = obj
+
+        self._dsc = lv.draw_image_dsc_t()
+        self._dsc.init()
+        self._area = lv.area_t()
+        self._coords = lv.area_t()
+        self._timer = None
+        self._last_ms = 0
+
+    def emit(self, x, y, vx, vy, life_ms, rotation=0, spin=0, kind=0):
+        """
+        Add one particle at (x, y) px with velocity (vx, vy) px/s,
+        rotation in degrees and spin in degrees/s.
+        Returns False if the emitter is full.
+        """
+        if self.count >= self.max_particles:
+            return False
+        s = self.state
+        o = self.count * STRIDE
+        s[o + _X] = int(x * 256)
+        s[o + _Y] = int(y * 256)
+        s[o + _VX] = int(vx * 256)
+        s[o + _VY] = int(vy * 256)
+        s[o + _ROT] = int(rotation * 10) % 3600
+        s[o + _SPIN] = int(spin * 10)
+        s[o + _AGE] = 0
+        s[o + _LIFE] = max(1, int(life_ms))
+        s[o + _KIND] = kind
+        s[o + _SCALE] = 256
+        self.count += 1
+        return True
+
+    def clear(self):
+        self.count = 0
+        self.obj.invalidate()
+
+    def start(self):
+        """Start (or resume) calling on_frame and animating at up to 60 fps."""
+        self.running = True
+        self.obj.remove_flag(lv.obj.FLAG.HIDDEN)
+        if self._timer is None:
+            self._last_ms = time.ticks_ms()
+            self._timer = lv.timer_create(self._tick, 16, None)
+
+    def stop(self):
+        """Stop calling on_frame; live particles keep flying until they die."""
+        self.running = False
+
+    def delete(self):
+        if self._timer:
+            self._timer.delete()
+            self._timer = None
+        self.obj.delete()
+
+    def advance(self, dt_ms):
+        """Run one frame of dt_ms: on_frame (while running), then integrate."""
+        if self.running and self.on_frame:
+            self.on_frame(dt_ms)
+        self.count = step(self.state, self.count, min(dt_ms, _MAX_DT_MS),
+                          self.gravity, self.width, self.height, self.margin)
+        self.obj.invalidate()
+
+    def _tick(self, timer):
+        now = time.ticks_ms()
+        dt = time.ticks_diff(now, self._last_ms)
+        self._last_ms = now
+        self.advance(dt)
+        if not self.running and not self.count:
+            self._timer.delete()
+            self._timer = None
+            self.obj.add_flag(lv.obj.FLAG.HIDDEN)
+            if self.on_finished:
+                self.on_finished()
+
+    def _draw(self, event):
+        layer = event.get_layer()
+        self.obj.get_coords(self._coords)
+        ox = self._coords.x1
+        oy = self._coords.y1
+        s = self.state
+        dsc = self._dsc
+        area = self._area
+        widths = self.src_width
+        heights = self.src_height
+        for i in range(self.count):
+            o = i * STRIDE
+            k = s[o + _KIND]
+            w = widths[k]
+            h = heights[k]
+            x = ox + (s[o + _X] >> 8)
+            y = oy + (s[o + _Y] >> 8)
+            scale = s[o + _SCALE] * self.src_scale[k] >> 8
+            dsc.src = self.sources[k]
+            dsc.rotation = s[o + _ROT]
+            dsc.scale_x = scale
+            dsc.scale_y = scale
+            dsc.pivot.x = w >> 1
+            dsc.pivot.y = h >> 1
+            area.x1 = x
+            area.y1 = y
+            area.x2 = x + w - 1
+            area.y2 = y + h - 1
+            lv.draw_image(layer, dsc, area)
@@ -0,0 +1,310 @@
+"""
+Sprite layer widget for arcade-style games.
+
+Sprites are rows in one packed array('h') (position, bitmap, visibility)
+drawn in a single DRAW_MAIN pass onto one transparent object, instead of one
+LVGL object per sprite. flush() compares the table against what was drawn
+last time and invalidates a few merged dirty rectangles, so a formation of
+sprites moving together costs one redraw area instead of dozens.
+
+Usage:
+    layer = SpriteLayer(game_area, width, height)
+    ship = layer.add_bitmap(("  #  ", " ### ", "#####"), lv.color_hex(0x00FFFF))
+    shot = layer.add_rect(4, 12, lv.color_hex(0xFFFF00), radius=2)
+    player = layer.add_sprite(ship)
+    layer.move(player, 100, 200)
+    layer.show(player)
+    ...
+    layer.flush()  # once per frame, after moving sprites
+"""
+
+from array import array
+
+import lvgl as lv
+
+# Words per sprite in SpriteLayer.table
+STRIDE = 4
+_X, _Y, _BITMAP, _VISIBLE = range(STRIDE)
+
+# Dirty rectangles kept per flush; more changes get merged into these
+_MAX_DIRTY = 6
+# Extra area (px) two rectangles may waste and still be merged into one
+_MERGE_SLACK = 256
+
+
+def _bitmap_dsc(rows, color, w, h):
+    # ARGB8888 image (bytes B, G, R, A) with color wherever a row has '#'
+    stride = w * 4
+    buf = bytearray(stride * h)
+    r, g, b = color.red, color.green, color.blue
+    for y, row in enumerate(rows):
+        if y >= h:
+            break
+        o = y * stride
+        for x, ch in enumerate(row):
+            if x >= w:
+                break
+            if ch == "#":
+                p = o + x * 4
+                buf[p] = b
+                buf[p + 1] = g
+                buf[p + 2] = r
+                buf[p + 3] = 255
+    dsc = lv.image_dsc_t()
+    dsc.header.magic = lv.IMAGE_HEADER_MAGIC
+    dsc.header.cf = lv.COLOR_FORMAT.ARGB8888
+    dsc.header.w = w
+    dsc.header.h = h
+    dsc.header.stride = stride
+    dsc.data_size = len(buf)
+    dsc.data = buf
+    return dsc, buf
+
+
+class SpriteLayer:
+    """
+    Fixed-capacity set of sprites drawn onto one transparent object.
+
+    Args:
+        parent: LVGL object the layer covers, from (0, 0)
+        width, height: layer size in px
+        max_sprites: capacity of the sprite table
+    """
+
+    def __init__(self, parent, width, height, max_sprites=64):
+        self.max_sprites = max_sprites
+        self.count = 0
+        self.table = array("h", [0] * (max_sprites * STRIDE))
+        # Rectangle (x1, y1, x2, y2) each sprite was last flushed at, x2 < x1 if none
+        self._drawn = array("h", [0, 0, -1, -1] * max_sprites)
+        self._dirty = array("h", [0] * (_MAX_DIRTY * 4))
+        self._n_dirty = 0
+
+        self.widths = []
+        self.heights = []
+        self._images = []  # image dsc, or None for rectangles
+        self._rects = []  # draw_rect_dsc_t, or None for images
+        self._buffers = []  # keeps image pixel data alive
+
+        # Totals for benchmarking: flushes, invalidated rectangles and pixels
+        self.flushes = 0
+        self.invalidated_rects = 0
+        self.invalidated_px = 0
+
+        obj = lv.obj(parent)
+        obj.remove_style_all()
+        obj.set_size(width, height)
+        obj.set_pos(0, 0)
+        obj.remove_flag(lv.obj.FLAG.CLICKABLE)
+        obj.remove_flag(lv.obj.FLAG.SCROLLABLE)
+        obj.add_event_cb(self._draw, lv.EVENT.DRAW_MAIN, None)
+        self.obj = obj
+
+        self._img_dsc = lv.draw_image_dsc_t()
+        self._img_dsc.init()
+        self._area = lv.area_t()
+        self._coords = lv.area_t()
+
+    # ------------------------------------------------------------------
+    # Bitmaps
+    # ------------------------------------------------------------------
+
+    def add_bitmap(self, rows, color, w=None, h=None):
+        """
+        Add a one-color bitmap from text rows ('#' = pixel) and return its
+        index. The size defaults to the widest row by the number of rows.
+        """
+        if w is None:
+            w = max(len(row) for row in rows)
+        if h is None:
+            h = len(rows)
+        dsc, buf = _bitmap_dsc(rows, color, w, h)
+        self._images.append(dsc)
+        self._rects.append(None)
+        self._buffers.append(buf)
+        self.widths.append(w)
+        self.heights.append(h)
+        return len(self.widths) - 1
+
+    def add_rect(self, w, h, color, radius=0):
+        """Add a filled (rounded) rectangle bitmap and return its index."""
+        dsc = lv.draw_rect_dsc_t()
+        dsc.init()
+        dsc.bg_color = color
+        dsc.bg_opa = lv.OPA.COVER
+        dsc.radius = radius
+        self._images.append(None)
+        self._rects.append(dsc)
+        self._buffers.append(None)
+        self.widths.append(w)
+        self.heights.append(h)
+        return len(self.widths) - 1
+
+    # ------------------------------------------------------------------
+    # Sprites
+    # ------------------------------------------------------------------
+
+    def add_sprite(self, bitmap):
+        """Add a hidden sprite showing bitmap and return its index, drawn above earlier ones."""
+        if self.count >= self.max_sprites:
+            raise ValueError("sprite layer is full")
+        o = self.count * STRIDE
+        t = self.table
+        t[o + _X] = 0
+        t[o + _Y] = 0
+        t[o + _BITMAP] = bitmap
+        t[o + _VISIBLE] = 0
+        self.count += 1
+        return self.count - 1
+
+    def move(self, sprite, x, y):
+        o = sprite * STRIDE
+        self.table[o + _X] = int(x)
+        self.table[o + _Y] = int(y)
+
+    def set_bitmap(self, sprite, bitmap):
+        self.table[sprite * STRIDE + _BITMAP] = bitmap
+
+    def show(self, sprite):
+        self.table[sprite * STRIDE + _VISIBLE] = 1
+
+    def hide(self, sprite):
+        self.table[sprite * STRIDE + _VISIBLE] = 0
+
+    def is_visible(self, sprite):
+        return self.table[sprite * STRIDE + _VISIBLE] != 0
+
+    def delete(self):
+        self.obj.delete()
+
+    # ------------------------------------------------------------------
+    # Invalidation
+    # ------------------------------------------------------------------
+
+    def _add_dirty(self, x1, y1, x2, y2):
+        d = self._dirty
+        area = (x2 - x1 + 1) * (y2 - y1 + 1)
+        best = -1
+        best_growth = 0
+        for k in range(self._n_dirty):
+            o = k * 4
+            a1 = d[o]
+            b1 = d[o + 1]
+            a2 = d[o + 2]
+            b2 = d[o + 3]
+            u1 = a1 if a1 < x1 else x1
+            v1 = b1 if b1 < y1 else y1
+            u2 = a2 if a2 > x2 else x2
+            v2 = b2 if b2 > y2 else y2
+            growth = (u2 - u1 + 1) * (v2 - v1 + 1) - (a2 - a1 + 1) * (b2 - b1 + 1) - area
+            if best < 0 or growth < best_growth:
+                best = k
+                best_growth = growth
+        if best >= 0 and (best_growth <= _MERGE_SLACK or self._n_dirty == _MAX_DIRTY):
+            o = best * 4
+            if x1 < d[o]:
+                d[o] = x1
+            if y1 < d[o + 1]:
+                d[o + 1] = y1
+            if x2 > d[o + 2]:
+                d[o + 2] = x2
+            if y2 > d[o + 3]:
+                d[o + 3] = y2
+            return
+        o = self._n_dirty * 4
+        d[o] = x1
+        d[o + 1] = y1
+        d[o + 2] = x2
+        d[o + 3] = y2
+        self._n_dirty += 1
+
+    def flush(self):
+        """
+        Invalidate what changed since the last flush as a few merged
+        rectangles. Returns the number of rectangles invalidated.
+        """
+        t = self.table
+        drawn = self._drawn
+        widths = self.widths
+        heights = self.heights
+        self._n_dirty = 0
+        for i in range(self.count):
+            o = i * STRIDE
+            p = i * 4
+            if t[o + _VISIBLE]:
+                b = t[o + _BITMAP]
+                x1 = t[o + _X]
+                y1 = t[o + _Y]
+                x2 = x1 + widths[b] - 1
+                y2 = y1 + heights[b] - 1
+            else:
+                x1 = y1 = 0
+                x2 = y2 = -1
+            px1 = drawn[p]
+            py1 = drawn[p + 1]
+            px2 = drawn[p + 2]
+            py2 = drawn[p + 3]
+            if x1 == px1 and y1 == py1 and x2 == px2 and y2 == py2:
+                continue
+            if px2 >= px1:
+                self._add_dirty(px1, py1, px2, py2)
+            if x2 >= x1:
+                self._add_dirty(x1, y1, x2, y2)
+            drawn[p] = x1
+            drawn[p + 1] = y1
+            drawn[p + 2] = x2
+            drawn[p + 3] = y2
+
+        n = self._n_dirty
+        self.flushes += 1
+        if not n:
+            return 0
+        self.obj.get_coords(self._coords)
+        ox = self._coords.x1
+        oy = self._coords.y1
+        d = self._dirty
+        area = self._area
+        for k in range(n):
+            o = k * 4
+            area.x1 = ox + d[o]
+            area.y1 = oy + d[o + 1]
+            area.x2 = ox + d[o + 2]
+            area.y2 = oy + d[o + 3]
+            self.obj.invalidate_area(area)
+            self.invalidated_px += (d[o + 2] - d[o] + 1) * (d[o + 3] - d[o + 1] + 1)
+        self.invalidated_rects += n
+        return n
+
+    # ------------------------------------------------------------------
+    # Drawing
+    # ------------------------------------------------------------------
+
+    def _draw(self, event):
+        layer = event.get_layer()
+        self.obj.get_coords(self._coords)
+        ox = self._coords.x1
+        oy = self._coords.y1
+        t = self.table
+        images = self._images
+        rects = self._rects
+        widths = self.widths
+        heights = self.heights
+        img_dsc = self._img_dsc
+        area = self._area
+        for i in range(self.count):
+            o = i * STRIDE
+            if not t[o + _VISIBLE]:
+                continue
+            b = t[o + _BITMAP]
+            x = ox + t[o + _X]
+            y = oy + t[o + _Y]
+            area.x1 = x
+            area.y1 = y
+            area.x2 = x + widths[b] - 1
+            area.y2 = y + heights[b] - 1
+            image = images[b]
+            if image is None:
+                lv.draw_rect(layer, rects[b], area)
+            else:
+                img_dsc.src = image
+                lv.draw_image(layer, img_dsc, area)
@@ -12,10 +12,10 @@ from .focus import add_focus_border
 from .font_manager import FontManager
 from mpos.content.app_manager import AppManager
 from mpos.notification_manager import NotificationManager
+from mpos.status_service import StatusService
 
 logger = logging.getLogger(__name__)
 
-CLOCK_UPDATE_INTERVAL = 1000 # 10 or even 1 ms doesn't seem to change the framerate but 100ms is enough
 WIFI_ICON_UPDATE_INTERVAL = 1500
 BATTERY_ICON_UPDATE_INTERVAL = 15000 # not too often, but not too short, otherwise it takes a while to appear
 TEMPERATURE_UPDATE_INTERVAL = 2000
@@ -23,6 +23,7 @@ MEMFREE_UPDATE_INTERVAL = 5000 # not too frequent because there's a forced gc.co
 
 BAR_ANIM_DURATION = 1000
 DRAWER_ANIM_DURATION = 1000
+DRAWER_REFRESH_INTERVAL = 50 # coalesces bursts of notification updates into one drawer redraw
 
 scroll_start_y = None
 
@@ -41,11 +42,17 @@ drawer_notifications_title = None
 drawer_notifications_container = None
 
 _notifications_listener_registered = False
+_drawer_rows = {}              # notification_id -> [card, icon, title_label, text_label, (icon, title, text) shown]
+_drawer_row_order = []         # notification_ids of the cards, in drawer order
+_drawer_empty_label = None
+_drawer_title_count = None
+_drawer_dirty = False          # notifications changed since the drawer was last refreshed
+_drawer_refresh_timer = None
 
 _drawer_slider = None          # brightness slider; receives focus when the drawer opens
 _drawer_focusables = []        # widgets added to / removed from the focus group when drawer opens/closes
 _bar_focusables = []           # widgets added to / removed from the focus group when bar opens/closes
-_drawer_notif_focusables = []  # notification item_buttons; synced with focus group on every refresh
+_drawer_notif_focusables = []  # notification cards in drawer order; in the focus group while the drawer is open
 _pre_drawer_focused = None     # widget that had focus before the drawer was opened
 
 
@@ -95,9 +102,11 @@ def _set_notification_icon(notification):
     """Update the bell indicator in the top notification bar (label widget only)."""
     if notification_icon_label is None:
         return
+    hidden = notification_icon_label.has_flag(lv.obj.FLAG.HIDDEN)
     if notification is None:
-        notification_icon_label.add_flag(lv.obj.FLAG.HIDDEN)
-    else:
+        if not hidden:
+            notification_icon_label.add_flag(lv.obj.FLAG.HIDDEN)
+    elif hidden:
         notification_icon_label.remove_flag(lv.obj.FLAG.HIDDEN)
 
 
@@ -107,7 +116,38 @@ def _notification_pressed(event, notification_id):
     close_drawer()
 
 
+def _build_drawer_notification_icon(card, icon):
+    """Create the icon widget at the start of a drawer card, or return None if there is none."""
+    icon_size = DisplayMetrics.pct_of_width(12)
+    if _icon_is_image_path(icon) or (icon is not None and not isinstance(icon, str)):
+        icon_widget = lv.image(card)
+        try:
+            icon_widget.set_src(icon)
+            icon_widget.set_size(icon_size, icon_size)
+            icon_widget.set_style_pad_all(0, lv.PART.MAIN)
+            icon_widget.add_flag(lv.obj.FLAG.EVENT_BUBBLE)
+            header = lv.image_header_t()
+            icon_widget.decoder_get_info(icon, header)
+            if header.w > 0 and header.h > 0:
+                scale_factor_w = round(icon_size * 256 / header.w)
+                scale_factor_h = round(icon_size * 256 / header.h)
+                icon_widget.set_scale(min(scale_factor_w, scale_factor_h))
+        except Exception:
+            icon_widget.delete()
+            return None
+    elif isinstance(icon, str):
+        icon_widget = lv.label(card)
+        icon_widget.set_text(icon)
+        icon_widget.add_flag(lv.obj.FLAG.EVENT_BUBBLE)
+        icon_widget.remove_flag(lv.obj.FLAG.SCROLLABLE)
+    else:
+        return None
+    icon_widget.move_to_index(0)
+    return icon_widget
+
+
 def _build_drawer_notification_item(parent, notification):
+    """Create a drawer card; returns its row: [card, icon, title_label, text_label, shown]."""
     card = lv.obj(parent)
     card.set_width(lv.pct(100))
     card.set_height(DisplayMetrics.pct_of_height(20))
@@ -130,30 +170,6 @@ def _build_drawer_notification_item(parent, notification):
     )
     _register_focus_callbacks(card)
 
-    icon = notification.icon
-    icon_size = DisplayMetrics.pct_of_width(12)
-
-    if _icon_is_image_path(icon) or (icon is not None and not isinstance(icon, str)):
-        try:
-            icon_widget = lv.image(card)
-            icon_widget.set_src(icon)
-            icon_widget.set_size(icon_size, icon_size)
-            icon_widget.set_style_pad_all(0, lv.PART.MAIN)
-            icon_widget.add_flag(lv.obj.FLAG.EVENT_BUBBLE)
-            header = lv.image_header_t()
-            icon_widget.decoder_get_info(icon, header)
-            if header.w > 0 and header.h > 0:
-                scale_factor_w = round(icon_size * 256 / header.w)
-                scale_factor_h = round(icon_size * 256 / header.h)
-                icon_widget.set_scale(min(scale_factor_w, scale_factor_h))
-        except Exception:
-            icon = None
-    if isinstance(icon, str) and not _icon_is_image_path(icon):
-        icon_label = lv.label(card)
-        icon_label.set_text(icon)
-        icon_label.add_flag(lv.obj.FLAG.EVENT_BUBBLE)
-        icon_label.remove_flag(lv.obj.FLAG.SCROLLABLE)
-
     content_col = lv.obj(card)
     content_col.remove_flag(lv.obj.FLAG.SCROLLABLE)
     content_col.add_flag(lv.obj.FLAG.EVENT_BUBBLE)
@@ -167,72 +183,148 @@ def _build_drawer_notification_item(parent, notification):
     content_col.set_flex_grow(1)
 
     title_label = lv.label(content_col)
-    title_label.set_text(notification.title)
-    emoji_font = FontManager.getFont(emoji=True)
-    title_label.set_style_text_font(emoji_font, lv.PART.MAIN)
+    title_label.set_style_text_font(FontManager.getFont(emoji=True), lv.PART.MAIN)
     title_label.set_long_mode(lv.label.LONG_MODE.WRAP)
     title_label.set_width(lv.pct(100))
     title_label.add_flag(lv.obj.FLAG.EVENT_BUBBLE)
     title_label.remove_flag(lv.obj.FLAG.SCROLLABLE)
 
-    if notification.text:
-        text_label = lv.label(content_col)
-        text_label.set_style_text_font(emoji_font, lv.PART.MAIN)
-        text_label.set_text(notification.text)
-        text_label.set_long_mode(lv.label.LONG_MODE.WRAP)
-        text_label.set_width(lv.pct(100))
-        text_label.set_style_text_opa(lv.OPA._60, lv.PART.MAIN)
-        text_label.add_flag(lv.obj.FLAG.EVENT_BUBBLE)
-        text_label.remove_flag(lv.obj.FLAG.SCROLLABLE)
+    row = [card, None, title_label, None, None]
+    _update_drawer_notification_item(row, notification)
+    return row
+
+
+def _update_drawer_notification_item(row, notification):
+    """Patch a drawer card to show notification, touching only the widgets whose content changed."""
+    shown = row[4]
+    icon, title, text = notification.icon, notification.title, notification.text
+    if shown is None or shown[0] != icon:
+        if row[1] is not None:
+            row[1].delete()
+        row[1] = _build_drawer_notification_icon(row[0], icon)
+    if shown is None or shown[1] != title:
+        row[2].set_text(title)
+    if shown is None or shown[2] != text:
+        text_label = row[3]
+        if text:
+            if text_label is None:
+                text_label = lv.label(row[2].get_parent())
+                text_label.set_style_text_font(FontManager.getFont(emoji=True), lv.PART.MAIN)
+                text_label.set_long_mode(lv.label.LONG_MODE.WRAP)
+                text_label.set_width(lv.pct(100))
+                text_label.set_style_text_opa(lv.OPA._60, lv.PART.MAIN)
+                text_label.add_flag(lv.obj.FLAG.EVENT_BUBBLE)
+                text_label.remove_flag(lv.obj.FLAG.SCROLLABLE)
+                row[3] = text_label
+            else:
+                text_label.remove_flag(lv.obj.FLAG.HIDDEN)
+            text_label.set_text(text)
+        elif text_label is not None:
+            text_label.add_flag(lv.obj.FLAG.HIDDEN)
+    row[4] = (icon, title, text)
+
 
-    return card
+def _set_drawer_notifications_title(count):
+    global _drawer_title_count
+    if count == _drawer_title_count:
+        return
+    _drawer_title_count = count
+    if count:
+        drawer_notifications_title.set_text(lv.SYMBOL.BELL + " Notifications (" + str(count) + ")")
+    else:
+        drawer_notifications_title.set_text(lv.SYMBOL.BELL + " Notifications")
 
 
 def _refresh_drawer_notifications():
-    global _drawer_notif_focusables
+    """
+    Bring the drawer cards in line with the notifications, keyed by
+    notification_id: cards of unchanged notifications are kept as they are,
+    updated ones are patched in place and only added/removed ones are
+    created/deleted.
+    """
+    global _drawer_notif_focusables, _drawer_row_order, _drawer_empty_label, _drawer_dirty
     if drawer_notifications_container is None or drawer_notifications_title is None:
         return
-
-    # Remove stale notification buttons from the focus group before cleaning the container.
-    if drawer_open:
-        _remove_focusables_from_group(_drawer_notif_focusables)
-    _drawer_notif_focusables = []
+    _drawer_dirty = False
 
     notifications = NotificationManager.get_notifications()
-    drawer_notifications_container.clean()
-
-    if not notifications:
-        drawer_notifications_title.set_text(lv.SYMBOL.BELL + " Notifications")
-        empty_label = lv.label(drawer_notifications_container)
-        empty_label.set_text("No notifications")
-        empty_label.align(lv.ALIGN.TOP_LEFT, 0, 0)
-        return
+    rows = _drawer_rows
+    order = [n.notification_id for n in notifications]
 
-    drawer_notifications_title.set_text(
-        lv.SYMBOL.BELL + " Notifications (" + str(len(notifications)) + ")"
-    )
+    if order != _drawer_row_order:
+        live = set(order)
+        for notification_id in [nid for nid in rows if nid not in live]:
+            # Deleting the card also takes it out of the focus group
+            rows.pop(notification_id)[0].delete()
 
     for notification in notifications:
-        btn = _build_drawer_notification_item(drawer_notifications_container, notification)
-        _drawer_notif_focusables.append(btn)
+        row = rows.get(notification.notification_id)
+        if row is None:
+            rows[notification.notification_id] = _build_drawer_notification_item(
+                drawer_notifications_container, notification)
+        else:
+            _update_drawer_notification_item(row, notification)
+
+    if order != _drawer_row_order:
+        for index, notification_id in enumerate(order):
+            card = rows[notification_id][0]
+            if card.get_index() != index:
+                card.move_to_index(index)
+        _drawer_row_order = order
+        _drawer_notif_focusables = [rows[nid][0] for nid in order]
+        # If the drawer is open, (re-)add the cards so the focus order follows the drawer
+        if drawer_open:
+            group = lv.group_get_default()
+            if group:
+                for card in _drawer_notif_focusables:
+                    lv.group_remove_obj(card)
+                    group.add_obj(card)
+
+    _set_drawer_notifications_title(len(order))
+    if not order:
+        if _drawer_empty_label is None:
+            _drawer_empty_label = lv.label(drawer_notifications_container)
+            _drawer_empty_label.set_text("No notifications")
+            _drawer_empty_label.align(lv.ALIGN.TOP_LEFT, 0, 0)
+        else:
+            _drawer_empty_label.remove_flag(lv.obj.FLAG.HIDDEN)
+    elif _drawer_empty_label is not None:
+        _drawer_empty_label.add_flag(lv.obj.FLAG.HIDDEN)
 
-    # If the drawer is already open, add the new buttons to the focus group immediately.
-    if drawer_open:
-        _add_focusables_to_group(_drawer_notif_focusables)
+
+def _drawer_refresh_timer_cb(timer):
+    global _drawer_refresh_timer
+    _drawer_refresh_timer = None
+    if _drawer_dirty and drawer_open:
+        _refresh_drawer_notifications()
 
 
 def _refresh_notification_widgets():
-    notifications = NotificationManager.get_notifications()
-    top_notification = notifications[0] if notifications else None
-    _set_notification_icon(top_notification)
+    _set_notification_icon(NotificationManager.get_top_notification())
     _refresh_drawer_notifications()
 
 
+def _on_notifications_changed():
+    """
+    Notification listener. The bell follows at once; the drawer is refreshed
+    at most once per DRAWER_REFRESH_INTERVAL while it is open (so bursts of
+    progress updates coalesce into one redraw) and on the next open_drawer()
+    while it is closed.
+    """
+    global _drawer_dirty, _drawer_refresh_timer
+    _set_notification_icon(NotificationManager.get_top_notification())
+    _drawer_dirty = True
+    if not drawer_open or _drawer_refresh_timer is not None:
+        return
+    _drawer_refresh_timer = lv.timer_create(_drawer_refresh_timer_cb, DRAWER_REFRESH_INTERVAL, None)
+    _drawer_refresh_timer.set_repeat_count(1)
+
+
 def _register_notifications_listener():
     global _notifications_listener_registered
     if _notifications_listener_registered:
         return
-    NotificationManager.register_listener(_refresh_notification_widgets, notify_immediately=False)
+    NotificationManager.register_listener(_on_notifications_changed, notify_immediately=False)
     _notifications_listener_registered = True
 
 def toggle_drawer():
@@ -248,6 +340,8 @@ def open_drawer():
     # Save the currently focused widget so we can restore it on close.
     group = lv.group_get_default()
     _pre_drawer_focused = group.get_focused() if group else None
+    if _drawer_dirty:
+        _refresh_drawer_notifications()
     open_bar()
     drawer_open = True
     _drawer_panel.show()
@@ -279,6 +373,14 @@ def close_drawer(to_launcher=False):
             pass
         _pre_drawer_focused = None
 
+def _set_status_visible(visible):
+    # While the bar is hidden the clock only needs minute wake-ups and the
+    # polled sources (sensor, ADC, Wi-Fi) aren't sampled at all; showing it
+    # samples them at once
+    StatusService.set_clock_seconds(visible)
+    for key in (StatusService.WIFI, StatusService.BATTERY, StatusService.TEMPERATURE):
+        StatusService.set_poller_paused(key, not visible)
+
 def open_bar():
     global bar_open
     if __debug__: logger.debug("opening bar...")
@@ -288,6 +390,7 @@ def open_bar():
     bar_open = True
     _bar_panel.show()
     _add_focusables_to_group(_bar_focusables)
+    _set_status_visible(True)
 
 def close_bar(animate=True):
     global bar_open
@@ -296,6 +399,7 @@ def close_bar(animate=True):
     bar_open = False
     _bar_panel.hide(animate=animate)
     _remove_focusables_from_group(_bar_focusables)
+    _set_status_visible(False)
 
 
 
@@ -334,6 +438,20 @@ def create_notification_bar():
     wifi_icon.add_flag(lv.obj.FLAG.HIDDEN)
     wifi_icon.align(lv.ALIGN.RIGHT_MID, -DisplayMetrics.pct_of_width(10), 0)
 
+    # The labels only change when StatusService publishes a new value, so an
+    # idle bar doesn't redraw
+    def show_time(value):
+        time_label.set_text("%02d:%02d:%02d" % value)
+
+    def show_wifi(connected):
+        if connected:
+            wifi_icon.remove_flag(lv.obj.FLAG.HIDDEN)
+        else:
+            wifi_icon.add_flag(lv.obj.FLAG.HIDDEN)
+
+    def show_temperature(temp):
+        temp_label.set_text("--°C" if temp is None else f"{temp}°C")
+
     # Battery percentage
     if BatteryManager.has_battery():
         # Battery icon
@@ -343,45 +461,47 @@ def create_notification_bar():
         battery_icon.align(lv.ALIGN.RIGHT_MID, -DisplayMetrics.pct_of_width(10), 0)
         wifi_icon.align_to(battery_icon, lv.ALIGN.OUT_LEFT_MID, -DisplayMetrics.pct_of_width(1), 0)
         battery_icon.add_flag(lv.obj.FLAG.HIDDEN) # keep it hidden until it has a correct value
-        def update_battery_icon(timer=None):
-            try:
-                percent = BatteryManager.get_battery_percentage()
-            except Exception as e:
-                logger.error("BatteryManager.get_battery_percentage got exception, not updating battery_icon: %s", e)
+        shown_symbol = [None]
+
+        def show_battery(percent):
+            if percent is None:
                 return
             if percent > 80:
-                battery_icon.set_text(lv.SYMBOL.BATTERY_FULL)
+                symbol = lv.SYMBOL.BATTERY_FULL
             elif percent > 60:
-                battery_icon.set_text(lv.SYMBOL.BATTERY_3)
+                symbol = lv.SYMBOL.BATTERY_3
             elif percent > 40:
-                battery_icon.set_text(lv.SYMBOL.BATTERY_2)
+                symbol = lv.SYMBOL.BATTERY_2
             elif percent > 20:
-                battery_icon.set_text(lv.SYMBOL.BATTERY_1)
+                symbol = lv.SYMBOL.BATTERY_1
             else:
-                battery_icon.set_text(lv.SYMBOL.BATTERY_EMPTY)
+                symbol = lv.SYMBOL.BATTERY_EMPTY
+            if symbol == shown_symbol[0]:
+                return
+            shown_symbol[0] = symbol
+            battery_icon.set_text(symbol)
             battery_icon.align(lv.ALIGN.RIGHT_MID, -DisplayMetrics.pct_of_width(10), 0)
             wifi_icon.align_to(battery_icon, lv.ALIGN.OUT_LEFT_MID, -DisplayMetrics.pct_of_width(1), 0)
             battery_icon.remove_flag(lv.obj.FLAG.HIDDEN)
             # Percentage is not shown for now:
             #battery_label.set_text(f"{round(percent)}%")
             #battery_label.remove_flag(lv.obj.FLAG.HIDDEN)
-        update_battery_icon() # run it immediately instead of waiting for the timer
-        lv.timer_create(update_battery_icon, BATTERY_ICON_UPDATE_INTERVAL, None)
-
-    # Update time
-    def update_time(timer):
-        hours = mpos.time.localtime()[3]
-        minutes = mpos.time.localtime()[4]
-        seconds = mpos.time.localtime()[5]
-        time_label.set_text(f"{hours:02d}:{minutes:02d}:{seconds:02d}")
-    
-    def update_wifi_icon(timer):
+
+        StatusService.subscribe(StatusService.BATTERY, show_battery)
+        def read_battery():
+            # Served from the sampler's estimate, so it doesn't disable WiFi for ADC2 itself;
+            # None (icon stays as is) until the sampler got a first sample
+            if not BatteryManager.has_estimate():
+                return None
+            return round(BatteryManager.get_battery_percentage())
+
+        BatteryManager.start_sampling()
+        StatusService.add_poller(StatusService.BATTERY, read_battery, BATTERY_ICON_UPDATE_INTERVAL)
+
+    def read_wifi():
         from mpos import WifiService
-        if WifiService.is_connected():
-            wifi_icon.remove_flag(lv.obj.FLAG.HIDDEN)
-        else:
-            wifi_icon.add_flag(lv.obj.FLAG.HIDDEN)
-    
+        return WifiService.is_connected()
+
     # Get temperature sensor via SensorManager
     from mpos import SensorManager
     temp_sensor = None
@@ -391,20 +511,20 @@ def create_notification_bar():
         if not temp_sensor:
             temp_sensor = SensorManager.get_default_sensor(SensorManager.TYPE_IMU_TEMPERATURE)
 
-    def update_temperature(timer):
-        if temp_sensor:
-            temp = SensorManager.read_sensor(temp_sensor)
-            if temp is not None:
-                temp_label.set_text(f"{round(temp)}°C")
-            else:
-                temp_label.set_text("--°C")
-        else:
-            temp_label.set_text("42°C")
-    
-    lv.timer_create(update_time, CLOCK_UPDATE_INTERVAL, None)
-    lv.timer_create(update_temperature, TEMPERATURE_UPDATE_INTERVAL, None)
+    def read_temperature():
+        if not temp_sensor:
+            return 42
+        temp = SensorManager.read_sensor(temp_sensor)
+        return None if temp is None else round(temp)
+
+    StatusService.subscribe(StatusService.CLOCK, show_time)
+    StatusService.subscribe(StatusService.WIFI, show_wifi)
+    StatusService.subscribe(StatusService.TEMPERATURE, show_temperature)
+    StatusService.start_clock(seconds=bar_open)
+    StatusService.add_poller(StatusService.WIFI, read_wifi, WIFI_ICON_UPDATE_INTERVAL)
+    StatusService.add_poller(StatusService.TEMPERATURE, read_temperature, TEMPERATURE_UPDATE_INTERVAL)
+    _set_status_visible(bar_open)
     #lv.timer_create(update_memfree, MEMFREE_UPDATE_INTERVAL, None)
-    lv.timer_create(update_wifi_icon, WIFI_ICON_UPDATE_INTERVAL, None)
 
     _register_notifications_listener()
     _refresh_notification_widgets()
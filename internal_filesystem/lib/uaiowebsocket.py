@@ -5,6 +5,7 @@
 import uasyncio as asyncio
 import logging
 import time
+import micropython
 import ucollections
 import aiohttp
 from aiohttp import WSMsgType
@@ -12,10 +13,12 @@ from aiohttp import WSMsgType
 logger = logging.getLogger(__name__)
 
 
-# Simplified logging for MicroPython with timestamps
-def _log_debug(msg):
+# Simplified logging for MicroPython with timestamps. Pass formatting
+# arguments separately (wrapping costly ones in logging.Lazy) so that nothing
+# is formatted when debug logging is off.
+def _log_debug(msg, *args):
     if __debug__:
-        logger.debug("%s", msg)
+        logger.debug(msg, *args)
 
 def _log_error(msg):
     logger.error("%s", msg)
@@ -64,45 +67,108 @@ def _next_backoff(current, connected_ok, min_s, max_s=_RECONNECT_MAX_S):
         return min_s
     return min(current * 2, max_s)
 
-# Queue for callback dispatching
-_callback_queue = ucollections.deque((), 100)  # Empty tuple, maxlen=100
-
-def _run_callback(callback, *args):
-    if not callback:
-        logger.debug("_run_callback: skipping None callback")
-        return
-    """Add callback to queue for execution."""
-    try:
-        _callback_queue.append((callback, args))
-        #_log_debug(f"Queued callback {callback}, args={args}, queue size: {len(_callback_queue)}")
-        # print("Doing callback directly:")
-        # callback(*args)
-    except IndexError:
-        _log_error("ERROR: websocket.py callback queue full, dropping callback")
-
-async def _process_callbacks_async():
-    """Process queued callbacks asynchronously."""
-    while True: # this stops when "NWCWallet: manage_wallet_thread stopping, closing connections..."
-        # import _thread
-        # print(f"_process_callbacks_async thread {_thread.get_ident()}: _process_callbacks_async")
-        while _callback_queue:
-            _log_debug("Processing callbacks queue...")
-            try:
-                callback, args = _callback_queue.popleft()
-                if callback is not None:
-                    #_log_debug(f"Executing callback {callback} with {len(args)} args")
-                    #for i, arg in enumerate(args):
-                    #    _log_debug(f"Arg {i}: {arg}")
-                    try:
-                        callback(*args)
-                    except Exception as e:
-                        _log_error(f"Error in callback {callback}: {e}")
-                else:
-                    _log_debug("Skipping None callback")
-            except IndexError:
-                _log_debug("Callback queue empty")
-                break
-        await asyncio.sleep(0.1)  # Yield to other tasks
+# Per-connection callback queue bound. When the receive loop fills it, the
+# loop waits for the dispatcher to drain before reading the next frame, so a
+# burst of relay events throttles the socket instead of dropping callbacks.
+_CALLBACK_QUEUE_MAX = 32
+
+# Defaults for the shared connection pool. Each TLS handshake briefly needs
+# tens of kB of heap, so only a couple run at once; reconnects after a shared
+# outage (Wi-Fi drop) are spread out instead of all firing together; and a
+# single oversized relay message is skipped instead of exhausting the heap.
+_MAX_HANDSHAKES = 2
+_RECONNECT_STAGGER_MS = 500
+_MAX_MSG_SIZE = 128 * 1024
+_HANDSHAKE_TIMEOUT_S = 30
+
+
+class WebSocketPool:
+    """Scheduler shared by several WebSocketApps, e.g. the relays of one Nostr client.
+
+    Members share one ClientSession, one TLS context and the aiohttp DNS
+    cache, take turns for TLS handshakes and have their reconnects staggered.
+    The session is closed when the last running member stops, or by close().
+    """
+
+    def __init__(self, max_handshakes=_MAX_HANDSHAKES, stagger_ms=_RECONNECT_STAGGER_MS,
+                 max_msg_size=_MAX_MSG_SIZE):
+        self.max_handshakes = max_handshakes
+        self.stagger_ms = stagger_ms
+        self.max_msg_size = max_msg_size  # per-connection message budget in bytes, 0 = unlimited
+        self._session = None
+        self._ssl_context = None
+        self._handshakes = 0
+        self._handshake_done = asyncio.Event()
+        self._reconnect_slots = []  # ticks_ms of the pending scheduled reconnects
+        self._members = 0  # WebSocketApps currently running in this pool
+
+    def session(self):
+        if self._session is None:
+            self._session = aiohttp.ClientSession()
+        return self._session
+
+    def join(self):
+        self._members += 1
+
+    async def leave(self):
+        """Drop a running member; the last one to leave closes the shared session."""
+        self._members = max(0, self._members - 1)
+        if not self._members:
+            await self.close()
+
+    async def close(self):
+        """Close the shared ClientSession and drop the TLS context; session() opens a new one."""
+        session = self._session
+        self._session = None
+        self._ssl_context = None
+        if session is not None:
+            _log_debug("Closing pool ClientSession")
+            await session.__aexit__(None, None, None)
+
+    def ssl_context(self):
+        if self._ssl_context is None:
+            import ssl
+            self._ssl_context = ssl.SSLContext(ssl.PROTOCOL_TLS_CLIENT)
+            self._ssl_context.verify_mode = ssl.CERT_NONE
+        return self._ssl_context
+
+    async def acquire_handshake(self):
+        while self._handshakes >= self.max_handshakes:
+            self._handshake_done.clear()
+            await self._handshake_done.wait()
+        self._handshakes += 1
+
+    def release_handshake(self):
+        self._handshakes -= 1
+        self._handshake_done.set()
+
+    def reconnect_delay(self, delay_s):
+        """Return delay_s, pushed back only as far as needed to stay stagger_ms
+        away from the other pending pool reconnects."""
+        now = time.ticks_ms()
+        at = time.ticks_add(now, int(delay_s * 1000))
+        # Slots more than stagger_ms in the past can no longer collide
+        slots = [s for s in self._reconnect_slots if time.ticks_diff(s, now) > -self.stagger_ms]
+        moved = True
+        while moved:
+            moved = False
+            for slot in slots:
+                if abs(time.ticks_diff(at, slot)) < self.stagger_ms:
+                    at = time.ticks_add(slot, self.stagger_ms)
+                    moved = True
+        slots.append(at)
+        self._reconnect_slots = slots
+        return time.ticks_diff(at, now) / 1000
+
+
+_default_pool = None
+
+def default_pool():
+    """Pool used by every WebSocketApp that is not given one explicitly."""
+    global _default_pool
+    if _default_pool is None:
+        _default_pool = WebSocketPool()
+    return _default_pool
 
 class WebSocketApp:
     def __init__(
@@ -123,6 +189,8 @@ class WebSocketApp:
         subprotocols=None,
         on_data=None,
         socket=None,
+        pool=None,
+        max_msg_size=None,
     ):
         self.url = url
         self.header = header if header is not None else {}
@@ -139,8 +207,11 @@ class WebSocketApp:
         self.get_mask_key = get_mask_key
         self.subprotocols = subprotocols
         self.prepared_socket = socket  # Ignored, not supported
+        self.pool = pool if pool is not None else default_pool()
+        self.max_msg_size = max_msg_size if max_msg_size is not None else self.pool.max_msg_size
         self.ws = None
         self.session = None
+        self._own_session = False
         self.running = False
         self.ping_interval = 0
         self.ping_timeout = None
@@ -149,13 +220,16 @@ class WebSocketApp:
         self.last_pong_tm = 0
         self.has_errored = False
         self._loop = asyncio.get_event_loop()
+        self._callback_queue = ucollections.deque((), _CALLBACK_QUEUE_MAX)
+        self._callback_ready = asyncio.Event()  # set by producers, waited on by the dispatcher
+        self._callback_drained = asyncio.Event()  # set by the dispatcher once the queue is empty
 
     def send(self, data, opcode=ABNF.OPCODE_TEXT):
         """Send a message."""
         if not self.ws or not self.running:
             _log_error("Send failed: Connection closed or not running")
             raise WebSocketConnectionClosedException("Connection is already closed.")
-        _log_debug(f"Scheduling send: opcode={opcode}, data={str(data)[:100]}...")
+        _log_debug("Scheduling send: opcode=%s, data=%s...", opcode, logging.Lazy(logging.preview, data, 100))
         asyncio.create_task(self._send_async(data, opcode))
 
     def send_text(self, text_data):
@@ -181,11 +255,11 @@ class WebSocketApp:
                 await self.ws.close()
             else:
                 _log_debug("WebSocket already closed or not initialized")
-            if self.session:
+            if self.session and self._own_session:
                 _log_debug("Closing ClientSession")
                 await self.session.__aexit__(None, None, None)
             else:
-                _log_debug("No ClientSession to close")
+                _log_debug("No own ClientSession to close")
         except Exception as e:
             _log_error(f"Error closing WebSocket: {e}")
 
@@ -217,7 +291,7 @@ class WebSocketApp:
     def ready(self):
         """Check if connection is active."""
         status = self.ws is not None and self.running
-        _log_debug(f"Connection status: ready={status}")
+        _log_debug("Connection status: ready=%s", status)
         return status
 
     async def run_forever(
@@ -290,11 +364,11 @@ class WebSocketApp:
         else:
             reconnect_interval = 3
         _log_debug(f"Reconnect interval set to {reconnect_interval}s")
+        self.pool.join()
 
         # Start callback processing task
         try:
-            # Make sure the queue is empty
-            callback_task = asyncio.create_task(_process_callbacks_async())
+            callback_task = asyncio.create_task(self._process_callbacks_async())
             _log_debug("Started callback processing task")
         except Exception as e:
             logger.error("websocket create_task(_process_callbacks_async()) exception: %s", e)
@@ -322,17 +396,18 @@ class WebSocketApp:
             except Exception as e:
                 _log_error(f"_async_main's await self._connect_and_run() for {self.url} got exception: {e}")
                 self.has_errored = True
-                _run_callback(self.on_error, self, e)
+                self._run_callback(self.on_error, self, e)
             if not self.running:
                 break
             if reconnect_interval <= 0:
                 _log_debug("No reconnect configured, breaking loop")
                 break
             backoff = _next_backoff(backoff, connected_ok, reconnect_interval)
-            _log_debug(f"Reconnecting to {self.url} in {backoff}s")
-            await asyncio.sleep(backoff)
+            delay = self.pool.reconnect_delay(backoff)
+            _log_debug(f"Reconnecting to {self.url} in {delay}s")
+            await asyncio.sleep(delay)
             if self.on_reconnect:
-                _run_callback(self.on_reconnect, self)
+                self._run_callback(self.on_reconnect, self)
 
         # Cleanup
         _log_debug("Initiating cleanup")
@@ -347,69 +422,94 @@ class WebSocketApp:
         except asyncio.CancelledError:
             _log_debug("Callback task cancelled")
         await self._close_async()
+        await self.pool.leave()
         _log_debug("_async_main completed")
 
     async def _connect_and_run(self):
         """Connect and handle WebSocket messages."""
         _log_debug(f"Connecting to {self.url}")
+        pool = self.pool
         ssl_context = None
         if self.url.startswith("wss://"):
-            import ssl
-            ssl_context = ssl.SSLContext(ssl.PROTOCOL_TLS_CLIENT)
-            ssl_context.verify_mode = ssl.CERT_NONE
+            ssl_context = pool.ssl_context()
             _log_debug("Using SSL with no certificate verification")
 
-        self.session = aiohttp.ClientSession(headers=self.header)
-        async with self.session.ws_connect(self.url, ssl=ssl_context) as ws:
+        # Custom headers need a session of their own; otherwise share the pool's.
+        self._own_session = bool(self.header)
+        if self._own_session:
+            self.session = aiohttp.ClientSession(headers=self.header)
+        else:
+            self.session = pool.session()
+
+        # Hold one of the pool's handshake slots only while connecting, and give
+        # up on a stalled handshake so it cannot block the other relays.
+        connection = self.session.ws_connect(self.url, ssl=ssl_context, max_msg_size=self.max_msg_size)
+        await pool.acquire_handshake()
+        try:
+            ws = await asyncio.wait_for(connection.__aenter__(), _HANDSHAKE_TIMEOUT_S)
+        except (asyncio.TimeoutError, asyncio.CancelledError):
+            # The socket may already be open; don't leak it with the handshake
+            await connection.__aexit__(None, None, None)
+            raise
+        finally:
+            pool.release_handshake()
+        try:
             if not ws:
                 logger.error("ERROR: ws_connect got None instead of ws object!")
-                _run_callback(self.on_error, self, str(e))
+                self._run_callback(self.on_error, self, "ws_connect returned None")
                 return
 
             self.ws = ws
             _log_debug("WebSocket connected, running on_open callback")
-            _run_callback(self.on_open, self)
+            self._run_callback(self.on_open, self)
             #self._start_ping_task() this ping task isn't part of the protocol, pings are sent by the server
+            await self._receive_loop(ws)
+        finally:
+            await connection.__aexit__(None, None, None)
+
+    async def _receive_loop(self, ws):
+        """Dispatch received messages until the connection closes."""
+        async for msg in ws:
+            _log_debug("websocket thread stack used: %s", logging.Lazy(micropython.stack_use))
+            _log_debug("websocket.py _connect_and_run received msg: type=%s, length: %s and data=%s...",
+                       msg.type, logging.Lazy(len, msg.data), logging.Lazy(logging.preview, msg.data, 180))
+            if not self.running:
+                _log_debug("Not running, breaking message loop")
+                break
 
-            async for msg in ws:
-                import micropython
-                logger.debug("websocket thread stack used: %s", micropython.stack_use())
-                _log_debug(f"websocket.py _connect_and_run received msg: type={msg.type}, length: {len(msg.data)} and data={str(msg.data)[:180]}...")
-                if not self.running:
-                    _log_debug("Not running, breaking message loop")
-                    break
-
-                # Handle ping/pong timeout
-                if self.ping_timeout and self.last_ping_tm:
-                    if time.time() - self.last_ping_tm > self.ping_timeout:
-                        _log_error("Ping/pong timed out")
-                        raise WebSocketTimeoutException("ping/pong timed out")
-
-                # Process message
-                if msg.type == WSMsgType.TEXT:
-                    data = msg.data
-                    _run_callback(self.on_data, self, data, ABNF.OPCODE_TEXT, True)
-                    _run_callback(self.on_message, self, data)  # Standard websocket-client
-                elif msg.type == WSMsgType.BINARY:
-                    data = msg.data
-                    _run_callback(self.on_data, self, data, ABNF.OPCODE_BINARY, True)
-                    _run_callback(self.on_message, self, data)  # Standard websocket-client
-                elif msg.type == WSMsgType.ERROR or ws.ws.closed:
-                    _log_error("WebSocket error or closed")
-                    raise WebSocketConnectionClosedException("WebSocket closed")
-                elif msg.type == ABNF.OPCODE_PONG:
-                    self.last_pong_tm = time.time()
-                elif msg.type == ABNF.OPCODE_PING:
-                    data = msg.data
-                    _run_callback(self.on_ping, self, data)
-                    try:
-                        await self.ws.pong(data)
-                    except Exception as e:
-                        _log_error(f"Failed to send pong: {e}")
+            # Handle ping/pong timeout
+            if self.ping_timeout and self.last_ping_tm:
+                if time.time() - self.last_ping_tm > self.ping_timeout:
+                    _log_error("Ping/pong timed out")
+                    raise WebSocketTimeoutException("ping/pong timed out")
+
+            # Process message
+            if msg.type == WSMsgType.TEXT:
+                data = msg.data
+                self._run_callback(self.on_data, self, data, ABNF.OPCODE_TEXT, True)
+                self._run_callback(self.on_message, self, data)  # Standard websocket-client
+                await self._wait_callbacks_drained()
+            elif msg.type == WSMsgType.BINARY:
+                data = msg.data
+                self._run_callback(self.on_data, self, data, ABNF.OPCODE_BINARY, True)
+                self._run_callback(self.on_message, self, data)  # Standard websocket-client
+                await self._wait_callbacks_drained()
+            elif msg.type == WSMsgType.ERROR or ws.ws.closed:
+                _log_error("WebSocket error or closed")
+                raise WebSocketConnectionClosedException("WebSocket closed")
+            elif msg.type == ABNF.OPCODE_PONG:
+                self.last_pong_tm = time.time()
+            elif msg.type == ABNF.OPCODE_PING:
+                data = msg.data
+                self._run_callback(self.on_ping, self, data)
+                try:
+                    await self.ws.pong(data)
+                except Exception as e:
+                    _log_error(f"Failed to send pong: {e}")
 
     async def _send_async(self, data, opcode):
         """Async send implementation."""
-        _log_debug(f"Sending: opcode={opcode}, data={str(data)[:700]}")
+        _log_debug("Sending: opcode=%s, data=%s", opcode, logging.Lazy(logging.preview, data, 700))
         try:
             if opcode == ABNF.OPCODE_TEXT:
                 await self.ws.send_str(data)
@@ -420,11 +520,42 @@ class WebSocketApp:
             _log_debug("Send successful")
         except Exception as e:
             _log_error(f"Send failed: {e}")
-            _run_callback(self.on_error, self, e)
+            self._run_callback(self.on_error, self, e)
+
+    def _run_callback(self, callback, *args):
+        """Queue callback for the dispatcher task and wake it up."""
+        if not callback:
+            return
+        if len(self._callback_queue) >= _CALLBACK_QUEUE_MAX:
+            _log_error(f"ERROR: callback queue for {self.url} full, dropping callback")
+            return
+        self._callback_queue.append((callback, args))
+        self._callback_drained.clear()
+        self._callback_ready.set()
+
+    async def _wait_callbacks_drained(self):
+        """Backpressure for the receive loop: stall while the queue is full."""
+        # Leave room for the two callbacks queued per received frame.
+        if len(self._callback_queue) >= _CALLBACK_QUEUE_MAX - 2:
+            await self._callback_drained.wait()
+
+    async def _process_callbacks_async(self):
+        """Run queued callbacks, sleeping on an event while there are none."""
+        queue = self._callback_queue
+        while True:
+            await self._callback_ready.wait()
+            self._callback_ready.clear()
+            while queue:
+                callback, args = queue.popleft()
+                try:
+                    callback(*args)
+                except Exception as e:
+                    _log_error(f"Error in callback {callback}: {e}")
+            self._callback_drained.set()
 
     def _callback(self, callback, *args):
         """Compatibility wrapper for callback execution."""
-        _run_callback(callback, self, *args)
+        self._run_callback(callback, self, *args)
 
     def _get_close_args(self, close_frame):
         """Extract close code and reason (simplified)."""
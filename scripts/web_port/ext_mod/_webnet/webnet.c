@@ -7,8 +7,11 @@
 // Design: fetch_start() kicks off a fetch() and returns immediately with an
 // integer handle; the request runs on the browser event loop. Python then
 // polls poll(handle) (yielding to the asyncio loop via asyncio.sleep between
-// polls) so the LVGL/UI task handler keeps running during downloads. When the
-// body has fully arrived, status()/headers()/body() return the result.
+// polls) so the LVGL/UI task handler keeps running during downloads. Once the
+// response headers have arrived, status()/headers() return them and the body
+// is streamed with body_readinto(), which copies whatever the ReadableStream
+// has delivered straight into a caller-provided buffer. JS only reads ahead up
+// to WEBNET_READ_AHEAD bytes, so a large download never sits in memory whole.
 //
 // This file is only compiled for the Emscripten/web target (guarded by
 // __EMSCRIPTEN__ and gated to MPOS_WEB=1 in micropython.mk); on every other
@@ -18,23 +21,51 @@
 
 #include "py/runtime.h"
 #include "py/obj.h"
+#include "py/objtuple.h"
 #include "py/mperrno.h"
 
 #if defined(__EMSCRIPTEN__)
 
 #include <emscripten.h>
 
+#define WEBNET_READ_AHEAD (64 * 1024)
+#define WEBNET_WS_BATCH (16)  // max messages drained per ws_read_batch() call
+
 // ---------------------------------------------------------------------------
-// JS side: a per-handle record { state, status, headers, body, err } kept on
-// Module.__webnet.map. state: 0 = pending, 1 = done, -1 = error.
+// JS side: a per-handle record { state, status, headers, reader, chunks, off,
+// queued, done, pumping, err } kept on Module.__webnet.map. state: 0 =
+// pending, 1 = headers received (body streaming), -1 = error. chunks holds
+// Uint8Arrays read from the body stream but not yet consumed; off is the read
+// position in chunks[0] and queued the total unread bytes.
 // ---------------------------------------------------------------------------
 
 EM_JS(int, webnet_js_start,
       (const char *method, const char *url, const char *headers_json,
-       const char *body, int body_len), {
+       const char *body, int body_len, int read_ahead), {
     var H = Module.__webnet || (Module.__webnet = { next: 1, map: {} });
+    if (!H.pump) {
+        // Keep one body read in flight until read_ahead bytes are queued.
+        H.pump = function (rec) {
+            if (rec.pumping || rec.done || !rec.reader || rec.queued >= rec.readAhead) return;
+            rec.pumping = true;
+            rec.reader.read().then(function (r) {
+                rec.pumping = false;
+                if (r.done) { rec.done = true; return; }
+                if (r.value && r.value.length) {
+                    rec.chunks.push(r.value);
+                    rec.queued += r.value.length;
+                }
+                H.pump(rec);
+            }).catch(function (e) {
+                rec.pumping = false;
+                rec.err = "" + e;
+                rec.state = -1;
+            });
+        };
+    }
     var handle = H.next++;
-    var rec = { state: 0, status: 0, headers: "{}", body: null, err: "" };
+    var rec = { state: 0, status: 0, headers: "{}", reader: null, chunks: [], off: 0,
+                queued: 0, done: false, pumping: false, readAhead: read_ahead, err: "" };
     H.map[handle] = rec;
     try {
         var m = UTF8ToString(method);
@@ -52,10 +83,24 @@ EM_JS(int, webnet_js_start,
             var ho = {};
             resp.headers.forEach(function (v, k) { ho[k] = v; });
             rec.headers = JSON.stringify(ho);
-            return resp.arrayBuffer();
-        }).then(function (ab) {
-            rec.body = new Uint8Array(ab);
-            rec.state = 1;
+            if (resp.body && resp.body.getReader) {
+                rec.reader = resp.body.getReader();
+                rec.state = 1;
+                H.pump(rec);
+                return;
+            }
+            if (!resp.body) {
+                rec.done = true;
+                rec.state = 1;
+                return;
+            }
+            // No ReadableStream support: fall back to one buffered chunk.
+            return resp.arrayBuffer().then(function (ab) {
+                rec.chunks.push(new Uint8Array(ab));
+                rec.queued = ab.byteLength;
+                rec.done = true;
+                rec.state = 1;
+            });
         }).catch(function (e) {
             rec.err = "" + e;
             rec.state = -1;
@@ -103,28 +148,39 @@ EM_JS(void, webnet_js_error_copy, (int handle, char *buf, int len), {
     stringToUTF8(rec.err, buf, len + 1);
 });
 
-EM_JS(int, webnet_js_body_len, (int handle), {
-    var H = Module.__webnet; if (!H) return 0;
-    var rec = H.map[handle]; if (!rec || !rec.body) return 0;
-    return rec.body.length;
-});
-
-EM_JS(void, webnet_js_body_copy, (int handle, char *buf, int len), {
-    var H = Module.__webnet; if (!H) return;
-    var rec = H.map[handle]; if (!rec || !rec.body) return;
-    HEAPU8.set(rec.body.subarray(0, len), buf);
+// Copies up to len queued body bytes into buf. Returns the byte count, 0 if
+// nothing has arrived yet, -1 at end of body, -2 on error.
+EM_JS(int, webnet_js_body_readinto, (int handle, char *buf, int len), {
+    var H = Module.__webnet; if (!H) return -2;
+    var rec = H.map[handle]; if (!rec || rec.state === -1) return -2;
+    var n = 0;
+    while (n < len && rec.chunks.length) {
+        var c = rec.chunks[0];
+        var take = Math.min(len - n, c.length - rec.off);
+        HEAPU8.set(c.subarray(rec.off, rec.off + take), buf + n);
+        n += take;
+        rec.off += take;
+        if (rec.off >= c.length) { rec.chunks.shift(); rec.off = 0; }
+    }
+    rec.queued -= n;
+    H.pump(rec);
+    if (n > 0) return n;
+    return rec.done ? -1 : 0;
 });
 
 EM_JS(void, webnet_js_free, (int handle), {
     var H = Module.__webnet; if (!H) return;
+    var rec = H.map[handle];
+    if (rec && rec.reader && !rec.done) { try { rec.reader.cancel(); } catch (e) {} }
     delete H.map[handle];
 });
 
 // ---------------------------------------------------------------------------
 // JS side: WebSocket bridge. Shares Module.__webnet.map / next with fetch, but
 // uses a different record shape { ws, queue, err, enc }. Incoming messages are
-// queued (text encoded to UTF-8 bytes, binary as Uint8Array) and drained by
-// Python via ws_peek_type/ws_peek_len/ws_read. State mirrors WebSocket
+// queued (text encoded to UTF-8 bytes, binary as Uint8Array) and copied
+// straight into caller-provided buffers by ws_readinto (one message) or
+// ws_read_batch (as many as fit, in one call). State mirrors WebSocket
 // .readyState (0 CONNECTING, 1 OPEN, 2 CLOSING, 3 CLOSED).
 //
 // Note: the browser WebSocket API cannot set custom request headers and is not
@@ -170,23 +226,44 @@ EM_JS(int, webnet_js_ws_state, (int handle), {
     return rec.ws.readyState;
 });
 
-EM_JS(int, webnet_js_ws_peek_type, (int handle), {
+// Copies the front message into buf and pops it. Writes its type (0 none, 1
+// text, 2 binary) to *type_out and returns its length; a message longer than
+// len stays queued and -(its length) is returned so the caller can grow buf.
+EM_JS(int, webnet_js_ws_readinto, (int handle, char *buf, int len, int *type_out), {
+    HEAP32[type_out >> 2] = 0;
     var H = Module.__webnet; if (!H) return 0;
     var rec = H.map[handle]; if (!rec || !rec.queue.length) return 0;
-    return rec.queue[0].type;
+    var msg = rec.queue[0];
+    HEAP32[type_out >> 2] = msg.type;
+    if (msg.data.length > len) return -msg.data.length;
+    HEAPU8.set(msg.data, buf);
+    rec.queue.shift();
+    return msg.data.length;
 });
 
-EM_JS(int, webnet_js_ws_peek_len, (int handle), {
+// Drains up to max queued messages back to back into buf, stopping at the
+// first one that does not fit, and stores a (type, length) pair per message in
+// meta. Returns the message count, or -(length) if not even the front message
+// fits (meta[0] then holds its type and it stays queued).
+EM_JS(int, webnet_js_ws_read_batch, (int handle, char *buf, int len, int *meta, int max), {
     var H = Module.__webnet; if (!H) return 0;
-    var rec = H.map[handle]; if (!rec || !rec.queue.length) return 0;
-    return rec.queue[0].data.length;
-});
-
-EM_JS(void, webnet_js_ws_read_copy, (int handle, char *buf, int len), {
-    var H = Module.__webnet; if (!H) return;
-    var rec = H.map[handle]; if (!rec || !rec.queue.length) return;
-    var msg = rec.queue.shift();
-    if (len > 0) { HEAPU8.set(msg.data.subarray(0, len), buf); }
+    var rec = H.map[handle]; if (!rec) return 0;
+    var q = rec.queue, m = meta >> 2, count = 0, off = 0;
+    while (count < max && q.length) {
+        var msg = q[0], n = msg.data.length;
+        if (off + n > len) {
+            if (count) break;
+            HEAP32[m] = msg.type;
+            return -n;
+        }
+        HEAPU8.set(msg.data, buf + off);
+        HEAP32[m + 2 * count] = msg.type;
+        HEAP32[m + 2 * count + 1] = n;
+        off += n;
+        count++;
+        q.shift();
+    }
+    return count;
 });
 
 EM_JS(int, webnet_js_ws_send_text, (int handle, const char *str), {
@@ -245,11 +322,11 @@ static mp_obj_t webnet_fetch_start(size_t n_args, const mp_obj_t *args) {
         body = (const char *)bufinfo.buf;
         body_len = (int)bufinfo.len;
     }
-    return mp_obj_new_int(webnet_js_start(method, url, headers, body, body_len));
+    return mp_obj_new_int(webnet_js_start(method, url, headers, body, body_len, WEBNET_READ_AHEAD));
 }
 static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(webnet_fetch_start_obj, 3, 4, webnet_fetch_start);
 
-// poll(handle:int) -> int  (0 pending, 1 done, -1 error)
+// poll(handle:int) -> int  (0 pending, 1 headers received, -1 error)
 static mp_obj_t webnet_poll(mp_obj_t handle_in) {
     return mp_obj_new_int(webnet_js_poll(mp_obj_get_int(handle_in)));
 }
@@ -299,23 +376,15 @@ static mp_obj_t webnet_error(mp_obj_t handle_in) {
 }
 static MP_DEFINE_CONST_FUN_OBJ_1(webnet_error_obj, webnet_error);
 
-// body(handle:int) -> bytes  (full response body)
-static mp_obj_t webnet_body(mp_obj_t handle_in) {
-    int handle = mp_obj_get_int(handle_in);
-    int len = webnet_js_body_len(handle);
-    if (len <= 0) {
-        return mp_obj_new_bytes((const byte *)"", 0);
-    }
-    char *buf = malloc((size_t)len);
-    if (buf == NULL) {
-        mp_raise_OSError(MP_ENOMEM);
-    }
-    webnet_js_body_copy(handle, buf, len);
-    mp_obj_t result = mp_obj_new_bytes((const byte *)buf, len);
-    free(buf);
-    return result;
+// body_readinto(handle:int, buf:bytearray) -> int
+// (bytes written, 0 nothing yet, -1 end of body, -2 error)
+static mp_obj_t webnet_body_readinto(mp_obj_t handle_in, mp_obj_t buf_in) {
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(buf_in, &bufinfo, MP_BUFFER_WRITE);
+    return mp_obj_new_int(
+        webnet_js_body_readinto(mp_obj_get_int(handle_in), (char *)bufinfo.buf, (int)bufinfo.len));
 }
-static MP_DEFINE_CONST_FUN_OBJ_1(webnet_body_obj, webnet_body);
+static MP_DEFINE_CONST_FUN_OBJ_2(webnet_body_readinto_obj, webnet_body_readinto);
 
 // free(handle:int) -> None
 static mp_obj_t webnet_free(mp_obj_t handle_in) {
@@ -340,35 +409,40 @@ static mp_obj_t webnet_ws_state(mp_obj_t handle_in) {
 }
 static MP_DEFINE_CONST_FUN_OBJ_1(webnet_ws_state_obj, webnet_ws_state);
 
-// ws_peek_type(handle:int) -> int  (0 none, 1 text, 2 binary)
-static mp_obj_t webnet_ws_peek_type(mp_obj_t handle_in) {
-    return mp_obj_new_int(webnet_js_ws_peek_type(mp_obj_get_int(handle_in)));
-}
-static MP_DEFINE_CONST_FUN_OBJ_1(webnet_ws_peek_type_obj, webnet_ws_peek_type);
-
-// ws_peek_len(handle:int) -> int  (byte length of the queued front message)
-static mp_obj_t webnet_ws_peek_len(mp_obj_t handle_in) {
-    return mp_obj_new_int(webnet_js_ws_peek_len(mp_obj_get_int(handle_in)));
+// ws_readinto(handle:int, buf:bytearray) -> (type, n)
+// (type 0 = nothing queued, 1 text, 2 binary; n < 0 means the message needs
+// -n bytes and stays queued)
+static mp_obj_t webnet_ws_readinto(mp_obj_t handle_in, mp_obj_t buf_in) {
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(buf_in, &bufinfo, MP_BUFFER_WRITE);
+    int type = 0;
+    int n = webnet_js_ws_readinto(mp_obj_get_int(handle_in),
+        (char *)bufinfo.buf, (int)bufinfo.len, &type);
+    mp_obj_t items[2] = { MP_OBJ_NEW_SMALL_INT(type), mp_obj_new_int(n) };
+    return mp_obj_new_tuple(2, items);
 }
-static MP_DEFINE_CONST_FUN_OBJ_1(webnet_ws_peek_len_obj, webnet_ws_peek_len);
+static MP_DEFINE_CONST_FUN_OBJ_2(webnet_ws_readinto_obj, webnet_ws_readinto);
 
-// ws_read(handle:int) -> bytes  (pops and returns the front message payload)
-static mp_obj_t webnet_ws_read(mp_obj_t handle_in) {
-    int handle = mp_obj_get_int(handle_in);
-    int len = webnet_js_ws_peek_len(handle);
-    if (len < 0) {
-        len = 0;
+// ws_read_batch(handle:int, buf:bytearray) -> (type0, len0, type1, len1, ...)
+// (messages are packed back to back in buf; () if nothing is queued; a single
+// (type, -n) pair if the front message needs -n bytes and stays queued)
+static mp_obj_t webnet_ws_read_batch(mp_obj_t handle_in, mp_obj_t buf_in) {
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(buf_in, &bufinfo, MP_BUFFER_WRITE);
+    int meta[2 * WEBNET_WS_BATCH];
+    int count = webnet_js_ws_read_batch(mp_obj_get_int(handle_in),
+        (char *)bufinfo.buf, (int)bufinfo.len, meta, WEBNET_WS_BATCH);
+    if (count < 0) {
+        mp_obj_t items[2] = { MP_OBJ_NEW_SMALL_INT(meta[0]), mp_obj_new_int(count) };
+        return mp_obj_new_tuple(2, items);
     }
-    char *buf = malloc((size_t)len + 1);  // +1 avoids malloc(0)
-    if (buf == NULL) {
-        mp_raise_OSError(MP_ENOMEM);
+    mp_obj_tuple_t *result = MP_OBJ_TO_PTR(mp_obj_new_tuple(2 * count, NULL));
+    for (int i = 0; i < 2 * count; i++) {
+        result->items[i] = mp_obj_new_int(meta[i]);
     }
-    webnet_js_ws_read_copy(handle, buf, len);  // pops the front message
-    mp_obj_t result = mp_obj_new_bytes((const byte *)buf, len);
-    free(buf);
-    return result;
+    return MP_OBJ_FROM_PTR(result);
 }
-static MP_DEFINE_CONST_FUN_OBJ_1(webnet_ws_read_obj, webnet_ws_read);
+static MP_DEFINE_CONST_FUN_OBJ_2(webnet_ws_read_batch_obj, webnet_ws_read_batch);
 
 // ws_send_text(handle:int, data:str) -> int  (0 ok, -1 error)
 static mp_obj_t webnet_ws_send_text(mp_obj_t handle_in, mp_obj_t data_in) {
@@ -427,13 +501,12 @@ static const mp_rom_map_elem_t webnet_module_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR_status), MP_ROM_PTR(&webnet_status_obj) },
     { MP_ROM_QSTR(MP_QSTR_headers), MP_ROM_PTR(&webnet_headers_obj) },
     { MP_ROM_QSTR(MP_QSTR_error), MP_ROM_PTR(&webnet_error_obj) },
-    { MP_ROM_QSTR(MP_QSTR_body), MP_ROM_PTR(&webnet_body_obj) },
+    { MP_ROM_QSTR(MP_QSTR_body_readinto), MP_ROM_PTR(&webnet_body_readinto_obj) },
     { MP_ROM_QSTR(MP_QSTR_free), MP_ROM_PTR(&webnet_free_obj) },
     { MP_ROM_QSTR(MP_QSTR_ws_open), MP_ROM_PTR(&webnet_ws_open_obj) },
     { MP_ROM_QSTR(MP_QSTR_ws_state), MP_ROM_PTR(&webnet_ws_state_obj) },
-    { MP_ROM_QSTR(MP_QSTR_ws_peek_type), MP_ROM_PTR(&webnet_ws_peek_type_obj) },
-    { MP_ROM_QSTR(MP_QSTR_ws_peek_len), MP_ROM_PTR(&webnet_ws_peek_len_obj) },
-    { MP_ROM_QSTR(MP_QSTR_ws_read), MP_ROM_PTR(&webnet_ws_read_obj) },
+    { MP_ROM_QSTR(MP_QSTR_ws_readinto), MP_ROM_PTR(&webnet_ws_readinto_obj) },
+    { MP_ROM_QSTR(MP_QSTR_ws_read_batch), MP_ROM_PTR(&webnet_ws_read_batch_obj) },
     { MP_ROM_QSTR(MP_QSTR_ws_send_text), MP_ROM_PTR(&webnet_ws_send_text_obj) },
     { MP_ROM_QSTR(MP_QSTR_ws_send_bytes), MP_ROM_PTR(&webnet_ws_send_bytes_obj) },
     { MP_ROM_QSTR(MP_QSTR_ws_close), MP_ROM_PTR(&webnet_ws_close_obj) },
@@ -29,49 +29,92 @@ __all__ = (
 )
 
 _POLL_MS = 20
+_READ_CHUNK = 4096
+_BODY_TIMEOUT_MS = 60000  # body stall limit for requests made without a timeout
 
 
 class _Content:
-    # Minimal StreamReader-like object serving an in-memory body in chunks.
-    def __init__(self, body):
-        self._body = body
-        self._pos = 0
+    # StreamReader-like view of a streamed fetch() body. Data is copied from
+    # the browser's ReadableStream straight into a reusable buffer, so only
+    # one chunk of the body lives in the MicroPython heap at a time.
+    # A read fails once no data has arrived for timeout_ms.
+    def __init__(self, handle, timeout_ms=_BODY_TIMEOUT_MS):
+        self._handle = handle
+        self._timeout_ms = timeout_ms
+        self._buf = None
+        self._pending = b""  # read past a readline() boundary, not yet returned
+        self._eof = False
+
+    async def readinto(self, buf):
+        # Returns the number of bytes written into buf, 0 at end of body.
+        if self._pending:
+            n = min(len(buf), len(self._pending))
+            buf[:n] = self._pending[:n]
+            self._pending = self._pending[n:]
+            return n
+        if self._eof or self._handle is None:
+            return 0
+        deadline = time.ticks_add(time.ticks_ms(), self._timeout_ms)
+        while True:
+            n = _webnet.body_readinto(self._handle, buf)
+            if n > 0:
+                return n
+            if n == -1:
+                self._eof = True
+                return 0
+            if n < -1:
+                raise OSError("fetch body failed: " + _webnet.error(self._handle))
+            if time.ticks_diff(time.ticks_ms(), deadline) > 0:
+                raise OSError("fetch body timeout")
+            await asyncio.sleep_ms(_POLL_MS)
 
     async def read(self, n=-1):
-        if self._pos >= len(self._body):
-            return b""
         if n is None or n < 0:
-            chunk = self._body[self._pos:]
-            self._pos = len(self._body)
-        else:
-            chunk = self._body[self._pos:self._pos + n]
-            self._pos += len(chunk)
-        return chunk
+            parts = []
+            while True:
+                chunk = await self.read(_READ_CHUNK)
+                if not chunk:
+                    return b"".join(parts)
+                parts.append(chunk)
+        if self._buf is None or len(self._buf) < n:
+            self._buf = bytearray(max(n, _READ_CHUNK))
+        mv = memoryview(self._buf)[:n]
+        got = await self.readinto(mv)
+        return bytes(mv[:got])
 
     async def readexactly(self, n):
-        return await self.read(n)
+        parts = []
+        while n > 0:
+            chunk = await self.read(n)
+            if not chunk:
+                break
+            parts.append(chunk)
+            n -= len(chunk)
+        return b"".join(parts)
 
     async def readline(self):
-        if self._pos >= len(self._body):
-            return b""
-        nl = self._body.find(b"\n", self._pos)
-        if nl < 0:
-            chunk = self._body[self._pos:]
-            self._pos = len(self._body)
-        else:
-            chunk = self._body[self._pos:nl + 1]
-            self._pos = nl + 1
-        return chunk
+        line = b""
+        while True:
+            nl = self._pending.find(b"\n")
+            if nl >= 0:
+                line += self._pending[:nl + 1]
+                self._pending = self._pending[nl + 1:]
+                return line
+            line += self._pending
+            self._pending = b""
+            chunk = await self.read(_READ_CHUNK)
+            if not chunk:
+                return line
+            self._pending = chunk
 
 
 class ClientResponse:
-    def __init__(self, handle, status, headers, body):
+    def __init__(self, handle, status, headers, timeout_ms=_BODY_TIMEOUT_MS):
         self._handle = handle
         self.status = status
         self.headers = headers
         self.url = None
-        self._body = body
-        self.content = _Content(body)
+        self.content = _Content(handle, timeout_ms)
 
     def _get_header(self, name, default=None):
         for k in self.headers:
@@ -80,18 +123,22 @@ class ClientResponse:
         return default
 
     async def read(self, sz=-1):
-        return self._body
+        # Like the device aiohttp: the whole body, or sz bytes unless it ends first
+        if sz is None or sz < 0:
+            return await self.content.read()
+        return await self.content.readexactly(sz)
 
     async def text(self, encoding="utf-8"):
-        return self._body.decode(encoding)
+        return (await self.read()).decode(encoding)
 
     async def json(self):
-        return _json.loads(self._body)
+        return _json.loads(await self.read())
 
     def release(self):
         if self._handle is not None:
             _webnet.free(self._handle)
             self._handle = None
+            self.content._handle = None
 
     def __repr__(self):
         return "<ClientResponse %s %s>" % (self.status, self.headers)
@@ -120,6 +167,7 @@ class _RequestContextManager:
 _WS_TEXT = 1
 _WS_BINARY = 2
 _WS_CLOSE = 8
+_WS_BUF = 4096
 
 
 class _WSMessage:
@@ -139,22 +187,37 @@ class WebSocketClient:
     def __init__(self, handle):
         self._handle = handle
         self.closed = False
+        self._buf = bytearray(_WS_BUF)
+        self._pending = []  # (type, data) drained by the last batch read
 
     async def receive(self):
         # Drain any queued message first, then report closure. Non-blocking:
         # yields to the asyncio loop so the UI keeps running.
         while True:
-            t = _webnet.ws_peek_type(self._handle)
-            if t:
-                data = _webnet.ws_read(self._handle)
-                if t == _WS_TEXT:
-                    data = str(data, "utf-8")
-                return t, data
+            if self._pending or self._read_batch():
+                return self._pending.pop(0)
             if _webnet.ws_state(self._handle) == 3:  # CLOSED
                 self.closed = True
                 return self.CLOSE, b""
             await asyncio.sleep_ms(_POLL_MS)
 
+    def _read_batch(self):
+        # One bridge call copies every queued message that fits into the
+        # reusable buffer; a message larger than it gets a one-off buffer.
+        buf = self._buf
+        meta = _webnet.ws_read_batch(self._handle, buf)
+        if len(meta) == 2 and meta[1] < 0:
+            buf = bytearray(-meta[1])
+            meta = _webnet.ws_read_batch(self._handle, buf)
+        mv = memoryview(buf)
+        off = 0
+        for i in range(0, len(meta), 2):
+            t, n = meta[i], meta[i + 1]
+            data = mv[off:off + n]
+            off += n
+            self._pending.append((t, str(data, "utf-8") if t == _WS_TEXT else bytes(data)))
+        return len(meta) > 0
+
     async def send(self, data, opcode=None):
         if isinstance(data, str):
             _webnet.ws_send_text(self._handle, data)
@@ -285,7 +348,8 @@ class ClientSession:
         if timeout:
             deadline = time.ticks_add(time.ticks_ms(), int(timeout * 1000))
 
-        # Non-blocking poll: yield to the asyncio loop so the UI stays live.
+        # Non-blocking poll until the response headers arrive: yield to the
+        # asyncio loop so the UI stays live. The body is streamed afterwards.
         while True:
             state = _webnet.poll(handle)
             if state == 1:
@@ -304,8 +368,9 @@ class ClientSession:
             hdrs = _json.loads(_webnet.headers(handle))
         except Exception:
             hdrs = {}
-        body_bytes = _webnet.body(handle)
-        resp = ClientResponse(handle, status, hdrs, body_bytes)
+        # The request timeout also bounds each stall while the body streams in
+        resp = ClientResponse(handle, status, hdrs,
+                              int(timeout * 1000) if timeout else _BODY_TIMEOUT_MS)
         resp.url = full
         return resp
 
@@ -0,0 +1,206 @@
+"""
+Tests for the streaming, conditional app index refresh in appstore_core.
+
+1. IndexScanner: entries come out whole however the index is chunked
+2. AppUpdateManager._scan_index(): ETag/Last-Modified revalidation against
+   the local copy, served by a fake server that honours If-None-Match
+"""
+
+import json
+import os
+import sys
+import unittest
+
+sys.path.insert(0, "builtin/apps/com.micropythonos.appstore")
+
+
+def _generate_index(count):
+    return [
+        {
+            "fullname": "com.example.app%d" % i,
+            "name": 'App "%d" \\ {x}' % i,
+            "version": "1.%d" % i,
+            "activities": [{"entrypoint": "main.py", "intent_filters": []}],
+            "download_url": "http://x/%d.mpk" % i,
+        }
+        for i in range(count)
+    ]
+
+
+def _scan(data, chunk_size):
+    from appstore_core import IndexScanner
+    items = []
+    scanner = IndexScanner(lambda raw: items.append(json.loads(raw)))
+    for i in range(0, len(data), chunk_size):
+        scanner.feed(data[i:i + chunk_size])
+    scanner.finish()
+    return items
+
+
+class TestIndexScanner(unittest.TestCase):
+
+    def test_entries_survive_any_chunking(self):
+        index = _generate_index(40)
+        data = json.dumps(index).encode()
+        for chunk_size in (1, 2, 7, 64, 1000, len(data)):
+            self.assertEqual(_scan(data, chunk_size), index)
+
+    def test_escaped_quotes_and_whitespace(self):
+        data = b' [ {"a": "x\\\\"} ,\n {"b": "}\\"{"}, {"c": [1, {"d": "]"}]} ]  '
+        self.assertEqual(_scan(data, 3), [{"a": "x\\"}, {"b": '}"{'}, {"c": [1, {"d": "]"}]}])
+
+    def test_only_one_entry_is_buffered(self):
+        from appstore_core import IndexScanner
+        data = json.dumps(_generate_index(200)).encode()
+        entry_len = len(json.dumps(_generate_index(1)[0])) + 10
+        scanner = IndexScanner(lambda raw: None)
+        largest = 0
+        for i in range(0, len(data), 512):
+            scanner.feed(data[i:i + 512])
+            largest = max(largest, len(scanner._carry))
+        scanner.finish()
+        self.assertEqual(scanner.count, 200)
+        self.assertTrue(largest <= entry_len)
+
+    def test_empty_index(self):
+        self.assertEqual(_scan(b"[]", 1), [])
+
+    def test_malformed(self):
+        for data in (b"not json {{{", b'{"a": 1}', b'[{"a": 1}, "x"]', b'[{"a": 1}', b"[[1]]"):
+            with self.assertRaises(ValueError):
+                _scan(data, 4)
+
+
+class _FakeServer:
+    """Serves one index body with an ETag, answering 304 when it matches."""
+
+    def __init__(self, body, etag):
+        self.body = body
+        self.etag = etag
+        self.requests = []
+
+    async def download_url(self, url, chunk_callback=None, headers=None, response_info=None, **kwargs):
+        self.requests.append(dict(headers or {}))
+        if headers and headers.get("If-None-Match") == self.etag:
+            response_info["status"] = 304
+            response_info["headers"] = {"ETag": self.etag}
+            return True
+        response_info["status"] = 200
+        response_info["headers"] = {"ETag": self.etag, "Last-Modified": "Sat, 17 Oct 2026 10:00:00 GMT"}
+        for i in range(0, len(self.body), 1024):
+            await chunk_callback(self.body[i:i + 1024])
+        return True
+
+
+class _MemPrefs:
+    store = {}
+
+    def __init__(self, app_id, filename="config.json"):
+        self._data = _MemPrefs.store.setdefault(filename, {})
+
+    def get_string(self, key, default=None):
+        return self._data.get(key, default)
+
+    def edit(self):
+        return self
+
+    def put_string(self, key, value):
+        self._data[key] = value
+        return self
+
+    def commit(self):
+        pass
+
+
+class TestConditionalRefresh(unittest.TestCase):
+    CACHE = "tmp_test_app_index.json"
+    URL = "http://localhost/app_index.json"
+
+    def setUp(self):
+        import asyncio
+        import appstore_core
+        import mpos
+        asyncio.new_event_loop()
+        self.core = appstore_core
+        _MemPrefs.store = {}
+        self._orig_prefs = appstore_core.SharedPreferences
+        appstore_core.SharedPreferences = _MemPrefs
+        self._orig_dl = mpos.DownloadManager.download_url
+        self._orig_iav = mpos.AppManager.is_update_available
+        # Two of the generated apps are installed in an older version
+        mpos.AppManager.is_update_available = staticmethod(
+            lambda fullname, version: fullname in ("com.example.app3", "com.example.app1500"))
+        appstore_core.AppUpdateManager._instance = None
+        self.aum = appstore_core.AppUpdateManager.get_instance()
+        self.aum._suppress_notifications = True
+        self.aum.INDEX_CACHE_PATH = self.CACHE
+        self._remove_cache()
+
+    def tearDown(self):
+        import mpos
+        self.core.SharedPreferences = self._orig_prefs
+        mpos.DownloadManager.download_url = self._orig_dl
+        mpos.AppManager.is_update_available = self._orig_iav
+        self.core.AppUpdateManager._instance = None
+        self._remove_cache()
+
+    def _remove_cache(self):
+        for path in (self.CACHE, self.CACHE + ".tmp"):
+            try:
+                os.remove(path)
+            except OSError:
+                pass
+
+    def _serve(self, body, etag):
+        import mpos
+        server = _FakeServer(body, etag)
+        mpos.DownloadManager.download_url = server.download_url
+        return server
+
+    def _check(self):
+        import asyncio
+        asyncio.get_event_loop().run_until_complete(self.aum.check_for_updates(self.URL))
+        return sorted(app["fullname"] for app in self.aum.updatable_apps)
+
+    def test_large_index_revalidates_with_etag(self):
+        body = json.dumps(_generate_index(2000)).encode()
+        server = self._serve(body, '"v1"')
+
+        self.assertEqual(self._check(), ["com.example.app1500", "com.example.app3"])
+        self.assertFalse("If-None-Match" in server.requests[0])
+        with open(self.CACHE, "rb") as f:
+            self.assertEqual(f.read(), body)
+
+        # Unchanged: one 304, entries come from the local copy
+        self.assertEqual(self._check(), ["com.example.app1500", "com.example.app3"])
+        self.assertEqual(server.requests[1]["If-None-Match"], '"v1"')
+        self.assertEqual(server.requests[1]["If-Modified-Since"], "Sat, 17 Oct 2026 10:00:00 GMT")
+
+        # Changed: full download replaces the copy
+        server.body = json.dumps(_generate_index(10)).encode()
+        server.etag = '"v2"'
+        self.assertEqual(self._check(), ["com.example.app3"])
+        self.assertEqual(_MemPrefs.store["index_cache.json"]["etag"], '"v2"')
+
+    def test_other_url_is_not_conditional(self):
+        server = self._serve(json.dumps(_generate_index(5)).encode(), '"v1"')
+        self._check()
+        _MemPrefs.store["index_cache.json"]["url"] = "http://elsewhere/index.json"
+        self._check()
+        self.assertFalse("If-None-Match" in server.requests[1])
+
+    def test_truncated_download_keeps_previous_copy(self):
+        body = json.dumps(_generate_index(5)).encode()
+        server = self._serve(body, '"v1"')
+        self._check()
+        server.body = body[:-20]
+        server.etag = '"v2"'
+        self._check()
+        self.assertEqual(self.aum.current_state, self.core.AppUpdateState.ERROR)
+        with open(self.CACHE, "rb") as f:
+            self.assertEqual(f.read(), body)
+        self.assertEqual(_MemPrefs.store["index_cache.json"]["etag"], '"v1"')
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -211,6 +211,7 @@ class TestAppUpdateManagerCheck(unittest.TestCase):
         AppUpdateManager._instance = None
         aum = AppUpdateManager.get_instance()
         aum._suppress_notifications = True
+        aum.INDEX_CACHE_PATH = None
 
         return {
             "aum": aum,
@@ -236,10 +237,14 @@ class TestAppUpdateManagerCheck(unittest.TestCase):
     def _mock_download_url(self, return_value=None, exception=None):
         import mpos.net.download_manager as dm
 
-        async def _dl(url):
+        async def _dl(url, chunk_callback=None, **kwargs):
             if exception:
                 raise exception
-            return return_value
+            data = return_value.encode() if isinstance(return_value, str) else return_value
+            if chunk_callback:
+                await chunk_callback(data)
+                return True
+            return data
 
         orig = dm.DownloadManager.download_url
         dm.DownloadManager.download_url = staticmethod(_dl)
@@ -573,6 +578,7 @@ class TestAppUpdateManagerNotifications(unittest.TestCase):
         AppUpdateManager._instance = None
         aum = AppUpdateManager.get_instance()
         aum._suppress_notifications = True
+        aum.INDEX_CACHE_PATH = None
         aum.updatable_apps = [{"fullname": "com.test.a", "name": "TestA"}]
         try:
             aum._notify_updates_available()
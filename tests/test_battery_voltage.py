@@ -6,6 +6,7 @@ Tests ADC1/ADC2 detection, caching, WiFi coordination, and voltage calculations.
 
 import unittest
 import sys
+import time
 
 # Allow importing shared test mocks
 sys.path.insert(0, "../tests")
@@ -351,6 +352,130 @@ class TestAveragingLogic(unittest.TestCase):
         self.assertEqual(raw, 2000.0)
 
 
+class TestBackgroundSampling(unittest.TestCase):
+    """Test the background sampler and the filtered estimate it keeps."""
+
+    def _init(self, pin, value=2000):
+        MockWifiService.reset()
+        BatteryManager.stop_sampling()
+        BatteryManager.clear_cache()
+        BatteryManager.init_adc(pin, lambda adc_value: adc_value * 0.00197)
+        import mpos.battery_manager as bm
+        bm._adc.set_read_value(value)
+        BatteryManager.clear_cache()
+        BatteryManager.read_raw_adc()
+        BatteryManager.start_sampling()
+        return bm
+
+    def tearDown(self):
+        BatteryManager.stop_sampling()
+        BatteryManager.clear_cache()
+        MockWifiService.reset()
+
+    def test_adc2_reads_never_disable_connected_wifi(self):
+        bm = self._init(13)
+        MockWifiService._connected = True
+        disables = []
+        orig = MockWifiService.temporarily_disable
+        MockWifiService.temporarily_disable = classmethod(lambda cls: disables.append(1) or orig())
+        try:
+            bm._adc.set_read_value(3000)
+            # Reads are served from the estimate however old it is; the
+            # sampler leaves WiFi alone while the estimate is within bounds
+            bm._last_read_time = time.ticks_add(time.ticks_ms(), -(bm.ADC2_MAX_ESTIMATE_AGE_MS - 1000))
+            self.assertEqual(BatteryManager.read_raw_adc(), 2000.0)
+            self.assertFalse(BatteryManager.sample(time.ticks_ms()))
+        finally:
+            MockWifiService.temporarily_disable = orig
+        self.assertEqual(disables, [])
+        self.assertTrue(MockWifiService.is_connected())
+
+    def test_adc2_samples_while_wifi_idle(self):
+        bm = self._init(13)
+        bm._adc.set_read_value(2400)
+        now = time.ticks_add(bm._last_read_time, 60000)
+        self.assertTrue(BatteryManager.sample(now))
+        estimate = BatteryManager.read_raw_adc()
+        self.assertTrue(2000 < estimate < 2400, f"estimate {estimate}")
+        self.assertFalse(MockWifiService.wifi_busy)
+        self.assertFalse(MockWifiService.is_connected())
+
+    def test_adc2_skips_sample_while_wifi_busy(self):
+        bm = self._init(13)
+        MockWifiService.wifi_busy = True
+        self.assertFalse(BatteryManager.sample(time.ticks_add(bm._last_read_time, 60000)))
+        self.assertEqual(BatteryManager.read_raw_adc(), 2000.0)
+
+    def test_adc2_stale_estimate_briefly_disables_connected_wifi(self):
+        bm = self._init(13)
+        MockWifiService._connected = True
+        bm._adc.set_read_value(1800)
+        start = bm._last_read_time
+        now = time.ticks_add(start, bm.ADC2_MAX_ESTIMATE_AGE_MS - 1)
+        self.assertFalse(BatteryManager.sample(now))
+        self.assertEqual(BatteryManager.estimate_age_ms(now), bm.ADC2_MAX_ESTIMATE_AGE_MS - 1)
+
+        now = time.ticks_add(start, bm.ADC2_MAX_ESTIMATE_AGE_MS)
+        self.assertTrue(BatteryManager.sample(now))
+        self.assertEqual(BatteryManager.estimate_age_ms(now), 0)
+        self.assertTrue(BatteryManager.read_raw_adc() < 2000)
+        # Reconnected, and not busy afterwards
+        self.assertTrue(MockWifiService.is_connected())
+        self.assertFalse(MockWifiService.wifi_busy)
+
+    def test_adc2_first_sample_waits_for_wifi_not_busy(self):
+        MockWifiService.reset()
+        BatteryManager.stop_sampling()
+        BatteryManager.init_adc(13, lambda adc_value: adc_value * 0.00197)
+        BatteryManager.clear_cache()
+        MockWifiService._connected = True
+        MockWifiService.wifi_busy = True
+        BatteryManager.start_sampling()
+        self.assertFalse(BatteryManager.has_estimate())
+        self.assertIsNone(BatteryManager.estimate_age_ms())
+        with self.assertRaises(RuntimeError):
+            BatteryManager.read_raw_adc()
+
+        # Once the connection attempt is done, the first read samples
+        MockWifiService.wifi_busy = False
+        import mpos.battery_manager as bm
+        bm._adc.set_read_value(2200)
+        self.assertEqual(BatteryManager.read_raw_adc(), 2200.0)
+        self.assertTrue(BatteryManager.has_estimate())
+        self.assertTrue(MockWifiService.is_connected())
+
+    def test_clear_cache_keeps_sampler_estimate(self):
+        self._init(13)
+        MockWifiService._connected = True
+        BatteryManager.clear_cache()
+        self.assertTrue(BatteryManager.has_estimate())
+        self.assertEqual(BatteryManager.read_raw_adc(), 2000.0)
+        self.assertTrue(MockWifiService.is_connected())
+
+    def test_filter_smooths_noise_and_follows_steps(self):
+        bm = self._init(5)
+        now = bm._last_read_time
+        for i in range(30):
+            bm._adc.set_read_value(2100 if i % 2 else 1900)
+            now = time.ticks_add(now, bm.SAMPLE_INTERVAL_MS)
+            self.assertTrue(BatteryManager.sample(now))
+        estimate = BatteryManager.read_raw_adc()
+        self.assertTrue(1950 < estimate < 2050, f"noisy estimate {estimate}")
+
+        bm._adc.set_read_value(2300)
+        for _ in range(30):
+            now = time.ticks_add(now, bm.SAMPLE_INTERVAL_MS)
+            BatteryManager.sample(now)
+        estimate = BatteryManager.read_raw_adc()
+        self.assertTrue(2250 < estimate <= 2300, f"step estimate {estimate}")
+
+    def test_force_refresh_still_reads(self):
+        bm = self._init(5)
+        bm._adc.set_read_value(2500)
+        self.assertEqual(BatteryManager.read_raw_adc(force_refresh=True), 2500.0)
+        self.assertEqual(BatteryManager.read_raw_adc(), 2500.0)
+
+
 class TestDesktopMode(unittest.TestCase):
     """Test behavior when ADC is not available (desktop mode)."""
 
@@ -0,0 +1,137 @@
+"""
+Headless test and benchmark for the Breakout native module's dirty rectangles.
+
+Every frame is sent to a fake flush target the way the app sends it to the
+display: step(), then render_rect(i) for each changed rectangle. The screen
+built from those flushes must match a full-frame render() of the same game
+state, while sending far fewer pixels.
+
+Usage:
+    python3 scripts/test_runner.py tests/test_breakout_dirty_rects.py
+"""
+
+import sys
+import time
+import unittest
+
+sys.path.insert(0, "apps/com.micropythonos.breakout")
+
+if sys.platform == "esp32":
+    import breakout_xtensawin as breakout
+else:
+    import breakout_x64 as breakout
+
+WIDTH = 320
+HEIGHT = 240
+# Partial framebuffer, so full redraws and tall rectangles are split into bands
+FB_ROWS = 40
+FRAMES = 120
+FRAME_MS = 20
+
+
+class FakeFlushTarget:
+    """Collects flushed windows into a full RGB565 screen and counts pixels."""
+
+    def __init__(self, width, height):
+        self.width = width
+        self.screen = bytearray(width * height * 2)
+        self.pixels = 0
+        self.flushes = 0
+
+    def flush(self, area, buf):
+        x1, y1, x2, y2 = area
+        w = x2 - x1 + 1
+        row_bytes = w * 2
+        for row in range(y2 - y1 + 1):
+            dst = ((y1 + row) * self.width + x1) * 2
+            self.screen[dst:dst + row_bytes] = buf[row * row_bytes:(row + 1) * row_bytes]
+        self.pixels += w * (y2 - y1 + 1)
+        self.flushes += 1
+
+
+class TestBreakoutDirtyRects(unittest.TestCase):
+
+    def setUp(self):
+        if not hasattr(breakout, "step"):
+            self.skipTest("stale breakout .mpy, rebuild it with c_mpos/breakout/build.sh")
+        self.framebuffer = bytearray(WIDTH * FB_ROWS * 2)
+        self.fb = memoryview(self.framebuffer)
+        breakout.init(self.framebuffer, WIDTH, HEIGHT)
+        breakout.set_lives(99)
+        self.target = FakeFlushTarget(WIDTH, HEIGHT)
+
+    def _send_frame(self):
+        """Flush what changed, like Breakout.drawframe(). Returns pixels sent."""
+        before = self.target.pixels
+        for i in range(breakout.step()):
+            self.target.flush(breakout.render_rect(i), self.fb)
+        return self.target.pixels - before
+
+    def _full_frame(self):
+        """Render the current state without advancing it, in framebuffer bands."""
+        screen = bytearray(WIDTH * HEIGHT * 2)
+        for y in range(0, HEIGHT, FB_ROWS):
+            rows = min(FB_ROWS, HEIGHT - y)
+            breakout.render(y, rows, False)
+            screen[y * WIDTH * 2:(y + rows) * WIDTH * 2] = self.fb[:rows * WIDTH * 2]
+        return screen
+
+    def _assert_screen_matches(self, frame):
+        self.assertTrue(self.target.screen == self._full_frame(),
+                        "dirty-rect screen differs from full render at frame %d" % frame)
+
+    def test_dirty_rects_match_full_frames(self):
+        # The first frame after init() redraws everything
+        self.assertEqual(self._send_frame(), WIDTH * HEIGHT)
+        self._assert_screen_matches(0)
+
+        score = breakout.get_score()
+        incremental = 0
+        for frame in range(1, FRAMES + 1):
+            time.sleep_ms(FRAME_MS)
+            if frame % 10 == 0:
+                breakout.move_paddle(WIDTH // 10 if frame % 20 else -WIDTH // 10)
+            incremental += self._send_frame()
+            self._assert_screen_matches(frame)
+
+        # The ball hit bricks, so brick rectangles were flushed too
+        self.assertTrue(breakout.get_score() > score)
+        self.assertTrue(incremental * 20 < FRAMES * WIDTH * HEIGHT,
+                        "%d pixels flushed over %d frames" % (incremental, FRAMES))
+
+    def test_level_change_redraws_everything(self):
+        self._send_frame()
+        time.sleep_ms(FRAME_MS)
+        self._send_frame()
+        breakout.set_level(3)
+        self.assertEqual(self._send_frame(), WIDTH * HEIGHT)
+        self._assert_screen_matches(0)
+        time.sleep_ms(FRAME_MS)
+        self.assertTrue(self._send_frame() < WIDTH * HEIGHT)
+        self._assert_screen_matches(1)
+
+    def test_benchmark_dirty_rects_vs_full_frames(self):
+        self._send_frame()
+        dirty_us = 0
+        full_us = 0
+        dirty_pixels = 0
+        for _ in range(30):
+            time.sleep_ms(FRAME_MS)
+            t0 = time.ticks_us()
+            dirty_pixels += self._send_frame()
+            t1 = time.ticks_us()
+            full = FakeFlushTarget(WIDTH, HEIGHT)
+            for y in range(0, HEIGHT, FB_ROWS):
+                rows = min(FB_ROWS, HEIGHT - y)
+                breakout.render(y, rows, False)
+                full.flush((0, y, WIDTH - 1, y + rows - 1), self.fb)
+            t2 = time.ticks_us()
+            dirty_us += time.ticks_diff(t1, t0)
+            full_us += time.ticks_diff(t2, t1)
+        print("\nbreakout %dx%d, 30 frames: dirty rects %d px in %d us, full frames %d px in %d us" % (
+            WIDTH, HEIGHT, dirty_pixels, dirty_us, 30 * WIDTH * HEIGHT, full_us))
+        self.assertTrue(dirty_pixels < 30 * WIDTH * HEIGHT)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,149 @@
+"""
+Test the virtualized directory listing of FileExplorerActivity.
+
+Generates a directory with a few hundred entries and checks that the
+listing streams in through os.ilistdir() batches, stays sorted (dirs
+first), and is shown by a small pool of recycled rows rather than one
+button per entry. The long-press highlight follows its entry across
+rebinds.
+
+Usage:
+"""
+
+import os
+import shutil
+import unittest
+
+import mpos.ui
+from mpos import Intent, wait_for_render
+from mpos.ui import file_explorer_activity
+from mpos.ui.file_explorer_activity import FileExplorerActivity
+
+TREE = "data/tmp_file_explorer_big"
+FILES = 400
+DIRS = 5
+
+
+class TestMergeSorted(unittest.TestCase):
+
+    def test_merge(self):
+        merge = file_explorer_activity._merge_sorted
+        self.assertEqual(merge(["a", "c", "e"], ["b", "d", "f", "g"]), ["a", "b", "c", "d", "e", "f", "g"])
+        self.assertEqual(merge([], ["x"]), ["x"])
+        self.assertEqual(merge(["x"], []), ["x"])
+
+
+class TestGraphicalFileExplorerVirtualList(unittest.TestCase):
+
+    @classmethod
+    def setUpClass(cls):
+        cls._rm(TREE)
+        os.mkdir(TREE)
+        for i in range(FILES):
+            open("%s/file_%04d.txt" % (TREE, FILES - 1 - i), "w").close()
+        for i in range(DIRS):
+            os.mkdir("%s/dir_%d" % (TREE, i))
+
+    @classmethod
+    def tearDownClass(cls):
+        cls._rm(TREE)
+
+    @staticmethod
+    def _rm(path):
+        try:
+            os.stat(path)
+        except OSError:
+            return
+        shutil.rmtree(path)
+
+    def setUp(self):
+        for _ in range(10):
+            if len(mpos.ui.screen_stack) <= 1:
+                break
+            mpos.ui.back_screen()
+            wait_for_render(5)
+
+    def tearDown(self):
+        self.setUp()
+
+    def _open_explorer(self, mode=None):
+        extras = {"start_dir": TREE}
+        if mode is not None:
+            extras["mode"] = mode
+        caller = mpos.ui.screen_stack[-1][0]
+        caller.startActivityForResult(
+            Intent(action="pick_file", extras=extras),
+            lambda result: None,
+        )
+        wait_for_render(10)
+        explorer = mpos.ui.screen_stack[-1][0]
+        self.assertIsInstance(explorer, FileExplorerActivity)
+        for _ in range(100):
+            if explorer._listing is None:
+                break
+            wait_for_render(2)
+        self.assertIsNone(explorer._listing, "listing did not finish streaming")
+        return explorer
+
+    def test_entries_streamed_sorted_and_recycled(self):
+        explorer = self._open_explorer()
+
+        self.assertEqual(explorer._entry_count(), 1 + DIRS + FILES)
+        self.assertEqual(explorer._entry(0)[0], "< Back")
+        self.assertTrue(explorer._entry(1)[2])
+        self.assertTrue(explorer._entry(1)[1].endswith("/dir_0/"))
+        self.assertFalse(explorer._entry(1 + DIRS)[2])
+        self.assertTrue(explorer._entry(1 + DIRS)[1].endswith("/file_0000.txt"))
+
+        # Only a screenful of rows exists, not one button per entry
+        self.assertTrue(0 < len(explorer._rows) < 40)
+
+    def test_scrolling_rebinds_rows(self):
+        explorer = self._open_explorer()
+        last = explorer._entry_count() - 1
+
+        explorer._list.scroll_to_y(last * explorer._row_h, False)
+        wait_for_render(5)
+
+        pool = len(explorer._rows)
+        r = last % pool
+        self.assertEqual(explorer._row_entry[r], last)
+        text = explorer._list.get_button_text(explorer._rows[r])
+        self.assertTrue(text.endswith("file_%04d.txt" % (FILES - 1)))
+
+    def _row_text(self, explorer, i):
+        for r, entry in enumerate(explorer._row_entry):
+            if entry == i:
+                return explorer._list.get_button_text(explorer._rows[r])
+        return None
+
+    def test_highlight_follows_path_across_rebinds(self):
+        explorer = self._open_explorer(FileExplorerActivity.MODE_BROWSE)
+        i = 1 + DIRS
+        path = explorer._entry(i)[1]
+        explorer._on_any_long_press(None, path)
+        self.assertTrue(self._row_text(explorer, i).startswith("> "))
+
+        # A listing batch rebinds every row; the highlight stays on the entry
+        explorer._refresh_rows()
+        self.assertTrue(self._row_text(explorer, i).startswith("> "))
+
+        # Scrolled away, the recycled row shows another entry without it
+        explorer._list.scroll_to_y((explorer._entry_count() - 1) * explorer._row_h, False)
+        wait_for_render(5)
+        self.assertIsNone(self._row_text(explorer, i))
+        for r, entry in enumerate(explorer._row_entry):
+            if entry >= 0:
+                self.assertFalse(explorer._list.get_button_text(explorer._rows[r]).startswith("> "))
+
+        explorer._list.scroll_to_y(0, False)
+        wait_for_render(5)
+        self.assertTrue(self._row_text(explorer, i).startswith("> "))
+        self.assertEqual(explorer._suppress_path, path)
+
+        explorer._dismiss_action_bar()
+        self.assertFalse(self._row_text(explorer, i).startswith("> "))
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,78 @@
+"""
+Graphical tests for cursor-aware editing with MposKeyboard.
+
+Checks that:
+- Typed characters are inserted at the textarea cursor, not appended
+- Backspace deletes the character before the cursor
+- Typing into a long text keeps the rest of the text intact
+- Emoji detection for a key label is computed once and cached
+
+Usage:
+"""
+
+import unittest
+import lvgl as lv
+
+from mpos import FontManager
+from mpos.ui.testing import KeyboardTestCase
+
+
+class TestGraphicalKeyboardCursorInsert(KeyboardTestCase):
+    def test_insert_at_cursor(self):
+        keyboard, textarea = self.create_keyboard_scene(initial_text="helo")
+        textarea.set_cursor_pos(3)
+        self.wait_for_render()
+
+        self.assertTrue(self.click_keyboard_button("l"))
+        self.wait_for_render()
+
+        self.assertTextareaText("hello")
+        self.assertEqual(textarea.get_cursor_pos(), 4)
+
+    def test_backspace_at_cursor(self):
+        keyboard, textarea = self.create_keyboard_scene(initial_text="abcdef")
+        textarea.set_cursor_pos(2)
+        self.wait_for_render()
+
+        self.assertTrue(self.click_keyboard_button(lv.SYMBOL.BACKSPACE))
+        self.wait_for_render()
+
+        self.assertTextareaText("acdef")
+        self.assertEqual(textarea.get_cursor_pos(), 1)
+
+    def test_space_at_cursor(self):
+        keyboard, textarea = self.create_keyboard_scene(initial_text="ab")
+        textarea.set_cursor_pos(1)
+        self.wait_for_render()
+
+        self.assertTrue(self.click_keyboard_button(keyboard.LABEL_SPACE))
+        self.wait_for_render()
+
+        self.assertTextareaText("a b")
+
+    def test_typing_into_long_text(self):
+        long_text = "x" * 2000
+        keyboard, textarea = self.create_keyboard_scene(initial_text=long_text)
+        textarea.set_cursor_pos(1000)
+
+        self.assertTrue(self.type_text("qwe"))
+        self.wait_for_render()
+
+        self.assertTextareaText(long_text[:1000] + "qwe" + long_text[1000:])
+
+    def test_emoji_detection_cached_per_key(self):
+        if not FontManager.getEmojiCodepoints():
+            self.skipTest("no emoji font available")
+        keyboard, textarea = self.create_keyboard_scene(initial_text="")
+        type(keyboard)._emoji_key_cache.clear()
+
+        self.assertTrue(self.type_text("ab"))
+        self.wait_for_render()
+
+        self.assertIn("a", type(keyboard)._emoji_key_cache)
+        self.assertFalse(type(keyboard)._emoji_key_cache["a"])
+        self.assertFalse(keyboard._textarea_emoji_font_applied)
+
+
+if __name__ == "__main__":
+    unittest.main()
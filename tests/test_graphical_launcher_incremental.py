@@ -0,0 +1,95 @@
+"""
+Graphical test for incremental launcher grid updates.
+
+Resuming the launcher after the app list changed must only touch the tiles
+of the apps that changed: other tiles (and their decoded icons) are kept.
+"""
+
+import time
+import unittest
+
+import mpos.ui
+
+from mpos import App, AppManager
+from mpos.ui.testing import wait_for_render
+
+
+def _go_back_to_launcher(max_steps=6):
+    for _ in range(max_steps):
+        if len(mpos.ui.screen_stack) <= 1:
+            return
+        mpos.ui.back_screen()
+        wait_for_render(10)
+
+
+class TestLauncherIncremental(unittest.TestCase):
+    def setUp(self):
+        AppManager.restart_launcher()
+        wait_for_render(20)
+        _go_back_to_launcher()
+        self.launcher = mpos.ui.screen_stack[-1][0]
+        self.screen = self.launcher._screen
+        self._orig_get_app_list = AppManager.get_app_list
+        self.apps = list(AppManager.get_app_list())
+
+    def tearDown(self):
+        AppManager.get_app_list = self._orig_get_app_list
+        self.launcher.onResume(self.screen)
+        wait_for_render(10)
+
+    def _resume_with(self, apps):
+        AppManager.get_app_list = classmethod(lambda cls: apps)
+        self.launcher.onResume(self.screen)
+        wait_for_render(5)
+
+    def _labels(self):
+        return [self.screen.get_child(i).get_child(1).get_text() for i in range(self.screen.get_child_count())]
+
+    def test_unchanged_list_keeps_every_tile(self):
+        before = dict(self.launcher._app_cont_map)
+        self._resume_with(self.apps)
+        for fullname, app_cont in before.items():
+            self.assertIs(self.launcher._app_cont_map[fullname], app_cont)
+
+    def test_insert_update_remove_touch_only_those_tiles(self):
+        before = dict(self.launcher._app_cont_map)
+        tiles = [f for f in before]
+        self.assertTrue(len(tiles) >= 3, "need a few installed apps")
+        removed = tiles[0]
+        updated = tiles[1]
+
+        apps = [app for app in self.apps if app.fullname != removed]
+        for i, app in enumerate(apps):
+            if app.fullname == updated:
+                apps[i] = App(name="Renamed App", fullname=updated, version="99.0.0",
+                              installed_path=app.installed_path)
+        apps.insert(1, App(name="Inserted App", fullname="com.example.inserted", version="1.0.0"))
+
+        self._resume_with(apps)
+
+        cont_map = self.launcher._app_cont_map
+        self.assertFalse(removed in cont_map)
+        self.assertIn("com.example.inserted", cont_map)
+        self.assertIs(cont_map[updated], before[updated])
+        for fullname in tiles[2:]:
+            self.assertIs(cont_map[fullname], before[fullname])
+        self.assertIn("Renamed App", self._labels())
+        self.assertEqual(self._labels()[1], "Inserted App")
+        self.assertEqual(self.screen.get_child_count(), len(cont_map))
+
+    def test_many_apps_resume_quickly(self):
+        many = self.apps + [
+            App(name="Bulk %d" % i, fullname="com.example.bulk%d" % i, version="1.0.0")
+            for i in range(150)
+        ]
+        self._resume_with(many)
+        start = time.ticks_ms()
+        many[-1] = App(name="Bulk changed", fullname="com.example.bulk149", version="2.0.0")
+        self._resume_with(many)
+        elapsed = time.ticks_diff(time.ticks_ms(), start)
+        print("incremental resume with %d apps took %dms" % (len(many), elapsed))
+        self.assertEqual(self._labels()[-1], "Bulk changed")
+
+
+if __name__ == "__main__":
+    unittest.main()
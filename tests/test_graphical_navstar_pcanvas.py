@@ -0,0 +1,78 @@
+"""
+Test the retained-mode Canvas used by the navstar app (pcanvas.py).
+
+Frames are recorded between clear() and update(); update() must skip
+identical frames and repaint only the rectangles around primitives that
+changed.
+
+Usage:
+"""
+
+import sys
+import unittest
+import lvgl as lv
+from mpos import wait_for_render
+
+sys.path.append("apps/cz.ucw.pavel.navstar/assets")
+
+from pcanvas import Canvas, merge_rects
+
+
+class TestMergeRects(unittest.TestCase):
+
+    def test_overlapping_rects_merge(self):
+        self.assertEqual(merge_rects([(0, 0, 10, 10), (5, 5, 20, 20)], 320, 200), [(0, 0, 20, 20)])
+
+    def test_disjoint_rects_stay_separate(self):
+        rects = merge_rects([(0, 0, 10, 10), (100, 100, 110, 110)], 320, 200)
+        self.assertEqual(len(rects), 2)
+
+    def test_rects_clipped_to_canvas(self):
+        self.assertEqual(merge_rects([(-5, -5, 10, 500)], 320, 200), [(0, 0, 10, 199)])
+        self.assertEqual(merge_rects([(400, 0, 410, 10)], 320, 200), [])
+
+    def test_large_dirty_area_becomes_full_canvas(self):
+        self.assertEqual(merge_rects([(0, 0, 319, 150)], 320, 200), [(0, 0, 319, 199)])
+
+
+class TestRetainedCanvas(unittest.TestCase):
+
+    def setUp(self):
+        self.screen = lv.obj()
+        self.screen.set_size(320, 240)
+        lv.screen_load(self.screen)
+        canvas = lv.canvas(self.screen)
+        canvas.set_size(320, 240 - 43)
+        self.ui = Canvas(self.screen, canvas)
+
+    def tearDown(self):
+        lv.screen_load(lv.obj())
+        wait_for_render(5)
+
+    def _frame(self, speed):
+        ui = self.ui
+        ui.clear()
+        ui.text(0, 28, "Lat: 50.087465")
+        ui.text(0, 56, "Speed: %.1f km/h" % speed)
+        ui.circle(160, 150, 30)
+        ui.update()
+
+    def test_identical_frame_repaints_nothing(self):
+        self._frame(12.0)
+        self._frame(12.0)
+        self.assertEqual(self.ui.last_dirty, [])
+
+    def test_changed_text_repaints_only_its_row(self):
+        self._frame(12.0)
+        wait_for_render(2)
+        self._frame(12.5)
+        if not self.ui._can_clip:
+            self.skipTest("layer clipping not available in this binding")
+        self.assertEqual(len(self.ui.last_dirty), 1)
+        x1, y1, x2, y2 = self.ui.last_dirty[0]
+        self.assertEqual(y1, 56)
+        self.assertTrue(y2 < 100)
+
+
+if __name__ == "__main__":
+    unittest.main()
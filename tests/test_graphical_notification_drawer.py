@@ -0,0 +1,77 @@
+"""
+Graphical test for incremental notification drawer updates.
+
+Progress-style updates to a notification must patch its card in place,
+bursts of them must be coalesced into one drawer refresh, and the cards of
+other notifications must be left alone.
+"""
+
+import unittest
+
+import lvgl as lv
+
+from mpos import Notification, NotificationManager, wait_for_render
+from mpos.ui import topmenu
+
+
+def _notification(notification_id, title, text=""):
+    return Notification(notification_id=notification_id, icon=lv.SYMBOL.DOWNLOAD,
+                        title=title, text=text, app_fullname="com.micropythonos.settings")
+
+
+class TestNotificationDrawerIncremental(unittest.TestCase):
+
+    def setUp(self):
+        NotificationManager.cancel_all()
+        NotificationManager.notify(_notification("test.drawer.static", "Static"))
+        NotificationManager.notify(_notification("test.drawer.progress", "Download", "0%"))
+        topmenu.open_drawer()
+        wait_for_render(10)
+        self._orig_refresh = topmenu._refresh_drawer_notifications
+        self.refreshes = 0
+
+        def counting_refresh():
+            self.refreshes += 1
+            self._orig_refresh()
+        topmenu._refresh_drawer_notifications = counting_refresh
+
+    def tearDown(self):
+        topmenu._refresh_drawer_notifications = self._orig_refresh
+        topmenu.close_drawer()
+        NotificationManager.cancel_all()
+        wait_for_render(10)
+
+    def test_progress_burst_patches_one_card(self):
+        static_row = topmenu._drawer_rows["test.drawer.static"]
+        progress_row = topmenu._drawer_rows["test.drawer.progress"]
+        static_shown = static_row[4]
+
+        for percent in range(1, 101):
+            NotificationManager.notify(_notification("test.drawer.progress", "Download", "%d%%" % percent))
+        wait_for_render(10)
+
+        # One refresh, or two if the task handler ran mid-burst
+        self.assertTrue(1 <= self.refreshes <= 2, "%d drawer refreshes" % self.refreshes)
+        self.assertIs(topmenu._drawer_rows["test.drawer.progress"], progress_row)
+        self.assertEqual(progress_row[3].get_text(), "100%")
+        self.assertIs(topmenu._drawer_rows["test.drawer.static"], static_row)
+        self.assertIs(static_row[4], static_shown)
+
+    def test_add_and_cancel_keep_other_cards(self):
+        static_card = topmenu._drawer_rows["test.drawer.static"][0]
+        NotificationManager.notify(_notification("test.drawer.new", "New"))
+        wait_for_render(10)
+        self.assertEqual(len(topmenu._drawer_notif_focusables), 3)
+        new_card = topmenu._drawer_rows["test.drawer.new"][0]
+        self.assertEqual(new_card.get_index(), topmenu._drawer_notif_focusables.index(new_card))
+
+        NotificationManager.cancel("test.drawer.progress")
+        wait_for_render(10)
+        self.assertFalse("test.drawer.progress" in topmenu._drawer_rows)
+        self.assertIs(topmenu._drawer_rows["test.drawer.static"][0], static_card)
+        self.assertEqual(len(topmenu._drawer_notif_focusables), 2)
+        self.assertTrue(topmenu.drawer_notifications_title.get_text().endswith("(2)"))
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,107 @@
+"""
+Test the packed-state particle emitter (mpos.ui.particles).
+
+The integrator is checked in its Python form and, when the firmware has it,
+against the native _particles module; the emitter is checked for capacity,
+expiry and drawing every live particle in one pass.
+
+Usage:
+"""
+
+import unittest
+from array import array
+import lvgl as lv
+from mpos import wait_for_render
+from mpos.ui import particles
+from mpos.ui.particles import ParticleEmitter, STRIDE, _step_py
+
+SRC = "M:builtin/res/emojis/32x32/1F339.png"
+
+
+def _particle(x, y, vx, vy, life, spin=0):
+    return [x * 256, y * 256, vx * 256, vy * 256, 0, spin * 10, 0, life, 0, 256]
+
+
+class TestStep(unittest.TestCase):
+
+    def test_motion_and_gravity(self):
+        s = array("i", _particle(10, 20, 100, -50, 5000, spin=90))
+        n = _step_py(s, 1, 100, 100, 320, 240, 60)
+        self.assertEqual(n, 1)
+        self.assertEqual(s[0] >> 8, 20)     # x + 100 px/s * 0.1 s
+        self.assertEqual(s[1] >> 8, 15)     # y - 50 px/s * 0.1 s
+        self.assertEqual(s[3], (-50 + 10) * 256)  # vy + gravity * dt
+        self.assertEqual(s[4], 90)           # 90 deg/s * 0.1 s, in 0.1 deg
+        self.assertEqual(s[6], 100)
+        self.assertTrue(77 <= s[9] < 256)
+
+    def test_dead_particles_are_compacted(self):
+        s = array("i", _particle(0, 0, 0, 0, 50) + _particle(1, 1, 0, 0, 5000)
+                  + _particle(0, 500, 0, 0, 5000) + _particle(3, 3, 0, 0, 5000))
+        n = _step_py(s, 4, 100, 0, 320, 240, 60)
+        self.assertEqual(n, 2)
+        xs = sorted([s[i * STRIDE] >> 8 for i in range(n)])
+        self.assertEqual(xs, [1, 3])
+
+    def test_native_matches_python(self):
+        if particles._native is None:
+            self.skipTest("_particles not built into this firmware")
+        init = []
+        for k in range(20):
+            init += _particle(k * 15, k * 7, k * 13 - 120, -k * 9, 1000 + k * 200, spin=k * 31 - 300)
+        a = array("i", init)
+        b = array("i", init)
+        na = nb = 20
+        for _ in range(30):
+            na = _step_py(a, na, 33, 100, 320, 240, 60)
+            nb = particles._native.step(b, nb, 33, 100, 320, 240, 60)
+        self.assertEqual(na, nb)
+        self.assertEqual(list(a[:na * STRIDE]), list(b[:nb * STRIDE]))
+
+
+class TestParticleEmitter(unittest.TestCase):
+
+    def setUp(self):
+        self.screen = lv.obj()
+        lv.screen_load(self.screen)
+        self.emitter = ParticleEmitter(self.screen, [SRC], max_particles=300)
+
+    def tearDown(self):
+        self.emitter.delete()
+        lv.screen_load(lv.obj())
+        wait_for_render(5)
+
+    def test_source_size_probed(self):
+        self.assertEqual((self.emitter.src_width[0], self.emitter.src_height[0]), (32, 32))
+
+    def test_capacity_is_bounded(self):
+        for i in range(310):
+            self.emitter.emit(i % 300, 10, 0, 0, 1000)
+        self.assertEqual(self.emitter.count, 300)
+        self.assertFalse(self.emitter.emit(0, 0, 0, 0, 1000))
+
+    def test_hundreds_of_particles_draw_and_expire(self):
+        drawn = []
+        self.emitter.obj.add_event_cb(lambda e: drawn.append(self.emitter.count), lv.EVENT.DRAW_MAIN_END, None)
+        for i in range(250):
+            self.emitter.emit(i % 300, 40, 0, 0, 200 + i)
+        self.emitter.start()
+        self.emitter.stop()
+        wait_for_render(5)
+        self.assertTrue(len(drawn) > 0)
+        for _ in range(5):
+            self.emitter.advance(100)
+        self.assertEqual(self.emitter.count, 0)
+
+    def test_on_frame_only_while_running(self):
+        calls = []
+        self.emitter.on_frame = calls.append
+        self.emitter.advance(16)
+        self.assertEqual(calls, [])
+        self.emitter.running = True
+        self.emitter.advance(16)
+        self.assertEqual(calls, [16])
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,96 @@
+"""
+Test the batched sprite layer (mpos.ui.sprites).
+
+Checks that bitmaps are built from text rows, that flush() only invalidates
+what changed and merges nearby changes into few rectangles, and that all
+visible sprites are drawn by the layer itself.
+
+Usage:
+"""
+
+import unittest
+import lvgl as lv
+from mpos import wait_for_render
+from mpos.ui.sprites import STRIDE, SpriteLayer
+
+_WHITE = lv.color_hex(0xFFFFFF)
+
+
+class TestSpriteLayer(unittest.TestCase):
+
+    def setUp(self):
+        self.screen = lv.obj()
+        lv.screen_load(self.screen)
+        self.layer = SpriteLayer(self.screen, 240, 200, max_sprites=40)
+        self.dot = self.layer.add_bitmap(("##", "# "), lv.color_hex(0x102030))
+        self.block = self.layer.add_rect(8, 8, _WHITE)
+
+    def tearDown(self):
+        self.layer.delete()
+        lv.screen_load(lv.obj())
+        wait_for_render(5)
+
+    def _row(self, n, x, y, step):
+        sprites = []
+        for i in range(n):
+            s = self.layer.add_sprite(self.block)
+            self.layer.move(s, x + i * step, y)
+            self.layer.show(s)
+            sprites.append(s)
+        return sprites
+
+    def test_bitmap_from_rows(self):
+        self.assertEqual((self.layer.widths[self.dot], self.layer.heights[self.dot]), (2, 2))
+        buf = self.layer._buffers[self.dot]
+        self.assertEqual(bytes(buf[0:4]), bytes([0x30, 0x20, 0x10, 255]))
+        self.assertEqual(buf[4 * 3 + 3], 0)  # bottom right pixel is transparent
+
+    def test_unchanged_sprites_invalidate_nothing(self):
+        self._row(5, 0, 0, 20)
+        self.assertTrue(self.layer.flush() > 0)
+        self.assertEqual(self.layer.flush(), 0)
+
+    def test_formation_moves_as_one_rect(self):
+        sprites = self._row(16, 4, 10, 12)
+        self.layer.flush()
+        for s in sprites:
+            x = self.layer.table[s * STRIDE]
+            self.layer.move(s, x + 1, 10)
+        self.assertEqual(self.layer.flush(), 1)
+
+    def test_distant_changes_stay_separate(self):
+        a = self.layer.add_sprite(self.block)
+        b = self.layer.add_sprite(self.block)
+        self.layer.move(a, 0, 0)
+        self.layer.move(b, 200, 180)
+        self.layer.show(a)
+        self.layer.show(b)
+        self.assertEqual(self.layer.flush(), 2)
+
+    def test_hide_invalidates_old_position(self):
+        s = self._row(1, 50, 50, 0)[0]
+        self.layer.flush()
+        px = self.layer.invalidated_px
+        self.layer.hide(s)
+        self.assertEqual(self.layer.flush(), 1)
+        self.assertEqual(self.layer.invalidated_px - px, 64)
+        self.assertFalse(self.layer.is_visible(s))
+
+    def test_capacity_is_bounded(self):
+        for _ in range(40):
+            self.layer.add_sprite(self.dot)
+        with self.assertRaises(ValueError):
+            self.layer.add_sprite(self.dot)
+
+    def test_draws_in_one_pass(self):
+        drawn = []
+        self.layer.obj.add_event_cb(lambda e: drawn.append(1), lv.EVENT.DRAW_MAIN_END, None)
+        self._row(30, 0, 0, 8)
+        self.layer.flush()
+        wait_for_render(5)
+        self.assertTrue(len(drawn) > 0)
+        self.assertEqual(self.screen.get_child_count(), 1)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,83 @@
+"""
+Unit tests for the duration-array IR decoders and encoders (mpos.ir_protocols).
+
+Traces are mark/space durations in microseconds as IRManager captures them.
+Receiver modules stretch marks and shorten spaces by up to ~100us, so the
+encoded frames are skewed that way before decoding.
+
+Usage:
+"""
+
+import unittest
+
+from mpos import ir_protocols
+
+
+def _skew(durations, mark_us=90):
+    # Marks at even indices come out longer, spaces shorter
+    return [d + mark_us if i % 2 == 0 else d - mark_us for i, d in enumerate(durations)]
+
+
+# NEC frame for addr 0x32 cmd 0x81 (Optoma power) with uneven receiver skew
+_OPTOMA_POWER = [
+    9072, 4415, 670, 520, 662, 1616, 609, 503, 617, 476, 663, 1616, 651, 1578, 616, 492,
+    604, 496, 655, 1612, 626, 474, 623, 1638, 620, 1591, 619, 507, 603, 523, 629, 1620,
+    624, 1626, 640, 1607, 628, 454, 629, 500, 628, 474, 641, 521, 649, 470, 624, 505,
+    636, 1639, 645, 485, 603, 1604, 611, 1608, 648, 1608, 664, 1607, 626, 1586, 663, 1625,
+    610, 491, 605,
+]
+
+
+class TestDecoders(unittest.TestCase):
+
+    def test_skewed_nec_trace(self):
+        self.assertEqual(ir_protocols.decode_nec(_OPTOMA_POWER), (0x81, 0x32, 0))
+        self.assertEqual(ir_protocols.decode(_OPTOMA_POWER), ("nec", 0x81, 0x32, 0))
+
+    def test_nec_round_trip(self):
+        for addr, cmd in ((0x00, 0x00), (0x32, 0x81), (0xFF, 0x7E), (0x1234, 0x55)):
+            frame = _skew(ir_protocols.encode_nec(addr, cmd))
+            self.assertEqual(ir_protocols.decode_nec(frame), (cmd, addr, 0))
+
+    def test_nec_repeat(self):
+        self.assertEqual(ir_protocols.decode_nec([9010, 2240, 600])[0], ir_protocols.REPEAT)
+        self.assertEqual(ir_protocols.decode([9010, 2240, 600])[:2], ("nec", ir_protocols.REPEAT))
+
+    def test_nec_rejects_bad_frames(self):
+        frame = ir_protocols.encode_nec(0x32, 0x81)
+        self.assertEqual(ir_protocols.decode_nec(frame[:40])[0], ir_protocols.BADBLOCK)
+        broken = list(frame)
+        broken[35] = 1687 if broken[35] < 1000 else 563  # flip a command bit
+        self.assertEqual(ir_protocols.decode_nec(broken)[0], ir_protocols.BADDATA)
+        self.assertEqual(ir_protocols.decode_nec([3000, 4500, 563])[0], ir_protocols.BADSTART)
+        short_addr = ir_protocols.encode_nec(0x1234, 0x55)
+        self.assertEqual(ir_protocols.decode_nec(short_addr, extended=False)[0], ir_protocols.BADADDR)
+
+    def test_samsung(self):
+        frame = _skew(ir_protocols.encode_nec(7, 2, samsung=True))
+        self.assertEqual(ir_protocols.decode_nec(frame, samsung=True), (2, 0x0707, 0))
+        self.assertEqual(ir_protocols.decode(frame), ("samsung", 2, 0x0707, 0))
+
+    def test_sony(self):
+        for bits, addr, ext in ((12, 1, 0), (15, 0x9A, 0), (20, 0x1F, 0xA5)):
+            frame = _skew(ir_protocols.encode_sony(addr, 21, bits, ext))
+            self.assertEqual(len(frame), 1 + 2 * bits)
+            self.assertEqual(ir_protocols.decode_sony(frame), (21, addr, ext))
+        self.assertEqual(ir_protocols.decode(_skew(ir_protocols.encode_sony(1, 18))), ("sony", 18, 1, 0))
+        self.assertEqual(ir_protocols.decode_sony([2400, 600, 1200])[0], ir_protocols.BADBLOCK)
+
+    def test_tcl(self):
+        frame = _skew(ir_protocols.encode_tcl(0x054F, 0xAB))
+        self.assertEqual(ir_protocols.decode_tcl(frame), (0xAB, 0x054F, 0))
+        self.assertEqual(ir_protocols.decode(frame), ("tcl", 0xAB, 0x054F, 0))
+
+    def test_decode_accepts_arrays_and_rejects_noise(self):
+        from array import array
+        self.assertEqual(ir_protocols.decode(array("H", _OPTOMA_POWER))[1:3], (0x81, 0x32))
+        self.assertIsNone(ir_protocols.decode([]))
+        self.assertIsNone(ir_protocols.decode([300, 200, 300]))
+        self.assertIsNone(ir_protocols.decode([9000, 4500, 563, 563]))
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,154 @@
+"""
+Unit tests for the LightsManager animation engine and mpos.light_effects.
+
+Frames are captured through LightsManager.frame_sink and stepped with explicit
+timestamps (play(start=False)), so no timer or LED hardware is needed.
+
+Usage:
+"""
+
+import sys
+import unittest
+
+
+class MockPin:
+    IN = 0
+    OUT = 1
+
+    def __init__(self, pin_number, mode=None):
+        self.pin_number = pin_number
+        self.mode = mode
+
+
+class MockNeoPixel:
+    """Byte buffer in GRB order, like MicroPython's neopixel.NeoPixel."""
+
+    ORDER = (1, 0, 2, 3)
+
+    def __init__(self, pin, n, bpp=3):
+        self.pin = pin
+        self.n = n
+        self.buf = bytearray(n * bpp)
+        self.write_count = 0
+
+    def __setitem__(self, i, v):
+        o = 3 * i
+        for k in range(3):
+            self.buf[o + self.ORDER[k]] = v[k]
+
+    def __getitem__(self, i):
+        o = 3 * i
+        return tuple(self.buf[o + self.ORDER[k]] for k in range(3))
+
+    def write(self):
+        self.write_count += 1
+
+
+sys.modules['machine'] = type('module', (), {'Pin': MockPin})()
+sys.modules['neopixel'] = type('module', (), {'NeoPixel': MockNeoPixel})()
+
+from mpos import LightsManager
+from mpos.light_effects import Breathe, Chase, Fade, Keyframes, encode, fill
+
+
+def _grb(r, g, b):
+    return bytes((g, r, b))
+
+
+class TestLightEffects(unittest.TestCase):
+
+    def setUp(self):
+        LightsManager.init(neopixel_pin=12)
+        LightsManager.set_led_num(5)
+        self.frames = []
+        LightsManager.frame_sink = lambda frame: self.frames.append(bytes(frame))
+
+    def tearDown(self):
+        LightsManager.stop()
+        LightsManager.frame_sink = None
+
+    def _play(self, effect):
+        self.assertTrue(LightsManager.play(effect, start=False))
+        return LightsManager._start_ms
+
+    def test_fill_any_length(self):
+        for n in (1, 2, 3, 5, 8, 13):
+            buf = bytearray(3 * n)
+            fill(buf, b"\x01\x02\x03")
+            self.assertEqual(bytes(buf), b"\x01\x02\x03" * n)
+
+    def test_encode_uses_wire_order(self):
+        self.assertEqual(bytes(encode((10, 20, 30), 2, (1, 0, 2))), _grb(10, 20, 30) * 2)
+        self.assertEqual(bytes(encode([(1, 2, 3)], 2, (0, 1, 2))), b"\x01\x02\x03\x00\x00\x00")
+
+    def test_frames_go_through_driver_buffer(self):
+        t0 = self._play(Fade((0, 0, 0), (200, 100, 50), 1000))
+        self.assertIs(LightsManager._frame, LightsManager._neopixel.buf)
+        LightsManager.step(t0 + 1000)
+        self.assertEqual(self.frames[-1], _grb(200, 100, 50) * 5)
+        self.assertEqual(LightsManager._neopixel[4], (200, 100, 50))
+        self.assertFalse(LightsManager.is_playing())
+
+    def test_fade_midpoint(self):
+        t0 = self._play(Fade((0, 0, 0), (200, 100, 50), 1000))
+        self.assertEqual(self.frames[0], bytes(15))
+        LightsManager.step(t0 + 500)
+        self.assertEqual(self.frames[-1], _grb(100, 50, 25) * 5)
+        self.assertTrue(LightsManager.is_playing())
+
+    def test_breathe_peaks_and_skips_unchanged_frames(self):
+        t0 = self._play(Breathe((0, 0, 255), period_ms=1000, cycles=1))
+        self.assertEqual(self.frames[0], bytes(15))
+        LightsManager.step(t0 + 500)
+        self.assertEqual(self.frames[-1], _grb(0, 0, 255) * 5)
+        writes = LightsManager._neopixel.write_count
+        LightsManager.step(t0 + 500)
+        self.assertEqual(LightsManager._neopixel.write_count, writes)
+        LightsManager.step(t0 + 1000)
+        self.assertEqual(self.frames[-1], bytes(15))
+        self.assertFalse(LightsManager.is_playing())
+
+    def test_chase_moves_band(self):
+        red = _grb(255, 0, 0)
+        off = bytes(3)
+        t0 = self._play(Chase((255, 0, 0), step_ms=100, width=2))
+        self.assertEqual(self.frames[0], red * 2 + off * 3)
+        LightsManager.step(t0 + 100)
+        self.assertEqual(self.frames[-1], off + red * 2 + off * 2)
+        LightsManager.step(t0 + 400)
+        self.assertEqual(self.frames[-1], red + off * 3 + red)
+        LightsManager.step(t0 + 500)
+        self.assertEqual(self.frames[-1], red * 2 + off * 3)
+
+    def test_chase_reverse_with_tail(self):
+        t0 = self._play(Chase((0, 255, 0), step_ms=10, tail=1, reverse=True))
+        self.assertEqual(self.frames[0], _grb(0, 255, 0) + bytes(9) + _grb(0, 127, 0))
+        LightsManager.step(t0 + 10)
+        self.assertEqual(self.frames[-1], bytes(9) + _grb(0, 127, 0) + _grb(0, 255, 0))
+
+    def test_keyframes_loop(self):
+        frames = [((255, 0, 0), 100), ([(0, 0, 255), (0, 255, 0)], 50)]
+        t0 = self._play(Keyframes(frames))
+        self.assertEqual(self.frames[0], _grb(255, 0, 0) * 5)
+        LightsManager.step(t0 + 99)
+        self.assertEqual(len(self.frames), 1)
+        LightsManager.step(t0 + 120)
+        self.assertEqual(self.frames[-1], _grb(0, 0, 255) + _grb(0, 255, 0) + bytes(9))
+        LightsManager.step(t0 + 160)
+        self.assertEqual(self.frames[-1], _grb(255, 0, 0) * 5)
+        self.assertTrue(LightsManager.is_playing())
+
+    def test_keyframes_once(self):
+        t0 = self._play(Keyframes([((1, 2, 3), 10), ((4, 5, 6), 10)], loop=False))
+        LightsManager.step(t0 + 50)
+        self.assertEqual(self.frames[-1], _grb(4, 5, 6) * 5)
+        self.assertFalse(LightsManager.is_playing())
+
+    def test_play_without_leds(self):
+        LightsManager._neopixel = None
+        self.assertFalse(LightsManager.play(Fade((0, 0, 0), (1, 1, 1), 10), start=False))
+        self.assertFalse(LightsManager.is_playing())
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -133,3 +133,46 @@ class TestLoggingLevels(unittest.TestCase):
         self.assertTrue("info message" not in output)
         self.assertTrue("warning message" in output)
 
+
+
+class TestLazyArguments(unittest.TestCase):
+    """Test that logging.Lazy defers work until a record is emitted."""
+
+    def test_lazy_not_evaluated_when_level_disabled(self):
+        """A Lazy argument is never called for a filtered-out record."""
+        stream = io.StringIO()
+        logging.basicConfig(stream=stream, level=logging.WARNING, force=True)
+        logger = logging.getLogger("test_lazy_off")
+        calls = []
+
+        def expensive():
+            calls.append(1)
+            return "expensive"
+
+        logger.debug("value: %s", logging.Lazy(expensive))
+
+        self.assertEqual(calls, [])
+        self.assertTrue("expensive" not in stream.getvalue())
+
+    def test_lazy_evaluated_when_level_enabled(self):
+        """A Lazy argument is called once and formatted when emitted."""
+        stream = io.StringIO()
+        logging.basicConfig(stream=stream, level=logging.WARNING, force=True)
+        logger = logging.getLogger("test_lazy_on")
+        logger.setLevel(logging.DEBUG)
+        calls = []
+
+        def expensive(a, b):
+            calls.append(1)
+            return a + b
+
+        logger.debug("sum: %s", logging.Lazy(expensive, 2, 3))
+
+        self.assertEqual(len(calls), 1)
+        self.assertTrue("sum: 5" in stream.getvalue())
+
+    def test_preview_truncates_before_stringifying(self):
+        """preview() cuts the payload to the limit."""
+        self.assertEqual(logging.preview("abcdef", 3), "abc")
+        self.assertEqual(logging.preview("ab", 3), "ab")
+        self.assertEqual(logging.preview(b"abcdef", 2), str(b"ab"))
@@ -0,0 +1,111 @@
+"""
+Unit tests for the streaming NMEA parser (mpos.nmea).
+
+Feeds a short recorded receiver log as raw bytes, whole and in arbitrary
+chunks, and checks the decoded GPSFix fields.
+
+Usage:
+"""
+
+import sys
+import unittest
+
+sys.path.insert(0, '../internal_filesystem/lib')
+
+from mpos.nmea import NMEAStream, GPSFix
+
+LOG = (
+    b"garbage before the first sentence\r\n"
+    b"$GPRMC,123519,A,4807.038,N,01131.000,E,022.4,084.4,230394,003.1,W*6A\r\n"
+    b"$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47\r\n"
+    b"$GPGSA,A,3,04,05,,09,12,,,24,,,,,2.5,1.3,2.1*39\r\n"
+    b"$GPGSV,2,1,08,01,40,083,46,02,17,308,41,12,07,344,39,14,22,228,45*75\r\n"
+    b"$GPGLL,4916.45,N,12311.12,W,225444,A,*1D\r\n"
+)
+
+
+class TestNMEAStream(unittest.TestCase):
+
+    def _parse(self, chunk_sizes=None):
+        stream = NMEAStream()
+        if chunk_sizes is None:
+            stream.feed(LOG)
+        else:
+            pos = 0
+            k = 0
+            while pos < len(LOG):
+                size = chunk_sizes[k % len(chunk_sizes)]
+                stream.feed(LOG[pos:pos + size])
+                pos += size
+                k += 1
+        return stream.fix
+
+    def test_rmc_gga_decoded(self):
+        stream = NMEAStream()
+        stream.feed(LOG[:LOG.index(b"$GPGSA")])
+        fix = stream.fix
+        self.assertTrue(fix.valid)
+        self.assertEqual((fix.hour, fix.minute, fix.second), (12, 35, 19))
+        self.assertEqual((fix.year % 100, fix.month, fix.day), (94, 3, 23))
+        self.assertEqual(fix.lat_e6, 48117300)
+        self.assertEqual(fix.lon_e6, 11516667)
+        self.assertEqual(fix.speed_ckn, 2240)
+        self.assertEqual(fix.course_ddeg, 844)
+        self.assertEqual(fix.quality, 1)
+        self.assertEqual(fix.sats_used, 8)
+        self.assertEqual(fix.hdop_c, 90)
+        self.assertEqual(fix.alt_dm, 5454)
+        self.assertAlmostEqual(fix.speed_kmh, 22.4 * 1.852, delta=0.001)
+
+    def test_gsa_and_gll_decoded(self):
+        fix = self._parse()
+        self.assertEqual(fix.gsa_mode, ord("A"))
+        self.assertEqual(fix.gsa_fix_type, 3)
+        self.assertEqual((fix.gsa_pdop_c, fix.gsa_hdop_c, fix.gsa_vdop_c), (250, 130, 210))
+        # GLL came last: western hemisphere position
+        self.assertEqual(fix.lat_e6, 49274167)
+        self.assertEqual(fix.lon_e6, -123185333)
+        self.assertEqual(fix.gll_status, ord("A"))
+        self.assertEqual(fix.sentences, 5)
+        self.assertEqual(fix.errors, 0)
+
+    def test_satellites_in_view(self):
+        fix = self._parse()
+        self.assertEqual(fix.gsv_total, 8)
+        self.assertEqual(fix.sat_count, 4)
+        prns = [fix.sat_id[k] & 0xFF for k in range(fix.sat_count)]
+        self.assertEqual(prns, [1, 2, 12, 14])
+        self.assertEqual((fix.sat_el[2], fix.sat_az[2], fix.sat_snr[2]), (7, 344, 39))
+
+    def test_chunking_does_not_matter(self):
+        whole = self._parse()
+        for sizes in ([1], [3, 7], [64], [5, 50, 2]):
+            fix = self._parse(sizes)
+            self.assertEqual(fix.lat_e6, whole.lat_e6)
+            self.assertEqual(fix.sat_count, whole.sat_count)
+            self.assertEqual(fix.sentences, whole.sentences)
+
+    def test_feed_with_length(self):
+        buf = bytearray(256)
+        line = LOG[LOG.index(b"$GPGGA"):LOG.index(b"$GPGSA")]
+        buf[:len(line)] = line
+        stream = NMEAStream()
+        stream.feed(buf, len(line))
+        self.assertEqual(stream.fix.alt_dm, 5454)
+
+    def test_bad_checksum_rejected(self):
+        stream = NMEAStream()
+        stream.feed(b"$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*48\r\n")
+        self.assertEqual(stream.fix.errors, 1)
+        self.assertEqual(stream.fix.sentences, 0)
+        self.assertIsNone(stream.fix.lat_e6)
+
+    def test_satellite_table_is_bounded(self):
+        fix = GPSFix(max_sats=2)
+        stream = NMEAStream(fix)
+        stream.feed(LOG)
+        self.assertEqual(fix.sat_count, 2)
+
+
+if __name__ == "__main__":
+    unittest.main()
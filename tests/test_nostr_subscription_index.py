@@ -0,0 +1,133 @@
+"""Unit tests for indexed subscription routing in NostrManager.
+
+SubscriptionIndex must hand _process_event every subscription whose filters
+match an event (and as few others as possible), and the manager must keep
+only a bounded window of recent events. Uses synthetic events, no relays.
+"""
+
+import random
+import sys
+import unittest
+
+sys.path.append("apps")
+
+from nostr.filter import Filter, Filters
+from com_micropythonos_nostr.nostr_service import NostrManager, NostrSubscription
+from com_micropythonos_nostr.subscription_index import SubscriptionIndex
+
+
+class _FakeEvent:
+    """Minimal stand-in for a nostr.event.Event."""
+
+    def __init__(self, pubkey, kind, tags=None, created_at=1700000000):
+        self.id = "%064x" % random.getrandbits(64)
+        self.public_key = pubkey
+        self.created_at = created_at
+        self.kind = kind
+        self.content = "hello"
+        self.tags = tags or []
+
+
+def _hex(n):
+    return "%064x" % n
+
+
+def _cb(event):
+    pass
+
+
+class TestSubscriptionIndex(unittest.TestCase):
+
+    def setUp(self):
+        self.channel = NostrSubscription(
+            "channel", Filters([Filter(kinds=[42], event_refs=[_hex(1)])]), _cb)
+        self.dms = NostrSubscription(
+            "dms", Filters([Filter(kinds=[4], pubkey_refs=[_hex(2)])]), _cb)
+        self.follows = NostrSubscription(
+            "follows", Filters([Filter(kinds=[1], authors=[_hex(10 + i) for i in range(500)])]), _cb)
+        self.metadata = NostrSubscription(
+            "metadata", Filters([Filter(kinds=[0])]), _cb)
+        self.subs = [self.channel, self.dms, self.follows, self.metadata]
+        self.index = SubscriptionIndex(self.subs)
+
+    def test_tag_indexed_subscription_found(self):
+        event = _FakeEvent(_hex(9999), 42, [["e", _hex(1), "", "root"]])
+        self.assertEqual(self.index.candidates(event), [self.channel])
+
+    def test_pubkey_ref_subscription_found(self):
+        event = _FakeEvent(_hex(9999), 4, [["p", _hex(2)]])
+        self.assertEqual(self.index.candidates(event), [self.dms])
+
+    def test_author_lookup_in_large_follow_list(self):
+        event = _FakeEvent(_hex(321), 1)
+        self.assertEqual(self.index.candidates(event), [self.follows])
+
+    def test_kind_only_subscription_found(self):
+        event = _FakeEvent(_hex(9999), 0)
+        self.assertEqual(self.index.candidates(event), [self.metadata])
+
+    def test_unrelated_event_has_no_candidates(self):
+        event = _FakeEvent(_hex(9999), 7, [["p", _hex(3)]])
+        self.assertEqual(self.index.candidates(event), [])
+
+    def test_catch_all_filter_always_candidate(self):
+        everything = NostrSubscription("all", Filters([Filter(limit=10)]), _cb)
+        index = SubscriptionIndex(self.subs + [everything])
+        event = _FakeEvent(_hex(9999), 7)
+        self.assertEqual(index.candidates(event), [everything])
+
+    def test_subscription_without_callback_skipped(self):
+        silent = NostrSubscription("silent", Filters([Filter(kinds=[7])]))
+        index = SubscriptionIndex([silent])
+        self.assertEqual(index.candidates(_FakeEvent(_hex(9999), 7)), [])
+
+    def test_matches_linear_scan_on_synthetic_events(self):
+        random.seed(1234)
+        for _ in range(300):
+            tags = []
+            if random.getrandbits(1):
+                tags.append(["e", _hex(random.getrandbits(1) + 1)])
+            if random.getrandbits(1):
+                tags.append(["p", _hex(random.getrandbits(2))])
+            event = _FakeEvent(_hex(5 + random.getrandbits(4)), (0, 1, 4, 42)[random.getrandbits(2)], tags)
+            expected = [s for s in self.subs if s.filters.match(event)]
+            got = [s for s in self.index.candidates(event) if s.filters.match(event)]
+            self.assertEqual(got, expected)
+
+
+class TestNostrManagerRouting(unittest.TestCase):
+
+    def setUp(self):
+        mgr = NostrManager.get_instance()
+        mgr._subscriptions = []
+        mgr._subscription_ids = {}
+        mgr._subscription_index = None
+        mgr._event_handlers = {}
+        mgr._post_event_handlers = {}
+        mgr._events_updated_cb = None
+        mgr._nwc_configured = False
+        mgr._nostr_private_key = None
+        mgr.connected = False
+        mgr.relay_manager = None
+        self.mgr = mgr
+
+    def test_add_and_close_subscription_update_routing(self):
+        received = []
+        self.mgr.add_subscription(
+            "profile", Filters([Filter(kinds=[0], authors=[_hex(7)])]), received.append)
+        self.mgr._process_event(_FakeEvent(_hex(7), 0))
+        self.mgr._process_event(_FakeEvent(_hex(8), 0))
+        self.assertEqual(len(received), 1)
+
+        self.mgr.close_subscription("profile")
+        self.mgr._process_event(_FakeEvent(_hex(7), 0))
+        self.assertEqual(len(received), 1)
+
+    def test_event_window_is_bounded(self):
+        for i in range(NostrManager.EVENTS_TO_SHOW + 20):
+            self.mgr._process_event(_FakeEvent(_hex(i), 1))
+        self.assertEqual(len(self.mgr.events), NostrManager.EVENTS_TO_SHOW)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -48,6 +48,22 @@ class _FakePrefs:
         return _FakeEditor(self)
 
 
+class _FakeJournal:
+    def __init__(self, records=None):
+        self.records = list(records or [])
+        self.appends = 0
+
+    def append(self, records):
+        self.records.extend(records)
+        self.appends += 1
+
+    def read(self):
+        return list(self.records)
+
+    def clear(self):
+        self.records = []
+
+
 class _FakeOutput:
     def __init__(self, kind):
         self.kind = kind
@@ -78,6 +94,8 @@ class TestNotificationManager(unittest.TestCase):
         self.fake_prefs = _FakePrefs({"notifications": []})
         NotificationManager._reset_for_tests(clear_storage=False)
         NotificationManager._prefs = self.fake_prefs
+        self.fake_journal = _FakeJournal()
+        NotificationManager._journal = self.fake_journal
         NotificationManager._settings_prefs = _FakePrefs({"notification_sound": DEFAULT_NOTIFICATION_SOUND})
         self._orig_audio_manager = sys.modules["mpos.notification_manager"].AudioManager
         sys.modules["mpos.notification_manager"].AudioManager = _FakeAudioManager
@@ -221,6 +239,83 @@ class TestNotificationManager(unittest.TestCase):
         finally:
             AppManager.start_app = old_start_app
 
+    def test_journal_records_changes_and_replays_on_boot(self):
+        self.fake_prefs.data = {
+            "notifications": [
+                {"notification_id": "snap.one", "title": "Snap", "created_at": 1, "updated_at": 1},
+                {"notification_id": "snap.two", "title": "Gone", "created_at": 1, "updated_at": 1},
+            ]
+        }
+        NotificationManager.notify(Notification(notification_id="new.one", title="New"))
+        NotificationManager.cancel("snap.two")
+        ops = [r[0] for r in self.fake_journal.records]
+        self.assertEqual(ops, ["put", "del"])
+        # Appending never rewrites the snapshot
+        self.assertEqual(len(self.fake_prefs.data["notifications"]), 2)
+
+        NotificationManager._initialized = False
+        ids = [n.notification_id for n in NotificationManager.get_notifications()]
+        self.assertEqual(sorted(ids), ["new.one", "snap.one"])
+
+    def test_journal_is_compacted_into_snapshot(self):
+        for i in range(NotificationManager._COMPACT_AFTER):
+            NotificationManager.notify(Notification(notification_id="c." + str(i), title="C"))
+            NotificationManager.cancel("c." + str(i))
+        self.assertEqual(NotificationManager._compact_count, 1)
+        self.assertTrue(len(self.fake_journal.records) < NotificationManager._COMPACT_AFTER)
+
+        NotificationManager.notify(Notification(notification_id="kept", title="Kept"))
+        NotificationManager._initialized = False
+        ids = [n.notification_id for n in NotificationManager.get_notifications()]
+        self.assertEqual(ids, ["kept"])
+
+    def test_post_cost_does_not_grow_with_history(self):
+        for i in range(200):
+            writes = NotificationManager._persist_write_count
+            NotificationManager.notify(Notification(notification_id="h." + str(i), title="H"))
+            # One write per post: a journal append, or now and then a compaction
+            self.assertEqual(NotificationManager._persist_write_count - writes, 1)
+            self.assertTrue(len(self.fake_journal.records) <= NotificationManager._COMPACT_AFTER)
+        self.assertTrue(NotificationManager._compact_count > 0)
+        self.assertTrue(len(self.fake_prefs.data["notifications"]) <= NotificationManager._MAX_NOTIFICATIONS)
+        self.assertEqual(len(NotificationManager.get_notifications()), NotificationManager._MAX_NOTIFICATIONS)
+
+    def test_delta_listener_gets_changes(self):
+        changes = []
+        plain = []
+        NotificationManager.notify(Notification(notification_id="a", title="A", priority=Notification.PRIORITY_HIGH))
+        NotificationManager.register_listener(
+            lambda change, n, index: changes.append((change, n.notification_id, index)), deltas=True
+        )
+        NotificationManager.register_listener(lambda: plain.append(1), notify_immediately=False)
+        self.assertEqual(changes, [(NotificationManager.ADDED, "a", 0)])
+
+        NotificationManager.notify(Notification(notification_id="b", title="B", priority=Notification.PRIORITY_LOW))
+        NotificationManager.notify(Notification(notification_id="a", title="A2", priority=Notification.PRIORITY_HIGH))
+        NotificationManager.cancel("b")
+        self.assertEqual(changes[1:], [
+            (NotificationManager.ADDED, "b", 1),
+            (NotificationManager.UPDATED, "a", 0),
+            (NotificationManager.REMOVED, "b", 1),
+        ])
+        self.assertEqual(len(plain), 3)
+
+        NotificationManager.cancel_all()
+        self.assertEqual(changes[-1], (NotificationManager.REMOVED, "a", 0))
+        self.assertIsNone(NotificationManager.get_top_notification())
+
+    def test_trim_reports_evicted_notification(self):
+        removed = []
+        NotificationManager.register_listener(
+            lambda change, n, index: change == NotificationManager.REMOVED and removed.append(n.notification_id),
+            deltas=True,
+        )
+        NotificationManager.notify(Notification(notification_id="low", title="Low", priority=Notification.PRIORITY_MIN))
+        for i in range(NotificationManager._MAX_NOTIFICATIONS):
+            NotificationManager.notify(Notification(notification_id="n." + str(i), title="N"))
+        self.assertEqual(removed, ["low"])
+        self.assertIsNone(NotificationManager.get_notification("low"))
+
     def test_notification_sound_defaults_to_coin(self):
         self._set_outputs(_FakeOutput("buzzer"))
         NotificationManager.notify(Notification(notification_id="sound.default", title="Default"))
@@ -0,0 +1,100 @@
+"""
+Unit tests for Emoji Sort's packed solver and level generator (sorter_levels.py).
+
+Checks that:
+- Solutions found by the packed solver actually solve the level
+- Interchangeable tubes are deduplicated and the shortest path is found
+- Seeded generation is deterministic, whether run at once or in small steps
+- step() stays within its state budget
+
+Usage:
+"""
+
+import sys
+import unittest
+
+sys.path.append("apps/com.micropythonos.sorter")
+
+from sorter_levels import (LevelGenerator, Solver, apply_move, can_move, generate_level,
+                           is_solved, make_lcg, solve_path)
+
+
+def _play(tubes, capacity, moves):
+    tubes = [list(t) for t in tubes]
+    for src, tgt in moves:
+        if not can_move(tubes[src], tubes[tgt], capacity):
+            return None
+        apply_move(tubes[src], tubes[tgt], capacity)
+    return tubes
+
+
+class TestSolver(unittest.TestCase):
+
+    def test_already_solved(self):
+        self.assertEqual(solve_path([[0, 0], [1, 1], []], 2, 1000), [])
+
+    def test_two_moves(self):
+        tubes = [[0, 0], [1, 1, 0], [1]]
+        moves = solve_path(tubes, 3, 1000)
+        self.assertEqual(len(moves), 2)
+        self.assertTrue(is_solved(_play(tubes, 3, moves)))
+
+    def test_solution_solves_level(self):
+        tubes = [[0, 1, 2], [2, 0, 1], [1, 2, 0], [], []]
+        moves = solve_path(tubes, 3, 10000)
+        self.assertTrue(len(moves) > 0)
+        self.assertTrue(is_solved(_play(tubes, 3, moves)))
+
+    def test_shortest_path(self):
+        # Park one ball, stack the other color, then fetch the parked ball
+        tubes = [[0, 1], [1, 0], []]
+        moves = solve_path(tubes, 2, 10000)
+        self.assertEqual(len(moves), 3)
+        self.assertTrue(is_solved(_play(tubes, 2, moves)))
+
+    def test_unsolvable_within_budget(self):
+        # No spare room at all: nothing can move
+        self.assertEqual(solve_path([[0, 1], [1, 0]], 2, 1000), [])
+
+    def test_step_respects_budget(self):
+        tubes = [[0, 1, 2, 3], [3, 2, 1, 0], [1, 3, 0, 2], [2, 0, 3, 1], [], []]
+        solver = Solver(tubes, 4, 20000)
+        steps = 0
+        while not solver.done:
+            self.assertTrue(solver.step(10) <= 10)
+            steps += 1
+        self.assertTrue(steps > 1)
+        self.assertTrue(is_solved(_play(tubes, 4, solver.path)))
+
+
+class TestLevelGenerator(unittest.TestCase):
+
+    def test_seeded_generation_is_deterministic(self):
+        a = generate_level(4, 4, 2, make_lcg(1234))
+        b = generate_level(4, 4, 2, make_lcg(1234))
+        self.assertEqual(a, b)
+        tubes, moves = a
+        self.assertEqual(len(tubes), 6)
+        self.assertTrue(len(moves) > 0)
+        self.assertTrue(is_solved(_play(tubes, 4, moves)))
+
+    def test_stepped_matches_blocking(self):
+        for seed in (7, 99, 2024):
+            expected = generate_level(5, 4, 1, make_lcg(seed))
+            gen = LevelGenerator(5, 4, 1, make_lcg(seed))
+            while not gen.step(50):
+                pass
+            self.assertEqual((gen.tubes, gen.solution), expected)
+
+    def test_progress_reports_attempts(self):
+        attempts = []
+        generate_level(3, 3, 2, make_lcg(5), progress_cb=attempts.append)
+        self.assertEqual(attempts, list(range(1, len(attempts) + 1)))
+
+    def test_too_many_colors(self):
+        with self.assertRaises(ValueError):
+            LevelGenerator(8, 4, 2, make_lcg(1))
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,108 @@
+"""
+Unit tests for StatusService, the push-based source of top bar values.
+
+Widgets subscribe to keys and must only be called (and so only redraw) when
+a value really changes, however often a source is sampled.
+
+Usage:
+    python3 scripts/test_runner.py tests/test_status_service.py
+"""
+
+import unittest
+
+from mpos import StatusService
+
+
+class _Label:
+    """Counts redraws the way an lv.label would cause them."""
+
+    def __init__(self):
+        self.text = None
+        self.redraws = 0
+
+    def set_text(self, text):
+        self.text = text
+        self.redraws += 1
+
+
+class TestStatusService(unittest.TestCase):
+
+    def setUp(self):
+        # The running top bar uses StatusService too: swap its state out
+        S = StatusService
+        self._saved = (S._values, S._listeners, S._pollers, S._clock_timer, S._clock_seconds)
+        S._values, S._listeners, S._pollers, S._clock_timer = {}, {}, {}, None
+
+    def tearDown(self):
+        S = StatusService
+        for key in list(S._pollers):
+            S.remove_poller(key)
+        if S._clock_timer is not None:
+            S._clock_timer.delete()
+        S._values, S._listeners, S._pollers, S._clock_timer, S._clock_seconds = self._saved
+
+    def test_publish_notifies_only_on_change(self):
+        seen = []
+        StatusService.subscribe(StatusService.WIFI, seen.append)
+        self.assertTrue(StatusService.publish(StatusService.WIFI, True))
+        self.assertFalse(StatusService.publish(StatusService.WIFI, True))
+        self.assertTrue(StatusService.publish(StatusService.WIFI, False))
+        self.assertEqual(seen, [True, False])
+        self.assertEqual(StatusService.get(StatusService.WIFI), False)
+
+    def test_subscribe_gets_current_value(self):
+        StatusService.publish(StatusService.BATTERY, 77)
+        seen = []
+        StatusService.subscribe(StatusService.BATTERY, seen.append)
+        StatusService.subscribe(StatusService.TEMPERATURE, seen.append)
+        self.assertEqual(seen, [77])
+        StatusService.unsubscribe(StatusService.BATTERY, seen.append)
+        StatusService.publish(StatusService.BATTERY, 76)
+        self.assertEqual(seen, [77])
+
+    def test_idle_polled_source_causes_no_redraws(self):
+        label = _Label()
+        readings = [21, 21, 21, 22, 22, 21] + [21] * 54
+        reads = []
+
+        def read():
+            reads.append(1)
+            return readings[len(reads) - 1]
+
+        StatusService.subscribe(StatusService.TEMPERATURE, lambda t: label.set_text("%d°C" % t))
+        StatusService.add_poller(StatusService.TEMPERATURE, read, 2000)
+        for _ in range(len(readings) - 1):
+            StatusService.poll(StatusService.TEMPERATURE)
+        self.assertEqual(len(reads), 60)
+        self.assertEqual(label.redraws, 3)
+        self.assertEqual(label.text, "21°C")
+
+    def test_failing_source_keeps_last_value(self):
+        def read():
+            raise OSError(5, "EIO")
+        StatusService.publish(StatusService.TEMPERATURE, 30)
+        StatusService.add_poller(StatusService.TEMPERATURE, read, 2000)
+        self.assertFalse(StatusService.poll(StatusService.TEMPERATURE))
+        self.assertEqual(StatusService.get(StatusService.TEMPERATURE), 30)
+
+    def test_clock_wakes_on_boundaries(self):
+        delay = StatusService.clock_delay_ms
+        self.assertEqual(delay(10, 0), 1005)
+        self.assertEqual(delay(10, 999), 6)
+        self.assertEqual(delay(10, 250), 755)
+        self.assertEqual(delay(0, 0, seconds=False), 60005)
+        self.assertEqual(delay(59, 500, seconds=False), 505)
+        self.assertEqual(delay(30, 400, seconds=False), 29605)
+
+    def test_clock_publishes_time(self):
+        seen = []
+        StatusService.subscribe(StatusService.CLOCK, seen.append)
+        StatusService.start_clock()
+        self.assertEqual(len(seen), 1)
+        self.assertEqual(len(seen[0]), 3)
+        StatusService.set_clock_seconds(False)
+        self.assertTrue(len(seen) <= 2)
+
+
+if __name__ == "__main__":
+    unittest.main()
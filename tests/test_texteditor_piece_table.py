@@ -0,0 +1,153 @@
+"""
+Unit tests for the text editor's PieceTable (text_buffer.py).
+
+Uses a generated multi-hundred-kilobyte fixture file to check that reads,
+edits, windowing and saving work without loading the file as a whole.
+
+Usage:
+"""
+
+import os
+import sys
+import unittest
+
+sys.path.append("apps/com.micropythonos.texteditor")
+
+import text_buffer
+from text_buffer import PieceTable
+
+PATH = "data/tmp_text_buffer_test.txt"
+LINES = 8000
+
+
+def _line(i):
+    return "line %05d: the quick brown fox éè jumps\n" % i
+
+
+class TestPieceTable(unittest.TestCase):
+
+    @classmethod
+    def setUpClass(cls):
+        try:
+            os.mkdir("data")
+        except OSError:
+            pass
+        with open(PATH, "w") as f:
+            for i in range(LINES):
+                f.write(_line(i))
+        cls.size = os.stat(PATH)[6]
+
+    @classmethod
+    def tearDownClass(cls):
+        for path in (PATH, PATH + ".tmp", PATH + ".bak"):
+            try:
+                os.remove(path)
+            except OSError:
+                pass
+
+    def setUp(self):
+        self.doc = PieceTable(PATH)
+
+    def tearDown(self):
+        self.doc.close()
+
+    def test_large_file_not_loaded(self):
+        self.assertTrue(self.size > 300000)
+        self.assertEqual(self.doc.length, self.size)
+        self.assertEqual(len(self.doc._add), 0)
+        line_len = len(_line(0).encode())
+        self.assertEqual(self.doc.read(line_len * 100, line_len).decode(), _line(100))
+
+    def test_replace_and_dirty(self):
+        self.assertFalse(self.doc.dirty)
+        line_len = len(_line(0).encode())
+        self.doc.replace(line_len * 5, line_len, b"X\n")
+        self.assertTrue(self.doc.dirty)
+        self.assertEqual(self.doc.length, self.size - line_len + 2)
+        self.assertEqual(self.doc.read(line_len * 5 - 3, 5 + line_len).decode(),
+                         "ps\n" + "X\n" + _line(6))
+        # Insert and delete spanning piece boundaries
+        self.doc.replace(0, 0, b"head\n")
+        self.doc.replace(line_len * 5, line_len + 7, b"")
+        self.assertEqual(self.doc.read(0, 5), b"head\n")
+
+    def test_windows_cut_at_lines(self):
+        doc = self.doc
+        start = 0
+        count = 0
+        while start < doc.length:
+            end = doc.window_end(start, 8192)
+            self.assertTrue(end > start)
+            data = doc.read(start, end - start)
+            data.decode()  # never splits a character
+            if end < doc.length:
+                self.assertEqual(data[-1:], b"\n")
+            start = end
+            count += 1
+        self.assertTrue(count > 30)
+        self.assertEqual(doc.line_start_before(1000, 4096), 1000 - 1000 % len(_line(0).encode()))
+
+    def test_window_commits_store_only_edits(self):
+        doc = self.doc
+        start = 0
+        for i in range(40):
+            end = doc.window_end(start, 8192)
+            window = bytearray(doc.read(start, end - start))
+            window[100] = 0x30 + i
+            doc.replace_changed(start, end - start, bytes(window))
+            start = end // 2
+        self.assertEqual(len(doc._add), 40)
+        # An unchanged commit writes nothing
+        revision = doc.revision
+        doc.replace_changed(0, 8192, doc.read(0, 8192))
+        self.assertEqual(doc.revision, revision)
+        # Pure insertion and deletion
+        doc.replace_changed(0, 10, doc.read(0, 5) + b"new" + doc.read(5, 5))
+        self.assertEqual(len(doc._add), 43)
+        self.assertEqual(doc.read(5, 3), b"new")
+        length = doc.length
+        doc.replace_changed(0, 10, doc.read(0, 4) + doc.read(6, 4))
+        self.assertEqual(doc.length, length - 2)
+        self.assertEqual(len(doc._add), 43)
+
+    def test_failed_save_keeps_original(self):
+        """If the new copy can't be moved into place the original is restored."""
+        line_len = len(_line(0).encode())
+        self.doc.replace(0, line_len, b"first\n")
+
+        class FailingOS:
+            def __getattr__(self, name):
+                return getattr(os, name)
+
+            def rename(self, src, dst):
+                if src.endswith(".tmp"):
+                    raise OSError(28)
+                os.rename(src, dst)
+
+        text_buffer.os = FailingOS()
+        try:
+            with self.assertRaises(OSError):
+                self.doc.save(PATH)
+        finally:
+            text_buffer.os = os
+        self.assertTrue(self.doc.dirty)
+        self.assertEqual(os.stat(PATH)[6], self.size)
+        with open(PATH) as f:
+            self.assertEqual(f.readline(), _line(0))
+        self.assertEqual(self.doc.read(0, line_len + 6), b"first\n" + _line(1).encode())
+
+    def test_save_streams_edits(self):
+        line_len = len(_line(0).encode())
+        self.doc.replace(line_len * (LINES - 1), line_len, b"last\n")
+        self.doc.replace(0, line_len, b"")
+        self.doc.save(PATH)
+        self.assertFalse(self.doc.dirty)
+        self.assertEqual(self.doc.length, self.size - 2 * line_len + 5)
+        with open(PATH) as f:
+            self.assertEqual(f.readline(), _line(1))
+        self.assertEqual(self.doc.read(self.doc.length - 5, 5), b"last\n")
+        self.assertEqual(len(self.doc._add), 0)
+
+
+if __name__ == "__main__":
+    unittest.main()
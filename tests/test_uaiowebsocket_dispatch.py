@@ -0,0 +1,80 @@
+"""test_uaiowebsocket_dispatch.py - Unit tests for event-driven callback dispatch.
+
+Verifies that WebSocketApp runs queued callbacks as soon as the dispatcher
+task is woken (no polling delay), that each connection has its own bounded
+queue, and that the receive-loop backpressure helper returns once drained.
+
+Network-free: drives the dispatcher directly, no sockets are opened.
+
+Usage:
+"""
+
+import sys
+import time
+import unittest
+
+import asyncio
+
+sys.path.insert(0, '../internal_filesystem/lib')
+
+from uaiowebsocket import WebSocketApp, _CALLBACK_QUEUE_MAX
+
+
+class TestCallbackDispatch(unittest.TestCase):
+
+    async def _run_wakeup(self):
+        ws = WebSocketApp("ws://127.0.0.1:1")
+        seen = []
+        task = asyncio.create_task(ws._process_callbacks_async())
+        await asyncio.sleep(0)
+        start = time.ticks_ms()
+        ws._run_callback(lambda app, value: seen.append(value), ws, "hello")
+        for _ in range(5):
+            if seen:
+                break
+            await asyncio.sleep(0)
+        elapsed = time.ticks_diff(time.ticks_ms(), start)
+        task.cancel()
+        return seen, elapsed
+
+    def test_callback_runs_without_polling_delay(self):
+        """A queued callback runs within a few scheduler passes, not 100 ms."""
+        seen, elapsed = asyncio.run(self._run_wakeup())
+        self.assertEqual(seen, ["hello"])
+        self.assertTrue(elapsed < 50)
+
+    def test_queues_are_per_connection(self):
+        """Filling one connection's queue does not affect another's."""
+        a = WebSocketApp("ws://127.0.0.1:1")
+        b = WebSocketApp("ws://127.0.0.1:2")
+        for i in range(_CALLBACK_QUEUE_MAX + 5):
+            a._run_callback(lambda app, value: None, a, i)
+        self.assertEqual(len(a._callback_queue), _CALLBACK_QUEUE_MAX)
+        self.assertEqual(len(b._callback_queue), 0)
+
+    def test_none_callback_is_not_queued(self):
+        """Unset callbacks (e.g. on_data=None) never reach the queue."""
+        ws = WebSocketApp("ws://127.0.0.1:1")
+        ws._run_callback(None, ws, "ignored")
+        self.assertEqual(len(ws._callback_queue), 0)
+
+    async def _run_backpressure(self):
+        ws = WebSocketApp("ws://127.0.0.1:1")
+        seen = []
+        for i in range(_CALLBACK_QUEUE_MAX):
+            ws._run_callback(lambda app, value: seen.append(value), ws, i)
+        task = asyncio.create_task(ws._process_callbacks_async())
+        await ws._wait_callbacks_drained()
+        remaining = len(ws._callback_queue)
+        task.cancel()
+        return seen, remaining
+
+    def test_backpressure_waits_for_drain(self):
+        """A full queue makes the receive loop wait until every callback ran."""
+        seen, remaining = asyncio.run(self._run_backpressure())
+        self.assertEqual(seen, list(range(_CALLBACK_QUEUE_MAX)))
+        self.assertEqual(remaining, 0)
+
+
+if __name__ == "__main__":
+    unittest.main()
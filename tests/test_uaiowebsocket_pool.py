@@ -0,0 +1,206 @@
+"""test_uaiowebsocket_pool.py - Unit tests for the shared websocket connection pool.
+
+Verifies that WebSocketPool staggers reconnects of its members, limits
+concurrent TLS handshakes, and shares one session and TLS context, and that
+the aiohttp websocket client skips messages over its memory budget. The
+shared session is closed once the last member stops.
+
+Network-free: uses an in-memory frame reader, no sockets are opened.
+
+Usage:
+"""
+
+import struct
+import sys
+import unittest
+
+import asyncio
+
+sys.path.insert(0, '../internal_filesystem/lib')
+
+import uaiowebsocket
+from uaiowebsocket import WebSocketApp, WebSocketPool, default_pool
+from aiohttp.aiohttp_ws import WebSocketClient
+
+
+class _BytesReader:
+    """Minimal stream reader serving readexactly() from a bytes buffer."""
+
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    async def readexactly(self, n):
+        chunk = self.data[self.pos:self.pos + n]
+        self.pos += n
+        return chunk
+
+
+def _text_frame(payload, fin=True):
+    header = bytes([(0x80 if fin else 0) | WebSocketClient.TEXT])
+    if len(payload) < 126:
+        return header + bytes([len(payload)]) + payload
+    return header + bytes([126]) + struct.pack("!H", len(payload)) + payload
+
+
+class TestReconnectStagger(unittest.TestCase):
+
+    def test_simultaneous_reconnects_are_spread(self):
+        """Members asking for the same delay get it stagger_ms apart."""
+        pool = WebSocketPool(stagger_ms=500)
+        delays = [pool.reconnect_delay(3) for _ in range(3)]
+        self.assertAlmostEqual(delays[0], 3, delta=0.05)
+        self.assertAlmostEqual(delays[1], 3.5, delta=0.05)
+        self.assertAlmostEqual(delays[2], 4, delta=0.05)
+
+    def test_distant_reconnects_keep_their_delay(self):
+        """A reconnect far from the previous one is not pushed back."""
+        pool = WebSocketPool(stagger_ms=500)
+        pool.reconnect_delay(3)
+        self.assertAlmostEqual(pool.reconnect_delay(60), 60, delta=0.05)
+
+    def test_short_reconnect_after_long_one_is_not_pushed(self):
+        """A long pending reconnect does not delay a sooner one."""
+        pool = WebSocketPool(stagger_ms=500)
+        self.assertAlmostEqual(pool.reconnect_delay(60), 60, delta=0.05)
+        self.assertAlmostEqual(pool.reconnect_delay(1), 1, delta=0.05)
+        self.assertAlmostEqual(pool.reconnect_delay(1), 1.5, delta=0.05)
+        self.assertAlmostEqual(pool.reconnect_delay(59.8), 60.5, delta=0.05)
+
+
+class TestHandshakeLimit(unittest.TestCase):
+
+    async def _run_limit(self):
+        pool = WebSocketPool(max_handshakes=2)
+        active = []
+        peak = [0]
+
+        async def connect():
+            await pool.acquire_handshake()
+            active.append(1)
+            peak[0] = max(peak[0], len(active))
+            await asyncio.sleep(0.01)
+            active.pop()
+            pool.release_handshake()
+
+        await asyncio.gather(*[connect() for _ in range(5)])
+        return peak[0], pool._handshakes
+
+    def test_at_most_max_handshakes_run_at_once(self):
+        """Five relays connecting together never exceed two handshakes."""
+        peak, remaining = asyncio.run(self._run_limit())
+        self.assertEqual(peak, 2)
+        self.assertEqual(remaining, 0)
+
+
+class _StalledConnection:
+    """ws_connect() context whose handshake never completes."""
+
+    def __init__(self):
+        self.closed = False
+
+    async def __aenter__(self):
+        await asyncio.sleep(10)
+
+    async def __aexit__(self, *args):
+        self.closed = True
+
+
+class _StalledSession:
+
+    def __init__(self):
+        self.connection = _StalledConnection()
+
+    def ws_connect(self, url, ssl=None, max_msg_size=0):
+        return self.connection
+
+
+class TestHandshakeTimeout(unittest.TestCase):
+
+    def test_timed_out_handshake_closes_connection(self):
+        """A stalled handshake is closed and gives back its slot."""
+        pool = WebSocketPool()
+        session = pool._session = _StalledSession()
+        app = WebSocketApp("ws://127.0.0.1:1", pool=pool)
+        saved = uaiowebsocket._HANDSHAKE_TIMEOUT_S
+        uaiowebsocket._HANDSHAKE_TIMEOUT_S = 0.05
+        try:
+            with self.assertRaises(asyncio.TimeoutError):
+                asyncio.run(app._connect_and_run())
+        finally:
+            uaiowebsocket._HANDSHAKE_TIMEOUT_S = saved
+        self.assertTrue(session.connection.closed)
+        self.assertEqual(pool._handshakes, 0)
+
+
+class TestSharedResources(unittest.TestCase):
+
+    def test_members_share_pool_session(self):
+        """Apps without custom headers join the default pool and its session."""
+        a = WebSocketApp("ws://127.0.0.1:1")
+        b = WebSocketApp("ws://127.0.0.1:2")
+        self.assertIs(a.pool, default_pool())
+        self.assertIs(b.pool, a.pool)
+        self.assertIs(a.pool.session(), b.pool.session())
+
+    def test_last_member_closes_session(self):
+        """The shared session lives while any member runs and is closed after."""
+        pool = WebSocketPool()
+        session = pool.session()
+        pool.join()
+        pool.join()
+        asyncio.run(pool.leave())
+        self.assertIs(pool._session, session)
+        asyncio.run(pool.leave())
+        self.assertIsNone(pool._session)
+        self.assertFalse(pool.session() is session)
+
+    def test_stopped_app_leaves_pool(self):
+        """An app whose main loop ends takes itself out of the pool."""
+        pool = WebSocketPool()
+        pool.session()
+        app = WebSocketApp("ws://127.0.0.1:1", pool=pool)
+        app.running = False
+        asyncio.run(app._async_main(reconnect=False))
+        self.assertEqual(pool._members, 0)
+        self.assertIsNone(pool._session)
+
+    def test_message_budget_defaults_to_pool(self):
+        """An app inherits the pool's budget unless it sets its own."""
+        pool = WebSocketPool(max_msg_size=1000)
+        self.assertEqual(WebSocketApp("ws://127.0.0.1:1", pool=pool).max_msg_size, 1000)
+        self.assertEqual(WebSocketApp("ws://127.0.0.1:1", pool=pool, max_msg_size=10).max_msg_size, 10)
+
+
+class TestMessageBudget(unittest.TestCase):
+
+    async def _receive_all(self, client, count):
+        return [await client.receive() for _ in range(count)]
+
+    def test_oversized_message_is_skipped(self):
+        """A frame over max_msg_size is discarded and the next one delivered."""
+        client = WebSocketClient({}, max_msg_size=100)
+        client.reader = _BytesReader(_text_frame(b"x" * 300) + _text_frame(b"hello"))
+        received = asyncio.run(self._receive_all(client, 1))
+        self.assertEqual(received, [(WebSocketClient.TEXT, "hello")])
+        self.assertEqual(client.dropped, 1)
+
+    def test_oversized_fragmented_message_is_skipped(self):
+        """Fragments adding up to more than the budget are dropped as a whole."""
+        client = WebSocketClient({}, max_msg_size=100)
+        fragments = _text_frame(b"y" * 80, fin=False) + bytes([0x80, 80]) + b"z" * 80
+        client.reader = _BytesReader(fragments + _text_frame(b"ok"))
+        received = asyncio.run(self._receive_all(client, 1))
+        self.assertEqual(received, [(WebSocketClient.TEXT, "ok")])
+        self.assertEqual(client.dropped, 1)
+
+    def test_unlimited_by_default(self):
+        """Without a budget large messages are delivered as before."""
+        client = WebSocketClient({})
+        client.reader = _BytesReader(_text_frame(b"x" * 300))
+        received = asyncio.run(self._receive_all(client, 1))
+        self.assertEqual(received, [(WebSocketClient.TEXT, "x" * 300)])
+
+
+if __name__ == "__main__":
+    unittest.main()
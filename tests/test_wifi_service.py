@@ -120,7 +120,7 @@ class TestWifiServiceAttemptConnecting(unittest.TestCase):
         self.assertEqual(len(mock_time.get_sleep_calls()), 0)
 
     def test_connection_timeout(self):
-        """Test connection timeout after 13 attempts."""
+        """Test connection timeout after 13 seconds."""
         mock_network = MockNetwork(connected=False)
         mock_time = MockTime()
 
@@ -140,8 +140,58 @@ class TestWifiServiceAttemptConnecting(unittest.TestCase):
         )
 
         self.assertFalse(result)
-        # Should have slept 13 times
-        self.assertEqual(len(mock_time.get_sleep_calls()), 13)
+        # Should have waited 13 seconds in short polling steps
+        self.assertAlmostEqual(sum(mock_time.get_sleep_calls()), 13.0)
+        self.assertTrue(max(mock_time.get_sleep_calls()) <= 0.1)
+
+    def test_connection_fails_fast_on_status(self):
+        """Test a failure reported by wlan.status() ends the wait."""
+        mock_network = MockNetwork(connected=False)
+        mock_network.STAT_CONNECTING = 1001
+        mock_network.STAT_WRONG_PASSWORD = 202
+        mock_time = MockTime()
+
+        mock_wlan = mock_network.WLAN(mock_network.STA_IF)
+        states = [1001, 1001, 202]
+
+        def mock_status():
+            return states.pop(0) if len(states) > 1 else states[0]
+
+        mock_wlan.isconnected = lambda: False
+        mock_wlan.status = mock_status
+
+        result = WifiService.attempt_connecting(
+            "TestSSID",
+            "wrongpass",
+            network_module=mock_network,
+            time_module=mock_time
+        )
+
+        self.assertFalse(result)
+        self.assertEqual(len(mock_time.get_sleep_calls()), 2)
+
+    def test_connect_to_bssid(self):
+        """Test the bssid is passed to wlan.connect() when given."""
+        mock_network = MockNetwork(connected=False)
+        mock_wlan = mock_network.WLAN(mock_network.STA_IF)
+        calls = []
+
+        def mock_connect(ssid, password, bssid=None):
+            calls.append((ssid, bssid))
+            mock_wlan._connected = True
+
+        mock_wlan.connect = mock_connect
+
+        result = WifiService.attempt_connecting(
+            "TestSSID",
+            "testpass",
+            network_module=mock_network,
+            time_module=MockTime(),
+            bssid=b"\x01\x02\x03\x04\x05\x06",
+        )
+
+        self.assertTrue(result)
+        self.assertEqual(calls, [("TestSSID", b"\x01\x02\x03\x04\x05\x06")])
 
     def test_connection_aborted_when_wifi_disabled(self):
         """Test connection aborts if WiFi is disabled during attempt."""
@@ -204,6 +254,95 @@ class TestWifiServiceAttemptConnecting(unittest.TestCase):
         self.assertFalse(result)
 
 
+class TestWifiServiceFastReconnect(unittest.TestCase):
+    """Test rejoining the last access point without a scan."""
+
+    BSSID = b"\xcc\x00\xf1j}\x92"
+
+    def setUp(self):
+        MockSharedPreferences.reset_all()
+        WifiService.access_points = {}
+        WifiService.wifi_busy = False
+
+    def tearDown(self):
+        MockSharedPreferences.reset_all()
+        WifiService.access_points = {}
+
+    def _make_network(self, connect_ok):
+        mock_network = MockNetwork(connected=False)
+        mock_wlan = mock_network.WLAN(mock_network.STA_IF)
+        mock_wlan._scan_results = [(b"Home", self.BSSID, 1, -60, 3, False)]
+        self.scans = [0]
+        self.connects = []
+        scan = mock_wlan.scan
+
+        def mock_scan():
+            self.scans[0] += 1
+            return scan()
+
+        def mock_connect(ssid, password, bssid=None):
+            self.connects.append((ssid, bssid))
+            mock_wlan._connected = connect_ok(bssid)
+
+        mock_wlan.scan = mock_scan
+        mock_wlan.connect = mock_connect
+        return mock_network
+
+    def test_successful_connect_remembers_access_point(self):
+        WifiService.access_points = {"Home": {"password": "pw"}}
+        mock_network = self._make_network(lambda bssid: True)
+
+        self.assertTrue(WifiService.connect(network_module=mock_network, time_module=MockTime()))
+
+        prefs = MockSharedPreferences("com.micropythonos.system.wifiservice")
+        self.assertEqual(prefs.get_string("last_ssid"), "Home")
+        self.assertEqual(prefs.get_dict("access_points")["Home"],
+                         {"password": "pw", "bssid": "cc00f16a7d92"})
+
+    def test_reconnect_skips_scan(self):
+        WifiService.access_points = {"Home": {"password": "pw"}}
+        WifiService.connect(network_module=self._make_network(lambda bssid: True), time_module=MockTime())
+
+        mock_network = self._make_network(lambda bssid: True)
+        mock_time = MockTime()
+        self.assertTrue(WifiService.connect(network_module=mock_network, time_module=mock_time))
+
+        self.assertEqual(self.scans[0], 0)
+        self.assertEqual(self.connects, [("Home", self.BSSID)])
+        self.assertEqual(len(mock_time.get_sleep_calls()), 0)
+
+    def test_failed_fast_path_falls_back_to_scan(self):
+        prefs = MockSharedPreferences("com.micropythonos.system.wifiservice")
+        editor = prefs.edit()
+        editor.put_dict_item("access_points", "Home", {"password": "pw", "bssid": "010203040506"})
+        editor.put_string("last_ssid", "Home")
+        editor.commit()
+        WifiService.access_points = prefs.get_dict("access_points")
+
+        # The remembered AP is gone, the same SSID answers on another BSSID
+        mock_network = self._make_network(lambda bssid: bssid is None)
+        mock_time = MockTime()
+        self.assertTrue(WifiService.connect(network_module=mock_network, time_module=mock_time))
+
+        self.assertEqual(self.scans[0], 1)
+        self.assertEqual(self.connects, [("Home", b"\x01\x02\x03\x04\x05\x06"), ("Home", None)])
+        self.assertAlmostEqual(sum(mock_time.get_sleep_calls()), 6.0)
+        self.assertEqual(prefs.get_dict("access_points")["Home"]["bssid"], "cc00f16a7d92")
+
+    def test_forgotten_network_is_not_fast_pathed(self):
+        prefs = MockSharedPreferences("com.micropythonos.system.wifiservice")
+        editor = prefs.edit()
+        editor.put_string("last_ssid", "Gone")
+        editor.commit()
+        WifiService.access_points = {"Home": {"password": "pw"}}
+
+        mock_network = self._make_network(lambda bssid: True)
+        self.assertTrue(WifiService.connect(network_module=mock_network, time_module=MockTime()))
+
+        self.assertEqual(self.scans[0], 1)
+        self.assertEqual(self.connects, [("Home", None)])
+
+
 class TestWifiServiceAutoConnect(unittest.TestCase):
     """Test WifiService.auto_connect() method."""
 
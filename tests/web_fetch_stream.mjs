@@ -0,0 +1,118 @@
+// Node test for the streaming fetch() body path of the web build's _webnet bridge.
+//
+// Loads the EM_JS function bodies straight from
+// scripts/web_port/ext_mod/_webnet/webnet.c (no wasm build needed) against a
+// plain Uint8Array standing in for HEAPU8, starts a local HTTP server that
+// sends a multi-megabyte body in slow pieces, and asserts that:
+//   1. body_readinto() delivers every byte, in order, into the caller buffer,
+//   2. the JS side never queues much more than the read-ahead limit, and
+//   3. end of body is reported as -1 and free() cancels an unfinished stream.
+//
+// Usage: node tests/web_fetch_stream.mjs
+
+import fs from "node:fs";
+import http from "node:http";
+import path from "node:path";
+import { fileURLToPath } from "node:url";
+
+const here = path.dirname(fileURLToPath(import.meta.url));
+const source = fs.readFileSync(
+  path.join(here, "..", "scripts", "web_port", "ext_mod", "_webnet", "webnet.c"),
+  "utf8",
+);
+
+const BODY_SIZE = 3 * 1024 * 1024;
+const READ_AHEAD = 64 * 1024;
+const BUF = 100; // offset of the "caller buffer" in the fake heap
+const BUF_LEN = 4096;
+
+// Turn `EM_JS(ret, name, (type a, type *b), { ... });` into a JS function.
+function loadEmJs(name) {
+  const re = new RegExp("EM_JS\\([^,]+, " + name + ",\\s*\\(([^)]*)\\),\\s*\\{([\\s\\S]*?)\\n\\}\\);");
+  const m = source.match(re);
+  if (!m) throw new Error("EM_JS " + name + " not found in webnet.c");
+  const params = m[1].split(",").map((p) => p.trim().split(/[\s*]+/).pop());
+  return new Function("Module", "HEAPU8", "UTF8ToString", ...params, m[2]);
+}
+
+const Module = {};
+const HEAPU8 = new Uint8Array(1 << 20);
+const bind = (name) => {
+  const fn = loadEmJs(name);
+  return (...args) => fn(Module, HEAPU8, (s) => s, ...args);
+};
+const start = bind("webnet_js_start");
+const poll = bind("webnet_js_poll");
+const status = bind("webnet_js_status");
+const readinto = bind("webnet_js_body_readinto");
+const free = bind("webnet_js_free");
+
+const body = Buffer.alloc(BODY_SIZE);
+for (let i = 0; i < body.length; i++) body[i] = i & 255;
+
+const server = http.createServer((req, res) => {
+  res.writeHead(200, { "Content-Length": String(body.length) });
+  let off = 0;
+  (function write() {
+    while (off < body.length) {
+      const ok = res.write(body.subarray(off, off + 65536));
+      off += 65536;
+      if (!ok) {
+        res.once("drain", write);
+        return;
+      }
+    }
+    res.end();
+  })();
+});
+
+const sleep = (ms) => new Promise((r) => setTimeout(r, ms));
+
+function fail(msg) {
+  console.error("FAIL: " + msg);
+  process.exit(1);
+}
+
+server.listen(0, "127.0.0.1", async () => {
+  const url = `http://127.0.0.1:${server.address().port}/`;
+  const h = start("GET", url, "{}", 0, 0, READ_AHEAD);
+  while (poll(h) === 0) await sleep(5);
+  if (poll(h) !== 1) fail("fetch did not reach the streaming state");
+  if (status(h) !== 200) fail("unexpected status " + status(h));
+
+  let total = 0;
+  let maxQueued = 0;
+  for (;;) {
+    const n = readinto(h, BUF, BUF_LEN);
+    maxQueued = Math.max(maxQueued, Module.__webnet.map[h].queued);
+    if (n > 0) {
+      for (let i = 0; i < n; i++) {
+        if (HEAPU8[BUF + i] !== ((total + i) & 255)) fail("byte mismatch at " + (total + i));
+      }
+      total += n;
+    } else if (n === -1) {
+      break;
+    } else if (n < -1) {
+      fail("readinto reported an error");
+    } else {
+      await sleep(1);
+    }
+  }
+  free(h);
+  if (total !== BODY_SIZE) fail(`got ${total} bytes, expected ${BODY_SIZE}`);
+  // One network chunk may land on top of a full read-ahead window.
+  if (maxQueued > 2 * READ_AHEAD + 65536) fail("JS queued " + maxQueued + " bytes");
+
+  // Freeing mid-stream must cancel the reader instead of buffering the rest.
+  const h2 = start("GET", url, "{}", 0, 0, READ_AHEAD);
+  while (poll(h2) === 0) await sleep(5);
+  const rec = Module.__webnet.map[h2];
+  free(h2);
+  await sleep(50);
+  if (Module.__webnet.map[h2]) fail("handle not freed");
+  if (rec.queued > 2 * READ_AHEAD + 65536) fail("stream kept buffering after free");
+
+  console.log(`PASS: streamed ${total} bytes, peak JS queue ${maxQueued} bytes`);
+  server.close();
+  process.exit(0);
+});
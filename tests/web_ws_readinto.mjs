@@ -0,0 +1,119 @@
+// Node test for the WebSocket receive path of the web build's _webnet bridge.
+//
+// Loads the EM_JS function bodies straight from
+// scripts/web_port/ext_mod/_webnet/webnet.c (no wasm build needed) against a
+// plain Uint8Array/Int32Array pair standing in for HEAPU8/HEAP32, feeds a fake
+// browser WebSocket, and asserts that:
+//   1. ws_readinto() copies one message into the caller buffer and reports its
+//      type, and leaves a message that does not fit queued,
+//   2. ws_read_batch() packs several messages back to back in one call, stops
+//      at the batch limit or at the first one that does not fit, and
+//   3. text arrives UTF-8 encoded and messages stay in arrival order.
+//
+// Usage: node tests/web_ws_readinto.mjs
+
+import fs from "node:fs";
+import path from "node:path";
+import { fileURLToPath } from "node:url";
+
+const here = path.dirname(fileURLToPath(import.meta.url));
+const source = fs.readFileSync(
+  path.join(here, "..", "scripts", "web_port", "ext_mod", "_webnet", "webnet.c"),
+  "utf8",
+);
+
+// Turn `EM_JS(ret, name, (type a, type *b), { ... });` into a JS function.
+function loadEmJs(name) {
+  const re = new RegExp("EM_JS\\([^,]+, " + name + ",\\s*\\(([^)]*)\\),\\s*\\{([\\s\\S]*?)\\n\\}\\);");
+  const m = source.match(re);
+  if (!m) throw new Error("EM_JS " + name + " not found in webnet.c");
+  const params = m[1].split(",").map((p) => p.trim().split(/[\s*]+/).pop());
+  return new Function("Module", "HEAPU8", "HEAP32", "UTF8ToString", ...params, m[2]);
+}
+
+const Module = {};
+const HEAPU8 = new Uint8Array(1 << 16);
+const HEAP32 = new Int32Array(HEAPU8.buffer);
+const bind = (name) => {
+  const fn = loadEmJs(name);
+  return (...args) => fn(Module, HEAPU8, HEAP32, (s) => s, ...args);
+};
+const open = bind("webnet_js_ws_open");
+const readinto = bind("webnet_js_ws_readinto");
+const readBatch = bind("webnet_js_ws_read_batch");
+
+class FakeWebSocket {
+  constructor(url) {
+    this.url = url;
+    this.readyState = 1;
+    FakeWebSocket.last = this;
+  }
+  close() {
+    this.readyState = 3;
+  }
+}
+globalThis.WebSocket = FakeWebSocket;
+
+const BUF = 1024; // offset of the "caller buffer" in the fake heap
+const META = 64; // offset of the int meta array (16 pairs fit before BUF)
+const BATCH = 16;
+
+function fail(msg) {
+  console.error("FAIL: " + msg);
+  process.exit(1);
+}
+
+function text(off, n) {
+  return new TextDecoder().decode(HEAPU8.subarray(off, off + n));
+}
+
+const h = open("wss://relay.example/", "[]");
+const ws = FakeWebSocket.last;
+const send = (data) => ws.onmessage({ data });
+
+// 1. Single message, type reported, oversized message left queued.
+send("héllo");
+send(new Uint8Array([1, 2, 3]).buffer);
+send("x".repeat(300));
+let n = readinto(h, BUF, 256, META);
+if (HEAP32[META >> 2] !== 1 || n !== 6 || text(BUF, n) !== "héllo") fail("text readinto");
+n = readinto(h, BUF, 256, META);
+if (HEAP32[META >> 2] !== 2 || n !== 3 || HEAPU8[BUF + 2] !== 3) fail("binary readinto");
+n = readinto(h, BUF, 256, META);
+if (HEAP32[META >> 2] !== 1 || n !== -300) fail("oversized message not reported: " + n);
+n = readinto(h, BUF, 512, META);
+if (n !== 300) fail("oversized message was not kept queued");
+n = readinto(h, BUF, 512, META);
+if (n !== 0 || HEAP32[META >> 2] !== 0) fail("empty queue");
+
+// 2. Batch drains up to the limit, packed back to back, in order.
+for (let i = 0; i < BATCH + 4; i++) send("event " + i);
+let count = readBatch(h, BUF, 4096, META, BATCH);
+if (count !== BATCH) fail("batch returned " + count);
+let off = 0;
+for (let i = 0; i < count; i++) {
+  const t = HEAP32[(META >> 2) + 2 * i];
+  const len = HEAP32[(META >> 2) + 2 * i + 1];
+  if (t !== 1 || text(BUF + off, len) !== "event " + i) fail("batch message " + i);
+  off += len;
+}
+count = readBatch(h, BUF, 4096, META, BATCH);
+if (count !== 4) fail("second batch returned " + count);
+
+// 3. Batch stops at the first message that does not fit; a too-large front
+// message is reported as -(length) and stays queued.
+send("a".repeat(100));
+send("b".repeat(100));
+count = readBatch(h, BUF, 150, META, BATCH);
+if (count !== 1 || HEAP32[(META >> 2) + 1] !== 100) fail("partial batch");
+send("c".repeat(1000));
+count = readBatch(h, BUF, 150, META, BATCH);
+if (count !== 1) fail("second partial batch");
+count = readBatch(h, BUF, 150, META, BATCH);
+if (count !== -1000 || HEAP32[META >> 2] !== 1) fail("too-large front message: " + count);
+count = readBatch(h, BUF, 1000, META, BATCH);
+if (count !== 1 || text(BUF, 1) !== "c") fail("too-large message lost");
+if (readBatch(h, BUF, 1000, META, BATCH) !== 0) fail("queue not empty");
+
+console.log("PASS: ws_readinto/ws_read_batch");
+process.exit(0);